@@ -0,0 +1,688 @@
+#include "ccore/c_target.h"
+#include "cbase/c_memory.h"
+
+#include "chash/private/c_hash_cpu.h"
+#include "chash/c_hash.h"
+#include "chash/c_hash_jobs.h"
+#include "chash/private/c_internal_hash.h"
+
+#if defined(CHASH_X64)
+#    include <immintrin.h>
+#endif
+
+namespace ncore
+{
+    //
+    //  URL:
+    //      https://github.com/BLAKE3-team/BLAKE3-specs
+    //
+    //  Description:
+    //      The input is split into 1 KiB chunks that are hashed independently and joined by a
+    //      binary tree of parent nodes. Whole subtrees of the input are hashed several chunks
+    //      at a time by the SSE4.1 (4 chunks) and AVX2 (8 chunks) kernels, with a hash_jobs_t
+    //      the subtrees of large inputs are also split over the workers. Chaining values are
+    //      kept as little-endian bytes, as in the reference implementation.
+    //
+    enum
+    {
+        BLAKE3_BLOCK_LEN   = 64,
+        BLAKE3_CHUNK_LEN   = 1024,
+        BLAKE3_MAX_DEPTH   = 54,
+        BLAKE3_CHUNK_START = 1 << 0,
+        BLAKE3_CHUNK_END   = 1 << 1,
+        BLAKE3_PARENT      = 1 << 2,
+        BLAKE3_ROOT        = 1 << 3,
+        BLAKE3_LEAF_CHUNKS = 16,  // Chunks of a subtree hashed side by side before their parents are joined
+        BLAKE3_JOB_CHUNKS  = 128, // Minimum number of chunks of a single job
+        BLAKE3_JOBS_MAX    = 64,
+    };
+
+    static const u32 s_blake3_iv[8] = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+
+    static const u8 s_blake3_schedule[7][16] = {
+        {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15}, {2, 6, 3, 10, 7, 0, 4, 13, 1, 11, 12, 5, 9, 14, 15, 8}, {3, 4, 10, 12, 13, 2, 7, 14, 6, 5, 9, 0, 11, 15, 8, 1},
+        {10, 7, 12, 9, 14, 3, 13, 15, 4, 0, 11, 2, 5, 8, 1, 6}, {12, 13, 9, 11, 15, 10, 14, 8, 7, 2, 5, 3, 0, 1, 6, 4}, {9, 14, 11, 5, 8, 12, 15, 1, 13, 3, 0, 10, 2, 6, 4, 7},
+        {11, 15, 5, 0, 1, 9, 8, 6, 14, 10, 2, 12, 3, 4, 7, 13},
+    };
+
+    static inline u32 blake3_ror(u32 x, s32 n) { return (x >> n) | (x << (32 - n)); }
+
+    static inline u32 blake3_load32(u8 const* p) { return (u32)p[0] | ((u32)p[1] << 8) | ((u32)p[2] << 16) | ((u32)p[3] << 24); }
+
+    static inline void blake3_store32(u8* p, u32 v)
+    {
+        p[0] = (u8)v;
+        p[1] = (u8)(v >> 8);
+        p[2] = (u8)(v >> 16);
+        p[3] = (u8)(v >> 24);
+    }
+
+    static inline void blake3_g(u32* v, s32 a, s32 b, s32 c, s32 d, u32 x, u32 y)
+    {
+        v[a] = v[a] + v[b] + x;
+        v[d] = blake3_ror(v[d] ^ v[a], 16);
+        v[c] = v[c] + v[d];
+        v[b] = blake3_ror(v[b] ^ v[c], 12);
+        v[a] = v[a] + v[b] + y;
+        v[d] = blake3_ror(v[d] ^ v[a], 8);
+        v[c] = v[c] + v[d];
+        v[b] = blake3_ror(v[b] ^ v[c], 7);
+    }
+
+    // The compression function, only the 8 word chaining value of the output is used
+    static void blake3_compress(u32 const* cv, u8 const* block, u64 counter, u32 block_len, u32 flags, u32* out)
+    {
+        u32 m[16];
+        for (s32 i = 0; i < 16; ++i)
+            m[i] = blake3_load32(block + 4 * i);
+
+        u32 v[16];
+        for (s32 i = 0; i < 8; ++i)
+            v[i] = cv[i];
+        for (s32 i = 0; i < 4; ++i)
+            v[8 + i] = s_blake3_iv[i];
+        v[12] = (u32)counter;
+        v[13] = (u32)(counter >> 32);
+        v[14] = block_len;
+        v[15] = flags;
+
+        for (s32 r = 0; r < 7; ++r)
+        {
+            u8 const* s = s_blake3_schedule[r];
+            blake3_g(v, 0, 4, 8, 12, m[s[0]], m[s[1]]);
+            blake3_g(v, 1, 5, 9, 13, m[s[2]], m[s[3]]);
+            blake3_g(v, 2, 6, 10, 14, m[s[4]], m[s[5]]);
+            blake3_g(v, 3, 7, 11, 15, m[s[6]], m[s[7]]);
+            blake3_g(v, 0, 5, 10, 15, m[s[8]], m[s[9]]);
+            blake3_g(v, 1, 6, 11, 12, m[s[10]], m[s[11]]);
+            blake3_g(v, 2, 7, 8, 13, m[s[12]], m[s[13]]);
+            blake3_g(v, 3, 4, 9, 14, m[s[14]], m[s[15]]);
+        }
+
+        for (s32 i = 0; i < 8; ++i)
+            out[i] = v[i] ^ v[i + 8];
+    }
+
+    // Hash <blocks> consecutive blocks of a single input into a chaining value
+    static void blake3_hash_one(u8 const* input, u32 blocks, u32 const* key, u64 counter, u32 flags, u32 flags_start, u32 flags_end, u8* out)
+    {
+        u32 cv[8];
+        for (s32 i = 0; i < 8; ++i)
+            cv[i] = key[i];
+
+        u32 block_flags = flags | flags_start;
+        for (; blocks > 0; --blocks, input += BLAKE3_BLOCK_LEN)
+        {
+            if (blocks == 1)
+                block_flags |= flags_end;
+            blake3_compress(cv, input, counter, BLAKE3_BLOCK_LEN, block_flags, cv);
+            block_flags = flags;
+        }
+
+        for (s32 i = 0; i < 8; ++i)
+            blake3_store32(out + 4 * i, cv[i]);
+    }
+
+#if defined(CHASH_X64)
+    // The SIMD kernels hash 4 or 8 inputs side by side, one per 32-bit lane. The message words
+    // are transposed on load, state word i of all lanes lives in v[i].
+#    define BLAKE3_G_SIMD(ADD, XOR, ROT16, ROT12, ROT8, ROT7, v, a, b, c, d, x, y) \
+        v[a] = ADD(ADD(v[a], v[b]), x);                                            \
+        v[d] = ROT16(XOR(v[d], v[a]));                                             \
+        v[c] = ADD(v[c], v[d]);                                                    \
+        v[b] = ROT12(XOR(v[b], v[c]));                                             \
+        v[a] = ADD(ADD(v[a], v[b]), y);                                            \
+        v[d] = ROT8(XOR(v[d], v[a]));                                              \
+        v[c] = ADD(v[c], v[d]);                                                    \
+        v[b] = ROT7(XOR(v[b], v[c]))
+
+#    define BLAKE3_ROUND_SIMD(G, v, m, s)               \
+        do                                              \
+        {                                               \
+            G(v, 0, 4, 8, 12, m[s[0]], m[s[1]]);        \
+            G(v, 1, 5, 9, 13, m[s[2]], m[s[3]]);        \
+            G(v, 2, 6, 10, 14, m[s[4]], m[s[5]]);       \
+            G(v, 3, 7, 11, 15, m[s[6]], m[s[7]]);       \
+            G(v, 0, 5, 10, 15, m[s[8]], m[s[9]]);       \
+            G(v, 1, 6, 11, 12, m[s[10]], m[s[11]]);     \
+            G(v, 2, 7, 8, 13, m[s[12]], m[s[13]]);      \
+            G(v, 3, 4, 9, 14, m[s[14]], m[s[15]]);      \
+        } while (0)
+
+    CHASH_TARGET("sse4.1") static inline __m128i blake3_rot16_x4(__m128i x) { return _mm_shuffle_epi8(x, _mm_set_epi8(13, 12, 15, 14, 9, 8, 11, 10, 5, 4, 7, 6, 1, 0, 3, 2)); }
+    CHASH_TARGET("sse4.1") static inline __m128i blake3_rot8_x4(__m128i x) { return _mm_shuffle_epi8(x, _mm_set_epi8(12, 15, 14, 13, 8, 11, 10, 9, 4, 7, 6, 5, 0, 3, 2, 1)); }
+    CHASH_TARGET("sse4.1") static inline __m128i blake3_rot12_x4(__m128i x) { return _mm_or_si128(_mm_srli_epi32(x, 12), _mm_slli_epi32(x, 20)); }
+    CHASH_TARGET("sse4.1") static inline __m128i blake3_rot7_x4(__m128i x) { return _mm_or_si128(_mm_srli_epi32(x, 7), _mm_slli_epi32(x, 25)); }
+
+#    define BLAKE3_G_X4(v, a, b, c, d, x, y) BLAKE3_G_SIMD(_mm_add_epi32, _mm_xor_si128, blake3_rot16_x4, blake3_rot12_x4, blake3_rot8_x4, blake3_rot7_x4, v, a, b, c, d, x, y)
+
+    CHASH_TARGET("sse4.1")
+    static void blake3_hash4_sse41(u8 const* const* inputs, u32 blocks, u32 const* key, u64 counter, bool increment, u32 flags, u32 flags_start, u32 flags_end, u8* out)
+    {
+        __m128i h[8];
+        for (s32 i = 0; i < 8; ++i)
+            h[i] = _mm_set1_epi32((int)key[i]);
+
+        u32 counter_lo[4], counter_hi[4];
+        for (s32 l = 0; l < 4; ++l)
+        {
+            u64 const c   = counter + (increment ? (u64)l : 0);
+            counter_lo[l] = (u32)c;
+            counter_hi[l] = (u32)(c >> 32);
+        }
+
+        u32 block_flags = flags | flags_start;
+        for (u32 b = 0; b < blocks; ++b)
+        {
+            if (b + 1 == blocks)
+                block_flags |= flags_end;
+
+            __m128i m[16];
+            for (s32 q = 0; q < 4; ++q)
+            {
+                __m128i const r0 = _mm_loadu_si128((__m128i const*)(inputs[0] + b * BLAKE3_BLOCK_LEN) + q);
+                __m128i const r1 = _mm_loadu_si128((__m128i const*)(inputs[1] + b * BLAKE3_BLOCK_LEN) + q);
+                __m128i const r2 = _mm_loadu_si128((__m128i const*)(inputs[2] + b * BLAKE3_BLOCK_LEN) + q);
+                __m128i const r3 = _mm_loadu_si128((__m128i const*)(inputs[3] + b * BLAKE3_BLOCK_LEN) + q);
+                __m128i const t0 = _mm_unpacklo_epi32(r0, r1);
+                __m128i const t1 = _mm_unpackhi_epi32(r0, r1);
+                __m128i const t2 = _mm_unpacklo_epi32(r2, r3);
+                __m128i const t3 = _mm_unpackhi_epi32(r2, r3);
+                m[4 * q + 0]     = _mm_unpacklo_epi64(t0, t2);
+                m[4 * q + 1]     = _mm_unpackhi_epi64(t0, t2);
+                m[4 * q + 2]     = _mm_unpacklo_epi64(t1, t3);
+                m[4 * q + 3]     = _mm_unpackhi_epi64(t1, t3);
+            }
+
+            __m128i v[16];
+            for (s32 i = 0; i < 8; ++i)
+                v[i] = h[i];
+            for (s32 i = 0; i < 4; ++i)
+                v[8 + i] = _mm_set1_epi32((int)s_blake3_iv[i]);
+            v[12] = _mm_loadu_si128((__m128i const*)counter_lo);
+            v[13] = _mm_loadu_si128((__m128i const*)counter_hi);
+            v[14] = _mm_set1_epi32(BLAKE3_BLOCK_LEN);
+            v[15] = _mm_set1_epi32((int)block_flags);
+
+            BLAKE3_ROUND_SIMD(BLAKE3_G_X4, v, m, s_blake3_schedule[0]);
+            BLAKE3_ROUND_SIMD(BLAKE3_G_X4, v, m, s_blake3_schedule[1]);
+            BLAKE3_ROUND_SIMD(BLAKE3_G_X4, v, m, s_blake3_schedule[2]);
+            BLAKE3_ROUND_SIMD(BLAKE3_G_X4, v, m, s_blake3_schedule[3]);
+            BLAKE3_ROUND_SIMD(BLAKE3_G_X4, v, m, s_blake3_schedule[4]);
+            BLAKE3_ROUND_SIMD(BLAKE3_G_X4, v, m, s_blake3_schedule[5]);
+            BLAKE3_ROUND_SIMD(BLAKE3_G_X4, v, m, s_blake3_schedule[6]);
+
+            for (s32 i = 0; i < 8; ++i)
+                h[i] = _mm_xor_si128(v[i], v[i + 8]);
+            block_flags = flags;
+        }
+
+        u32 words[8][4];
+        for (s32 i = 0; i < 8; ++i)
+            _mm_storeu_si128((__m128i*)words[i], h[i]);
+        for (s32 l = 0; l < 4; ++l)
+            for (s32 i = 0; i < 8; ++i)
+                blake3_store32(out + 32 * l + 4 * i, words[i][l]);
+    }
+
+    CHASH_TARGET("avx2") static inline __m256i blake3_rot16_x8(__m256i x) { return _mm256_shuffle_epi8(x, _mm256_set_epi8(13, 12, 15, 14, 9, 8, 11, 10, 5, 4, 7, 6, 1, 0, 3, 2, 13, 12, 15, 14, 9, 8, 11, 10, 5, 4, 7, 6, 1, 0, 3, 2)); }
+    CHASH_TARGET("avx2") static inline __m256i blake3_rot8_x8(__m256i x) { return _mm256_shuffle_epi8(x, _mm256_set_epi8(12, 15, 14, 13, 8, 11, 10, 9, 4, 7, 6, 5, 0, 3, 2, 1, 12, 15, 14, 13, 8, 11, 10, 9, 4, 7, 6, 5, 0, 3, 2, 1)); }
+    CHASH_TARGET("avx2") static inline __m256i blake3_rot12_x8(__m256i x) { return _mm256_or_si256(_mm256_srli_epi32(x, 12), _mm256_slli_epi32(x, 20)); }
+    CHASH_TARGET("avx2") static inline __m256i blake3_rot7_x8(__m256i x) { return _mm256_or_si256(_mm256_srli_epi32(x, 7), _mm256_slli_epi32(x, 25)); }
+
+#    define BLAKE3_G_X8(v, a, b, c, d, x, y) BLAKE3_G_SIMD(_mm256_add_epi32, _mm256_xor_si256, blake3_rot16_x8, blake3_rot12_x8, blake3_rot8_x8, blake3_rot7_x8, v, a, b, c, d, x, y)
+
+    CHASH_TARGET("avx2")
+    static void blake3_hash8_avx2(u8 const* const* inputs, u32 blocks, u32 const* key, u64 counter, bool increment, u32 flags, u32 flags_start, u32 flags_end, u8* out)
+    {
+        __m256i h[8];
+        for (s32 i = 0; i < 8; ++i)
+            h[i] = _mm256_set1_epi32((int)key[i]);
+
+        u32 counter_lo[8], counter_hi[8];
+        for (s32 l = 0; l < 8; ++l)
+        {
+            u64 const c   = counter + (increment ? (u64)l : 0);
+            counter_lo[l] = (u32)c;
+            counter_hi[l] = (u32)(c >> 32);
+        }
+
+        u32 block_flags = flags | flags_start;
+        for (u32 b = 0; b < blocks; ++b)
+        {
+            if (b + 1 == blocks)
+                block_flags |= flags_end;
+
+            __m256i m[16];
+            for (s32 half = 0; half < 2; ++half)
+            {
+                __m256i r[8];
+                for (s32 l = 0; l < 8; ++l)
+                    r[l] = _mm256_loadu_si256((__m256i const*)(inputs[l] + b * BLAKE3_BLOCK_LEN) + half);
+
+                __m256i const t0 = _mm256_unpacklo_epi32(r[0], r[1]);
+                __m256i const t1 = _mm256_unpackhi_epi32(r[0], r[1]);
+                __m256i const t2 = _mm256_unpacklo_epi32(r[2], r[3]);
+                __m256i const t3 = _mm256_unpackhi_epi32(r[2], r[3]);
+                __m256i const t4 = _mm256_unpacklo_epi32(r[4], r[5]);
+                __m256i const t5 = _mm256_unpackhi_epi32(r[4], r[5]);
+                __m256i const t6 = _mm256_unpacklo_epi32(r[6], r[7]);
+                __m256i const t7 = _mm256_unpackhi_epi32(r[6], r[7]);
+
+                __m256i const u0 = _mm256_unpacklo_epi64(t0, t2);
+                __m256i const u1 = _mm256_unpackhi_epi64(t0, t2);
+                __m256i const u2 = _mm256_unpacklo_epi64(t1, t3);
+                __m256i const u3 = _mm256_unpackhi_epi64(t1, t3);
+                __m256i const u4 = _mm256_unpacklo_epi64(t4, t6);
+                __m256i const u5 = _mm256_unpackhi_epi64(t4, t6);
+                __m256i const u6 = _mm256_unpacklo_epi64(t5, t7);
+                __m256i const u7 = _mm256_unpackhi_epi64(t5, t7);
+
+                m[8 * half + 0] = _mm256_permute2x128_si256(u0, u4, 0x20);
+                m[8 * half + 1] = _mm256_permute2x128_si256(u1, u5, 0x20);
+                m[8 * half + 2] = _mm256_permute2x128_si256(u2, u6, 0x20);
+                m[8 * half + 3] = _mm256_permute2x128_si256(u3, u7, 0x20);
+                m[8 * half + 4] = _mm256_permute2x128_si256(u0, u4, 0x31);
+                m[8 * half + 5] = _mm256_permute2x128_si256(u1, u5, 0x31);
+                m[8 * half + 6] = _mm256_permute2x128_si256(u2, u6, 0x31);
+                m[8 * half + 7] = _mm256_permute2x128_si256(u3, u7, 0x31);
+            }
+
+            __m256i v[16];
+            for (s32 i = 0; i < 8; ++i)
+                v[i] = h[i];
+            for (s32 i = 0; i < 4; ++i)
+                v[8 + i] = _mm256_set1_epi32((int)s_blake3_iv[i]);
+            v[12] = _mm256_loadu_si256((__m256i const*)counter_lo);
+            v[13] = _mm256_loadu_si256((__m256i const*)counter_hi);
+            v[14] = _mm256_set1_epi32(BLAKE3_BLOCK_LEN);
+            v[15] = _mm256_set1_epi32((int)block_flags);
+
+            BLAKE3_ROUND_SIMD(BLAKE3_G_X8, v, m, s_blake3_schedule[0]);
+            BLAKE3_ROUND_SIMD(BLAKE3_G_X8, v, m, s_blake3_schedule[1]);
+            BLAKE3_ROUND_SIMD(BLAKE3_G_X8, v, m, s_blake3_schedule[2]);
+            BLAKE3_ROUND_SIMD(BLAKE3_G_X8, v, m, s_blake3_schedule[3]);
+            BLAKE3_ROUND_SIMD(BLAKE3_G_X8, v, m, s_blake3_schedule[4]);
+            BLAKE3_ROUND_SIMD(BLAKE3_G_X8, v, m, s_blake3_schedule[5]);
+            BLAKE3_ROUND_SIMD(BLAKE3_G_X8, v, m, s_blake3_schedule[6]);
+
+            for (s32 i = 0; i < 8; ++i)
+                h[i] = _mm256_xor_si256(v[i], v[i + 8]);
+            block_flags = flags;
+        }
+
+        u32 words[8][8];
+        for (s32 i = 0; i < 8; ++i)
+            _mm256_storeu_si256((__m256i*)words[i], h[i]);
+        for (s32 l = 0; l < 8; ++l)
+            for (s32 i = 0; i < 8; ++i)
+                blake3_store32(out + 32 * l + 4 * i, words[i][l]);
+    }
+
+#    undef BLAKE3_G_X8
+#    undef BLAKE3_G_X4
+#    undef BLAKE3_ROUND_SIMD
+#    undef BLAKE3_G_SIMD
+#endif
+
+    // Hash <count> inputs of <blocks> blocks each into count chaining values at <out>. With <increment>
+    // input i uses counter + i (chunks), otherwise they all use <counter> (parent nodes). The output
+    // may overlap the inputs as long as out[i] does not overlap inputs[j] for j > i.
+    static void blake3_hash_many(u8 const* const* inputs, u32 count, u32 blocks, u32 const* key, u64 counter, bool increment, u32 flags, u32 flags_start, u32 flags_end, u8* out)
+    {
+#if defined(CHASH_X64)
+        if (nhash_cpu::has(nhash_cpu::AVX2))
+        {
+            for (; count >= 8; count -= 8, inputs += 8, out += 8 * 32)
+            {
+                blake3_hash8_avx2(inputs, blocks, key, counter, increment, flags, flags_start, flags_end, out);
+                counter += increment ? 8 : 0;
+            }
+        }
+        if (nhash_cpu::has(nhash_cpu::SSE41 | nhash_cpu::SSSE3))
+        {
+            for (; count >= 4; count -= 4, inputs += 4, out += 4 * 32)
+            {
+                blake3_hash4_sse41(inputs, blocks, key, counter, increment, flags, flags_start, flags_end, out);
+                counter += increment ? 4 : 0;
+            }
+        }
+#endif
+        for (; count > 0; --count, ++inputs, out += 32)
+        {
+            blake3_hash_one(*inputs, blocks, key, counter, flags, flags_start, flags_end, out);
+            counter += increment ? 1 : 0;
+        }
+    }
+
+    // Join <count> (at most BLAKE3_JOBS_MAX / 2) pairs of chaining values at <cvs> into <count> parent
+    // chaining values, in place
+    static void blake3_parents(u8* cvs, u32 count, u32 const* key, u32 flags)
+    {
+        u8 const* inputs[BLAKE3_JOBS_MAX / 2];
+        for (u32 i = 0; i < count; ++i)
+            inputs[i] = cvs + 64 * i;
+        blake3_hash_many(inputs, count, 1, key, 0, false, flags | BLAKE3_PARENT, 0, 0, cvs);
+    }
+
+    // Chaining value of a subtree of <nchunks> (a power of 2) whole chunks starting at chunk <counter>
+    static void blake3_subtree(u8 const* input, u64 nchunks, u64 counter, u32 const* key, u32 flags, u8* cv)
+    {
+        if (nchunks <= BLAKE3_LEAF_CHUNKS)
+        {
+            u8 const* inputs[BLAKE3_LEAF_CHUNKS] = {nullptr};
+            u8        cvs[BLAKE3_LEAF_CHUNKS * 32];
+            for (u32 i = 0; i < (u32)nchunks; ++i)
+                inputs[i] = input + (u64)i * BLAKE3_CHUNK_LEN;
+            blake3_hash_many(inputs, (u32)nchunks, BLAKE3_CHUNK_LEN / BLAKE3_BLOCK_LEN, key, counter, true, flags, BLAKE3_CHUNK_START, BLAKE3_CHUNK_END, cvs);
+            for (u32 n = (u32)nchunks; n > 1; n /= 2)
+                blake3_parents(cvs, n / 2, key, flags);
+            nmem::memcpy(cv, cvs, 32);
+            return;
+        }
+
+        u8        children[64];
+        u64 const half = nchunks / 2;
+        blake3_subtree(input, half, counter, key, flags, children);
+        blake3_subtree(input + half * BLAKE3_CHUNK_LEN, half, counter + half, key, flags, children + 32);
+        blake3_parents(children, 1, key, flags);
+        nmem::memcpy(cv, children, 32);
+    }
+
+    // The pieces of a subtree hashed as jobs
+    struct blake3_jobs_t
+    {
+        u8 const*  m_input;
+        u64        m_piece_chunks;
+        u64        m_counter;
+        u32 const* m_key;
+        u32        m_flags;
+        u8         m_cvs[BLAKE3_JOBS_MAX * 32];
+
+        static void job(void* user, s32 index)
+        {
+            blake3_jobs_t* ctx = (blake3_jobs_t*)user;
+            u64 const      pos = (u64)index * ctx->m_piece_chunks;
+            blake3_subtree(ctx->m_input + pos * BLAKE3_CHUNK_LEN, ctx->m_piece_chunks, ctx->m_counter + pos, ctx->m_key, ctx->m_flags, ctx->m_cvs + 32 * index);
+        }
+    };
+
+    // The chaining values of the two children of a subtree of <nchunks> (a power of 2, at least 2)
+    // whole chunks, with <jobs> large subtrees are split into pieces that are hashed concurrently
+    static void blake3_subtree_children(u8 const* input, u64 nchunks, u64 counter, u32 const* key, u32 flags, hash_jobs_t* jobs, u8* children)
+    {
+        if (jobs == nullptr || jobs->workers() <= 1 || nchunks / 2 < BLAKE3_JOB_CHUNKS)
+        {
+            u64 const half = nchunks / 2;
+            blake3_subtree(input, half, counter, key, flags, children);
+            blake3_subtree(input + half * BLAKE3_CHUNK_LEN, half, counter + half, key, flags, children + 32);
+            return;
+        }
+
+        u64 const limit  = (u64)jobs->workers() * 4 < (u64)BLAKE3_JOBS_MAX ? (u64)jobs->workers() * 4 : (u64)BLAKE3_JOBS_MAX;
+        u64       pieces = 2;
+        while (pieces * 2 <= limit && nchunks / (pieces * 2) >= BLAKE3_JOB_CHUNKS)
+            pieces *= 2;
+
+        blake3_jobs_t ctx;
+        ctx.m_input        = input;
+        ctx.m_piece_chunks = nchunks / pieces;
+        ctx.m_counter      = counter;
+        ctx.m_key          = key;
+        ctx.m_flags        = flags;
+        jobs->run(&blake3_jobs_t::job, &ctx, (s32)pieces);
+
+        for (u64 n = pieces; n > 2; n /= 2)
+            blake3_parents(ctx.m_cvs, (u32)(n / 2), key, flags);
+        nmem::memcpy(children, ctx.m_cvs, 64);
+    }
+
+    static inline u32 blake3_popcount(u64 x)
+    {
+        u32 n = 0;
+        for (; x != 0; x &= x - 1)
+            n++;
+        return n;
+    }
+
+    struct blake3_ctxt_t
+    {
+        u32 m_key[8];
+        u32 m_cv[8];               // Chaining value of the current chunk
+        u64 m_chunk_counter;       // Index of the current chunk
+        u8  m_buf[BLAKE3_BLOCK_LEN];
+        u32 m_buf_len;
+        u32 m_blocks_compressed;   // Blocks of the current chunk compressed so far
+        u32 m_flags;
+        u32 m_stack_len;
+        u8  m_stack[(BLAKE3_MAX_DEPTH + 1) * 32];
+
+        void reset()
+        {
+            for (s32 i = 0; i < 8; ++i)
+                m_key[i] = s_blake3_iv[i];
+            m_flags     = 0;
+            m_stack_len = 0;
+            chunk_reset(0);
+        }
+
+        void chunk_reset(u64 counter)
+        {
+            for (s32 i = 0; i < 8; ++i)
+                m_cv[i] = m_key[i];
+            m_chunk_counter     = counter;
+            m_buf_len           = 0;
+            m_blocks_compressed = 0;
+            nmem::memclr(m_buf, sizeof(m_buf));
+        }
+
+        u32 chunk_len() const { return m_blocks_compressed * BLAKE3_BLOCK_LEN + m_buf_len; }
+        u32 chunk_start_flag() const { return m_blocks_compressed == 0 ? BLAKE3_CHUNK_START : 0; }
+
+        // The last block of a chunk is only compressed once it is known that no more input follows
+        void chunk_update(u8 const* p, u64 len)
+        {
+            if (m_buf_len > 0)
+            {
+                u32 const take = (len < (u64)(BLAKE3_BLOCK_LEN - m_buf_len)) ? (u32)len : (u32)(BLAKE3_BLOCK_LEN - m_buf_len);
+                nmem::memcpy(m_buf + m_buf_len, p, take);
+                m_buf_len += take;
+                p += take;
+                len -= take;
+                if (len == 0)
+                    return;
+                blake3_compress(m_cv, m_buf, m_chunk_counter, BLAKE3_BLOCK_LEN, m_flags | chunk_start_flag(), m_cv);
+                m_blocks_compressed++;
+                m_buf_len = 0;
+                nmem::memclr(m_buf, sizeof(m_buf));
+            }
+
+            for (; len > BLAKE3_BLOCK_LEN; p += BLAKE3_BLOCK_LEN, len -= BLAKE3_BLOCK_LEN)
+            {
+                blake3_compress(m_cv, p, m_chunk_counter, BLAKE3_BLOCK_LEN, m_flags | chunk_start_flag(), m_cv);
+                m_blocks_compressed++;
+            }
+
+            nmem::memcpy(m_buf, p, (u32)len);
+            m_buf_len = (u32)len;
+        }
+
+        // Chaining values are joined lazily, only when it is known that more input follows, so
+        // the root node is never compressed as a parent. After this the stack holds one entry per
+        // 1 bit of <total_chunks>.
+        void merge_stack(u64 total_chunks)
+        {
+            u32 const post_merge = blake3_popcount(total_chunks);
+            while (m_stack_len > post_merge)
+            {
+                blake3_parents(m_stack + (m_stack_len - 2) * 32, 1, m_key, m_flags);
+                m_stack_len--;
+            }
+        }
+
+        void push_cv(u8 const* cv, u64 chunk_counter)
+        {
+            merge_stack(chunk_counter);
+            nmem::memcpy(m_stack + m_stack_len * 32, cv, 32);
+            m_stack_len++;
+        }
+
+        void update(u8 const* p, u64 len, hash_jobs_t* jobs)
+        {
+            if (chunk_len() > 0)
+            {
+                u64 const take = (len < (u64)(BLAKE3_CHUNK_LEN - chunk_len())) ? len : (u64)(BLAKE3_CHUNK_LEN - chunk_len());
+                chunk_update(p, take);
+                p += take;
+                len -= take;
+                if (len == 0)
+                    return;
+
+                u8 cv[32];
+                chunk_cv(cv);
+                push_cv(cv, m_chunk_counter);
+                chunk_reset(m_chunk_counter + 1);
+            }
+
+            // Whole subtrees, the largest power of 2 of chunks that the input covers and the
+            // position in the tree allows. At least one byte is left for the chunk state.
+            while (len > BLAKE3_CHUNK_LEN)
+            {
+                u64 subtree_len = (u64)1 << 63;
+                while (subtree_len > len)
+                    subtree_len >>= 1;
+                u64 const count_so_far = m_chunk_counter * BLAKE3_CHUNK_LEN;
+                while (((subtree_len - 1) & count_so_far) != 0)
+                    subtree_len >>= 1;
+
+                u64 const subtree_chunks = subtree_len / BLAKE3_CHUNK_LEN;
+                if (subtree_chunks == 1)
+                {
+                    u8 cv[32];
+                    blake3_hash_one(p, BLAKE3_CHUNK_LEN / BLAKE3_BLOCK_LEN, m_key, m_chunk_counter, m_flags, BLAKE3_CHUNK_START, BLAKE3_CHUNK_END, cv);
+                    push_cv(cv, m_chunk_counter);
+                }
+                else
+                {
+                    // Pushing both children keeps the lazy merging intact when this subtree turns out to be the root
+                    u8 children[64];
+                    blake3_subtree_children(p, subtree_chunks, m_chunk_counter, m_key, m_flags, jobs, children);
+                    push_cv(children, m_chunk_counter);
+                    push_cv(children + 32, m_chunk_counter + subtree_chunks / 2);
+                }
+                m_chunk_counter += subtree_chunks;
+                p += subtree_len;
+                len -= subtree_len;
+            }
+
+            if (len > 0)
+            {
+                chunk_update(p, len);
+                merge_stack(m_chunk_counter);
+            }
+        }
+
+        void chunk_cv(u8* cv) const
+        {
+            u32 out[8];
+            blake3_compress(m_cv, m_buf, m_chunk_counter, m_buf_len, m_flags | chunk_start_flag() | BLAKE3_CHUNK_END, out);
+            for (s32 i = 0; i < 8; ++i)
+                blake3_store32(cv + 4 * i, out[i]);
+        }
+
+        // Does not change the state, more input can follow
+        void digest(u8* hash) const
+        {
+            // The root is the node that is compressed last, first join the current chunk (or the
+            // two CVs on top of the stack when the chunk is empty) with the rest of the stack
+            u32 const* cv;
+            u8 const*  block;
+            u64        counter;
+            u32        block_len;
+            u32        flags;
+
+            u8  parent[64];
+            u32 key_cv[8];
+            s32 remaining;
+            if (m_stack_len == 0 || chunk_len() > 0)
+            {
+                cv        = m_cv;
+                block     = m_buf;
+                counter   = m_chunk_counter;
+                block_len = m_buf_len;
+                flags     = m_flags | chunk_start_flag() | BLAKE3_CHUNK_END;
+                remaining = (s32)m_stack_len;
+            }
+            else
+            {
+                remaining = (s32)m_stack_len - 2;
+                nmem::memcpy(parent, m_stack + remaining * 32, 64);
+                cv        = m_key;
+                block     = parent;
+                counter   = 0;
+                block_len = BLAKE3_BLOCK_LEN;
+                flags     = m_flags | BLAKE3_PARENT;
+            }
+
+            while (remaining > 0)
+            {
+                remaining--;
+                u32 out[8];
+                blake3_compress(cv, block, counter, block_len, flags, out);
+                nmem::memcpy(parent, m_stack + remaining * 32, 32);
+                for (s32 i = 0; i < 8; ++i)
+                    blake3_store32(parent + 32 + 4 * i, out[i]);
+                for (s32 i = 0; i < 8; ++i)
+                    key_cv[i] = m_key[i];
+                cv        = key_cv;
+                block     = parent;
+                counter   = 0;
+                block_len = BLAKE3_BLOCK_LEN;
+                flags     = m_flags | BLAKE3_PARENT;
+            }
+
+            u32 out[8];
+            blake3_compress(cv, block, 0, block_len, flags | BLAKE3_ROOT, out);
+            for (s32 i = 0; i < 8; ++i)
+                blake3_store32(hash + 4 * i, out[i]);
+        }
+    };
+
+    namespace nhash_private
+    {
+        static_assert(sizeof(blake3_ctxt_t) <= sizeof(blake3_t::m_ctxt), "blake3_t context too small");
+
+        void blake3_t::reset(u64 seed)
+        {
+            blake3_ctxt_t* ctx = (blake3_ctxt_t*)&this->m_ctxt;
+            ctx->reset();
+        }
+
+        void blake3_t::hash(const u8* begin, const u8* end)
+        {
+            blake3_ctxt_t* ctx = (blake3_ctxt_t*)&this->m_ctxt;
+            ctx->update(begin, (u64)(end - begin), m_jobs);
+        }
+
+        void blake3_t::end(u8* _hash)
+        {
+            blake3_ctxt_t* ctx = (blake3_ctxt_t*)&this->m_ctxt;
+            ctx->digest(_hash);
+        }
+    } // namespace nhash_private
+
+    namespace nhash
+    {
+        blake3 hash_blake3(u8 const* data, u64 len, hash_jobs_t* jobs)
+        {
+            blake3_ctxt_t ctx;
+            ctx.reset();
+            ctx.update(data, len, jobs);
+
+            blake3 digest;
+            ctx.digest(digest.m_data);
+            return digest;
+        }
+    } // namespace nhash
+
+} // namespace ncore
@@ -1,28 +1,222 @@
 #include "ccore/c_target.h"
 #include "ccore/c_debug.h"
 #include "chash/c_crc.h"
+#include "chash/c_crc_engine.h"
+#include "chash/c_hash.h"
+#include "chash/c_hash_jobs.h"
+#include "chash/private/c_internal_hash.h"
+#include "chash/private/c_hash_cpu.h"
+
+#if defined(CHASH_X64)
+#	include <nmmintrin.h>
+#	include <wmmintrin.h>
+#	include <immintrin.h>
+#endif
 
 namespace ncore
 {
+	// Multiply a(x) by b(x) modulo p(x), all polynomials are bit-reflected (x^0 is the top bit)
+	static constexpr u32	sMultModP(u32 inA, u32 inB, u32 inPoly)
+	{
+		u32 m = (u32)1 << 31;
+		u32 p = 0;
+		for (;;)
+		{
+			if (inA & m)
+			{
+				p ^= inB;
+				if ((inA & (m - 1)) == 0)
+					break;
+			}
+			m >>= 1;
+			inB = (inB & 1) ? ((inB >> 1) ^ inPoly) : (inB >> 1);
+		}
+		return p;
+	}
+
+	// x^(2^n) modulo p(x), for n = 0..31
+	struct x2n_t
+	{
+		u32				m[32];
+		constexpr u32	operator[](u32 n) const										{ return m[n]; }
+	};
+
+	static constexpr x2n_t	sX2NInit(u32 inPoly)
+	{
+		x2n_t x2n = {};
+		u32 p = (u32)1 << 30;													// x^1
+		x2n.m[0] = p;
+		for (s32 n = 1; n < 32; n++)
+			x2n.m[n] = p = sMultModP(p, p, inPoly);
+		return x2n;
+	}
+
+	// Return x^(n * 2^k) modulo p(x), in O(log n) multiplications
+	static constexpr u32	sX2NModP(x2n_t const& inX2N, u64 inN, u32 inK, u32 inPoly)
+	{
+		u32 p = (u32)1 << 31;													// x^0 == 1
+		while (inN)
+		{
+			if (inN & 1)
+				p = sMultModP(inX2N[inK & 31], p, inPoly);
+			inN >>= 1;
+			inK++;
+		}
+		return p;
+	}
+
 	class CRC32
 	{
 	public:
 		enum EConstants
 		{
 			POLY32		= 0xedb88320,
-			TABLE_SIZE	= 256
+			TABLE_SIZE	= 256,
+			SLICES		= 16,															///< Number of tables, slice k holds the CRC of byte n followed by k zero bytes
+			CLMUL_MIN_SIZE	= 512														///< Buffers smaller than this stay on the table path
 		};
 
-		static bool		mIsEmpty;
-		static u32		mTable[TABLE_SIZE];
+		typedef ncrc::table_t<u32, SLICES>	table_t;
+
+		static constexpr table_t	mTable = ncrc::make_table<u32, 32, true, SLICES>(ncrc::reflect(POLY32, 32));
+		static constexpr x2n_t		mX2N   = sX2NInit(POLY32);						///< x^(2^n) mod P, for combining CRCs
 
-		static void		CDO1(u8 const*& ioDataPtr, u32& ioCRC)						{ ioCRC = mTable[(ioCRC ^ (*ioDataPtr++)) & 0xff] ^ (ioCRC >> 8); }
-		static void		CDO4(u8 const*& ioDataPtr, u32& ioCRC)						{ CDO1(ioDataPtr, ioCRC); CDO1(ioDataPtr, ioCRC); CDO1(ioDataPtr, ioCRC); CDO1(ioDataPtr, ioCRC); }
-		static void		CDO16(u8 const*& ioDataPtr, u32& ioCRC)						{ CDO4(ioDataPtr, ioCRC); CDO4(ioDataPtr, ioCRC); CDO4(ioDataPtr, ioCRC); CDO4(ioDataPtr, ioCRC); }
+		static u32		LoadLE32(u8 const* inDataPtr)
+		{
+#ifdef D_LITTLE_ENDIAN
+			return *(u32 const*)inDataPtr;
+#else
+			return (u32)inDataPtr[0] | ((u32)inDataPtr[1] << 8) | ((u32)inDataPtr[2] << 16) | ((u32)inDataPtr[3] << 24);
+#endif
+		}
+
+		static void		CDO1(u8 const*& ioDataPtr, u32& ioCRC)						{ ioCRC = mTable[0][(ioCRC ^ (*ioDataPtr++)) & 0xff] ^ (ioCRC >> 8); }
+
+		// Slicing-by-8, consumes 8 bytes with 8 independent table lookups
+		static void		CDO8(u8 const*& ioDataPtr, u32& ioCRC)
+		{
+			u32 const one = LoadLE32(ioDataPtr) ^ ioCRC;
+			u32 const two = LoadLE32(ioDataPtr + 4);
+			ioCRC = mTable[7][one & 0xff] ^ mTable[6][(one >> 8) & 0xff] ^ mTable[5][(one >> 16) & 0xff] ^ mTable[4][one >> 24]
+			      ^ mTable[3][two & 0xff] ^ mTable[2][(two >> 8) & 0xff] ^ mTable[1][(two >> 16) & 0xff] ^ mTable[0][two >> 24];
+			ioDataPtr += 8;
+		}
+
+		// Slicing-by-16, consumes 16 bytes with 16 independent table lookups
+		static void		CDO16(u8 const*& ioDataPtr, u32& ioCRC)
+		{
+			u32 const one   = LoadLE32(ioDataPtr) ^ ioCRC;
+			u32 const two   = LoadLE32(ioDataPtr + 4);
+			u32 const three = LoadLE32(ioDataPtr + 8);
+			u32 const four  = LoadLE32(ioDataPtr + 12);
+			ioCRC = mTable[15][one & 0xff] ^ mTable[14][(one >> 8) & 0xff] ^ mTable[13][(one >> 16) & 0xff] ^ mTable[12][one >> 24]
+			      ^ mTable[11][two & 0xff] ^ mTable[10][(two >> 8) & 0xff] ^ mTable[9][(two >> 16) & 0xff] ^ mTable[8][two >> 24]
+			      ^ mTable[7][three & 0xff] ^ mTable[6][(three >> 8) & 0xff] ^ mTable[5][(three >> 16) & 0xff] ^ mTable[4][three >> 24]
+			      ^ mTable[3][four & 0xff] ^ mTable[2][(four >> 8) & 0xff] ^ mTable[1][(four >> 16) & 0xff] ^ mTable[0][four >> 24];
+			ioDataPtr += 16;
+		}
 	};
 
-	bool		CRC32::mIsEmpty = true;
-	u32			CRC32::mTable[256];
+	constexpr CRC32::table_t	CRC32::mTable;
+	constexpr x2n_t				CRC32::mX2N;
+
+#if defined(CHASH_X64)
+	/**
+	 * CRC32 by folding with carry-less multiplication (PCLMULQDQ), see Intel's white paper "Fast CRC
+	 * Computation for Generic Polynomials Using PCLMULQDQ Instruction". Four 128-bit lanes are folded
+	 * 64 bytes at a time, then folded down to 128 bits, to 64 bits and reduced to 32 bits with a Barrett
+	 * reduction. <len> must be at least 64 and a multiple of 16.
+	 */
+	CHASH_TARGET("sse4.1,pclmul")
+	static u32		sCRC32_CLMUL(u8 const* p_in, u64 len, u32 crc)
+	{
+		// x^(4*128+32) mod P, x^(4*128-32) mod P, bit-reflected and shifted left by 1
+		static const u64 k1k2[2] = { 0x0154442bd4, 0x01c6e41596 };
+		// x^(128+32) mod P, x^(128-32) mod P
+		static const u64 k3k4[2] = { 0x01751997d0, 0x00ccaa009e };
+		// x^64 mod P
+		static const u64 k5k0[2] = { 0x0163cd6124, 0x0000000000 };
+		// P and the Barrett constant floor(x^64 / P)
+		static const u64 poly[2] = { 0x01db710641, 0x01f7011641 };
+
+		__m128i x0, x1, x2, x3, x4, x5, x6, x7, x8, y5, y6, y7, y8;
+
+		x1 = _mm_loadu_si128((__m128i const*)(p_in + 0x00));
+		x2 = _mm_loadu_si128((__m128i const*)(p_in + 0x10));
+		x3 = _mm_loadu_si128((__m128i const*)(p_in + 0x20));
+		x4 = _mm_loadu_si128((__m128i const*)(p_in + 0x30));
+		x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128((int)crc));
+		x0 = _mm_loadu_si128((__m128i const*)k1k2);
+		p_in += 64;
+		len -= 64;
+
+		// Fold 4 x 128 bits in parallel
+		while (len >= 64)
+		{
+			x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+			x6 = _mm_clmulepi64_si128(x2, x0, 0x00);
+			x7 = _mm_clmulepi64_si128(x3, x0, 0x00);
+			x8 = _mm_clmulepi64_si128(x4, x0, 0x00);
+			x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+			x2 = _mm_clmulepi64_si128(x2, x0, 0x11);
+			x3 = _mm_clmulepi64_si128(x3, x0, 0x11);
+			x4 = _mm_clmulepi64_si128(x4, x0, 0x11);
+			y5 = _mm_loadu_si128((__m128i const*)(p_in + 0x00));
+			y6 = _mm_loadu_si128((__m128i const*)(p_in + 0x10));
+			y7 = _mm_loadu_si128((__m128i const*)(p_in + 0x20));
+			y8 = _mm_loadu_si128((__m128i const*)(p_in + 0x30));
+			x1 = _mm_xor_si128(_mm_xor_si128(x1, x5), y5);
+			x2 = _mm_xor_si128(_mm_xor_si128(x2, x6), y6);
+			x3 = _mm_xor_si128(_mm_xor_si128(x3, x7), y7);
+			x4 = _mm_xor_si128(_mm_xor_si128(x4, x8), y8);
+			p_in += 64;
+			len -= 64;
+		}
+
+		// Fold into 128 bits
+		x0 = _mm_loadu_si128((__m128i const*)k3k4);
+		x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+		x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+		x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+		x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+		x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+		x1 = _mm_xor_si128(_mm_xor_si128(x1, x3), x5);
+		x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+		x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+		x1 = _mm_xor_si128(_mm_xor_si128(x1, x4), x5);
+
+		// Single fold blocks of 128 bits
+		while (len >= 16)
+		{
+			x2 = _mm_loadu_si128((__m128i const*)p_in);
+			x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+			x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+			x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+			p_in += 16;
+			len -= 16;
+		}
+
+		// Fold 128 bits to 64 bits
+		x2 = _mm_clmulepi64_si128(x1, x0, 0x10);
+		x3 = _mm_setr_epi32(~0, 0, ~0, 0);
+		x1 = _mm_srli_si128(x1, 8);
+		x1 = _mm_xor_si128(x1, x2);
+		x0 = _mm_loadl_epi64((__m128i const*)k5k0);
+		x2 = _mm_srli_si128(x1, 4);
+		x1 = _mm_and_si128(x1, x3);
+		x1 = _mm_clmulepi64_si128(x1, x0, 0x00);
+		x1 = _mm_xor_si128(x1, x2);
+
+		// Barrett reduce to 32 bits
+		x0 = _mm_loadu_si128((__m128i const*)poly);
+		x2 = _mm_and_si128(x1, x3);
+		x2 = _mm_clmulepi64_si128(x2, x0, 0x10);
+		x2 = _mm_and_si128(x2, x3);
+		x2 = _mm_clmulepi64_si128(x2, x0, 0x00);
+		x1 = _mm_xor_si128(x1, x2);
+		return (u32)_mm_extract_epi32(x1, 1);
+	}
+#endif
 
 	/**
 	 * @group		xhash
@@ -34,28 +228,336 @@ namespace ncore
 		u8 const* p_in = (u8 const*)buffer.m_begin;
 		u32	crc  = ~inInitVal;
 
-		// Create CRC32 table
-		if (CRC32::mIsEmpty)
+		u64 len = buffer.size();
+
+#if defined(CHASH_X64)
+		// Large buffers are folded with carry-less multiplication, the table path does the tail
+		if (len >= CRC32::CLMUL_MIN_SIZE && nhash_cpu::has(nhash_cpu::SSE41 | nhash_cpu::PCLMUL))
 		{
-			// Fill crc table for first 2^8 bit combinations
-			for (s32 n=0; n<(s32)CRC32::TABLE_SIZE; n++)
+			u64 const chunk = len & ~(u64)15;
+			crc = sCRC32_CLMUL(p_in, chunk, crc);
+			p_in += chunk;
+			len -= chunk;
+		}
+#endif
+
+		// Head, bytes until the data pointer is word aligned
+		while (len > 0 && ((uint_t)p_in & 7) != 0) { CRC32::CDO1(p_in, crc); len--; }
+
+		// Body, slicing-by-16 for the bulk and a single slicing-by-8 step for what is left
+		while (len >= 64) { CRC32::CDO16(p_in, crc); CRC32::CDO16(p_in, crc); CRC32::CDO16(p_in, crc); CRC32::CDO16(p_in, crc); len -= 64; }
+		while (len >= 16) { CRC32::CDO16(p_in, crc); len -= 16; }
+		if (len >= 8) { CRC32::CDO8(p_in, crc); len -= 8; }
+
+		// Tail
+		while (len > 0) { CRC32::CDO1(p_in, crc); len--; }
+
+		return ~crc;
+	}
+
+
+
+	// Build the tables that advance a CRC over <inLength> zero bytes, shifting is linear so every entry
+	// is the xor of the entries for its single bits, which are the bits multiplied by x^(8 * inLength)
+	static constexpr ncrc::table_t<u32, 4>	sCRCZeros(x2n_t const& inX2N, u32 inPoly, u32 inLength)
+	{
+		ncrc::table_t<u32, 4> zeros = {};
+		u32 const xn = sX2NModP(inX2N, inLength, 3, inPoly);
+		for (s32 k = 0; k < 4; k++)
+		{
+			for (s32 b = 0; b < 8; b++)
 			{
-				u32 c = n;
-				for (s32 k=0; k<8; k++)
-					c = (c & 1) ? (CRC32::POLY32^(c >> 1)) : (c >> 1);
-				CRC32::mTable[n] = c;
+				u32 const bit = sMultModP(xn, (u32)1 << (8 * k + b), inPoly);
+				for (s32 n = 0; n < (1 << b); n++)
+					zeros.m[k][(1 << b) + n] = bit ^ zeros.m[k][n];
 			}
-			CRC32::mIsEmpty = false;
 		}
+		return zeros;
+	}
 
-		for (u32 i=0; i<buffer.size(); i++)
-			crc = CRC32::mTable[(crc ^ (*p_in++)) & 0xff] ^ (crc >> 8);
+	/**
+	 *	CRC32C, CRC with the Castagnoli polynomial
+	 */
+	class CRC32C
+	{
+	public:
+		enum EConstants
+		{
+			POLY32		= 0x82f63b78,
+			TABLE_SIZE	= 256,
+			SLICES		= 8,
+
+			LONG		= 8192,														///< Size of each of the 3 interleaved streams over large buffers
+			SHORT		= 256														///< Size of each of the 3 interleaved streams over the remainder
+		};
+
+		typedef ncrc::table_t<u32, SLICES>	table_t;
+		typedef ncrc::table_t<u32, 4>		zeros_t;
+
+		static constexpr x2n_t		mX2N   = sX2NInit(POLY32);						///< x^(2^n) mod P, for combining CRCs
+		static constexpr table_t	mTable = ncrc::make_table<u32, 32, true, SLICES>(ncrc::reflect(POLY32, 32));
+		static constexpr zeros_t	mLong  = sCRCZeros(mX2N, POLY32, LONG);		///< Advances a CRC over LONG zero bytes
+		static constexpr zeros_t	mShort = sCRCZeros(mX2N, POLY32, SHORT);		///< Advances a CRC over SHORT zero bytes
+
+		static void		CDO1(u8 const*& ioDataPtr, u32& ioCRC)						{ ioCRC = mTable[0][(ioCRC ^ (*ioDataPtr++)) & 0xff] ^ (ioCRC >> 8); }
+		static void		CDO8(u8 const*& ioDataPtr, u32& ioCRC)
+		{
+			u32 const one = CRC32::LoadLE32(ioDataPtr) ^ ioCRC;
+			u32 const two = CRC32::LoadLE32(ioDataPtr + 4);
+			ioCRC = mTable[7][one & 0xff] ^ mTable[6][(one >> 8) & 0xff] ^ mTable[5][(one >> 16) & 0xff] ^ mTable[4][one >> 24]
+			      ^ mTable[3][two & 0xff] ^ mTable[2][(two >> 8) & 0xff] ^ mTable[1][(two >> 16) & 0xff] ^ mTable[0][two >> 24];
+			ioDataPtr += 8;
+		}
+
+		static u32		Shift(zeros_t const& inZeros, u32 inCRC)
+		{
+			return inZeros[0][inCRC & 0xff] ^ inZeros[1][(inCRC >> 8) & 0xff] ^ inZeros[2][(inCRC >> 16) & 0xff] ^ inZeros[3][inCRC >> 24];
+		}
+	};
+
+	constexpr x2n_t				CRC32C::mX2N;
+	constexpr CRC32C::table_t	CRC32C::mTable;
+	constexpr CRC32C::zeros_t	CRC32C::mLong;
+	constexpr CRC32C::zeros_t	CRC32C::mShort;
+
+#if defined(CHASH_X64)
+	/**
+	 * SSE4.2 CRC32C, the crc32 instruction has a latency of 3 cycles but a throughput of 1 per cycle,
+	 * so large buffers are processed as 3 independent streams that are merged afterwards by shifting
+	 * the CRC of a stream over the length of the streams that follow it.
+	 */
+	CHASH_TARGET("sse4.2")
+	static u32		sCRC32C_SSE42(u8 const* p_in, u64 len, u32 crc0)
+	{
+		// Head, bytes until the data pointer is word aligned
+		while (len > 0 && ((uint_t)p_in & 7) != 0)
+		{
+			crc0 = _mm_crc32_u8(crc0, *p_in++);
+			len--;
+		}
+
+		u64 c0 = crc0;
+		while (len >= 3 * (u64)CRC32C::LONG)
+		{
+			u64 c1 = 0;
+			u64 c2 = 0;
+			u8 const* const end = p_in + CRC32C::LONG;
+			do
+			{
+				c0 = _mm_crc32_u64(c0, *(u64 const*)(p_in));
+				c1 = _mm_crc32_u64(c1, *(u64 const*)(p_in + CRC32C::LONG));
+				c2 = _mm_crc32_u64(c2, *(u64 const*)(p_in + 2 * CRC32C::LONG));
+				p_in += 8;
+			} while (p_in < end);
+			c0 = CRC32C::Shift(CRC32C::mLong, (u32)c0) ^ c1;
+			c0 = CRC32C::Shift(CRC32C::mLong, (u32)c0) ^ c2;
+			p_in += 2 * CRC32C::LONG;
+			len -= 3 * CRC32C::LONG;
+		}
+
+		while (len >= 3 * (u64)CRC32C::SHORT)
+		{
+			u64 c1 = 0;
+			u64 c2 = 0;
+			u8 const* const end = p_in + CRC32C::SHORT;
+			do
+			{
+				c0 = _mm_crc32_u64(c0, *(u64 const*)(p_in));
+				c1 = _mm_crc32_u64(c1, *(u64 const*)(p_in + CRC32C::SHORT));
+				c2 = _mm_crc32_u64(c2, *(u64 const*)(p_in + 2 * CRC32C::SHORT));
+				p_in += 8;
+			} while (p_in < end);
+			c0 = CRC32C::Shift(CRC32C::mShort, (u32)c0) ^ c1;
+			c0 = CRC32C::Shift(CRC32C::mShort, (u32)c0) ^ c2;
+			p_in += 2 * CRC32C::SHORT;
+			len -= 3 * CRC32C::SHORT;
+		}
+
+		while (len >= 8)
+		{
+			c0 = _mm_crc32_u64(c0, *(u64 const*)p_in);
+			p_in += 8;
+			len -= 8;
+		}
+
+		crc0 = (u32)c0;
+		while (len > 0)
+		{
+			crc0 = _mm_crc32_u8(crc0, *p_in++);
+			len--;
+		}
+		return crc0;
+	}
+#endif
+
+	/**
+	 * @group		xhash
+	 * Calculate running CRC32C (Castagnoli) of <inInitVal> over <inBuffer> with length <inLength>
+	 */
+	u32	crc_t::crc32c(cbuffer_t const& buffer, u32 inInitVal)
+	{
+		ASSERT(buffer.m_begin);
+		u8 const* p_in = (u8 const*)buffer.m_begin;
+		u32	crc  = ~inInitVal;
+
+		u64 len = buffer.size();
+
+#if defined(CHASH_X64)
+		if (nhash_cpu::has(nhash_cpu::SSE42))
+			return ~sCRC32C_SSE42(p_in, len, crc);
+#endif
+
+		while (len > 0 && ((uint_t)p_in & 7) != 0) { CRC32C::CDO1(p_in, crc); len--; }
+		while (len >= 8) { CRC32C::CDO8(p_in, crc); len -= 8; }
+		while (len > 0) { CRC32C::CDO1(p_in, crc); len--; }
 
 		return ~crc;
 	}
 
 
 
+	/**
+	 *	CRC64, CRC-64/XZ (ECMA-182 polynomial, bit-reflected), the table path is crc64_xz_t
+	 */
+	class CRC64
+	{
+	public:
+		enum EConstants
+		{
+			CLMUL_MIN_SIZE	= 512														///< Buffers smaller than this stay on the table path
+		};
+
+		typedef crc64_xz_t	engine_t;
+	};
+
+#if defined(CHASH_X64)
+	/**
+	 * CRC64 by folding with carry-less multiplication, the same scheme as sCRC32_CLMUL. A carry-less product
+	 * of two bit-reflected 64-bit values is the reflected product times x, so the folding constants are
+	 * x^(D+63) and x^(D-1) mod P for a fold over D bits. The remaining 128 bits are not reduced with Barrett
+	 * but fed through the table path, from a zero register that gives exactly (128 bits * x^64) mod P.
+	 * <len> must be at least 64 and a multiple of 16, returns the CRC register.
+	 */
+	CHASH_TARGET("pclmul")
+	static u64		sCRC64_CLMUL(u8 const* p_in, u64 len, u64 crc)
+	{
+		// x^(4*128+63) mod P, x^(4*128-1) mod P, bit-reflected
+		static const u64 k1k2[2] = { 0x6ae3efbb9dd441f3ULL, 0x081f6054a7842df4ULL };
+		// x^(128+63) mod P, x^(128-1) mod P
+		static const u64 k3k4[2] = { 0xe05dd497ca393ae4ULL, 0xdabe95afc7875f40ULL };
+
+		__m128i x0, x1, x2, x3, x4, x5, x6, x7, x8, y5, y6, y7, y8;
+
+		x1 = _mm_loadu_si128((__m128i const*)(p_in + 0x00));
+		x2 = _mm_loadu_si128((__m128i const*)(p_in + 0x10));
+		x3 = _mm_loadu_si128((__m128i const*)(p_in + 0x20));
+		x4 = _mm_loadu_si128((__m128i const*)(p_in + 0x30));
+		x1 = _mm_xor_si128(x1, _mm_cvtsi64_si128((long long)crc));
+		x0 = _mm_loadu_si128((__m128i const*)k1k2);
+		p_in += 64;
+		len -= 64;
+
+		// Fold 4 x 128 bits in parallel
+		while (len >= 64)
+		{
+			x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+			x6 = _mm_clmulepi64_si128(x2, x0, 0x00);
+			x7 = _mm_clmulepi64_si128(x3, x0, 0x00);
+			x8 = _mm_clmulepi64_si128(x4, x0, 0x00);
+			x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+			x2 = _mm_clmulepi64_si128(x2, x0, 0x11);
+			x3 = _mm_clmulepi64_si128(x3, x0, 0x11);
+			x4 = _mm_clmulepi64_si128(x4, x0, 0x11);
+			y5 = _mm_loadu_si128((__m128i const*)(p_in + 0x00));
+			y6 = _mm_loadu_si128((__m128i const*)(p_in + 0x10));
+			y7 = _mm_loadu_si128((__m128i const*)(p_in + 0x20));
+			y8 = _mm_loadu_si128((__m128i const*)(p_in + 0x30));
+			x1 = _mm_xor_si128(_mm_xor_si128(x1, x5), y5);
+			x2 = _mm_xor_si128(_mm_xor_si128(x2, x6), y6);
+			x3 = _mm_xor_si128(_mm_xor_si128(x3, x7), y7);
+			x4 = _mm_xor_si128(_mm_xor_si128(x4, x8), y8);
+			p_in += 64;
+			len -= 64;
+		}
+
+		// Fold into 128 bits
+		x0 = _mm_loadu_si128((__m128i const*)k3k4);
+		x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+		x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+		x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+		x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+		x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+		x1 = _mm_xor_si128(_mm_xor_si128(x1, x3), x5);
+		x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+		x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+		x1 = _mm_xor_si128(_mm_xor_si128(x1, x4), x5);
+
+		// Single fold blocks of 128 bits
+		while (len >= 16)
+		{
+			x2 = _mm_loadu_si128((__m128i const*)p_in);
+			x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+			x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+			x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+			p_in += 16;
+			len -= 16;
+		}
+
+		// Reduce the last 128 bits
+		u8 rest[16];
+		_mm_storeu_si128((__m128i*)rest, x1);
+		return CRC64::engine_t::update(0, rest, sizeof(rest));
+	}
+#endif
+
+	/**
+	 * @group		xhash
+	 * Calculate running CRC64 (CRC-64/XZ) of <inInitVal> over <inBuffer> with length <inLength>
+	 */
+	u64	crc_t::crc64(cbuffer_t const& buffer, u64 inInitVal)
+	{
+		ASSERT(buffer.m_begin);
+		u8 const* p_in = (u8 const*)buffer.m_begin;
+		u64	crc  = ~inInitVal;
+
+		u64 len = buffer.size();
+
+#if defined(CHASH_X64)
+		if (len >= CRC64::CLMUL_MIN_SIZE && nhash_cpu::has(nhash_cpu::PCLMUL))
+		{
+			u64 const chunk = len & ~(u64)15;
+			crc = sCRC64_CLMUL(p_in, chunk, crc);
+			p_in += chunk;
+			len -= chunk;
+		}
+#endif
+
+		return ~CRC64::engine_t::update(crc, p_in, len);
+	}
+
+
+
+	/**
+	 * @group		xhash
+	 * Combine the CRC32 of A and the CRC32 of B (with length <inLengthB>) into the CRC32 of A followed by B.
+	 * Both CRCs must have been computed with an initial value of 0.
+	 */
+	u32 crc_t::crc32_combine(u32 inCRCA, u32 inCRCB, u64 inLengthB)
+	{
+		return sMultModP(sX2NModP(CRC32::mX2N, inLengthB, 3, CRC32::POLY32), inCRCA, CRC32::POLY32) ^ inCRCB;
+	}
+
+	/**
+	 * @group		xhash
+	 * Combine two CRC32C values, see crc32_combine
+	 */
+	u32 crc_t::crc32c_combine(u32 inCRCA, u32 inCRCB, u64 inLengthB)
+	{
+		return sMultModP(sX2NModP(CRC32C::mX2N, inLengthB, 3, CRC32C::POLY32), inCRCA, CRC32C::POLY32) ^ inCRCB;
+	}
+
+
+
 	/**
 	 *	Adler16 & Adler32 checksums
 	 */
@@ -76,6 +578,121 @@ namespace ncore
 		static void		ADO16(u8 const*& ioDataPtr, u32& ioA1, u32& ioA2)			{ ADO4(ioDataPtr, ioA1, ioA2); ADO4(ioDataPtr, ioA1, ioA2); ADO4(ioDataPtr, ioA1, ioA2); ADO4(ioDataPtr, ioA1, ioA2); }
 	};
 
+#if defined(CHASH_X64)
+	/**
+	 * Vectorized Adler32, processes blocks of 32 bytes. Per block s1 is summed with psadbw and the weighted
+	 * s2 contribution (32 - i) * byte[i] with pmaddubsw, while the s1 of previous blocks is accumulated
+	 * separately and added 32 times at the end of a run. Consumes all whole blocks, leaving the remaining
+	 * bytes for the scalar loop, and returns a1 and a2 reduced modulo BASE32.
+	 */
+	CHASH_TARGET("ssse3")
+	static void		sAdler32_SSSE3(u8 const*& ioDataPtr, s64& ioLength, u32& ioA1, u32& ioA2)
+	{
+		enum { BLOCK_SIZE = 32 };
+
+		u8 const* p_in   = ioDataPtr;
+		s64       blocks = ioLength / BLOCK_SIZE;
+		ioLength -= blocks * BLOCK_SIZE;
+
+		__m128i const tap1 = _mm_setr_epi8(32, 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17);
+		__m128i const tap2 = _mm_setr_epi8(16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1);
+		__m128i const zero = _mm_setzero_si128();
+		__m128i const ones = _mm_set1_epi16(1);
+
+		u32 a1 = ioA1;
+		u32 a2 = ioA2;
+		while (blocks)
+		{
+			s64 n = CRCAdler::NMAX32 / BLOCK_SIZE;
+			if (n > blocks)
+				n = blocks;
+			blocks -= n;
+
+			__m128i v_ps = _mm_set_epi32(0, 0, 0, (s32)(a1 * (u32)n));
+			__m128i v_s2 = _mm_set_epi32(0, 0, 0, (s32)a2);
+			__m128i v_s1 = _mm_setzero_si128();
+			do
+			{
+				__m128i const bytes1 = _mm_loadu_si128((__m128i const*)(p_in));
+				__m128i const bytes2 = _mm_loadu_si128((__m128i const*)(p_in + 16));
+				v_ps = _mm_add_epi32(v_ps, v_s1);
+				v_s1 = _mm_add_epi32(v_s1, _mm_sad_epu8(bytes1, zero));
+				v_s2 = _mm_add_epi32(v_s2, _mm_madd_epi16(_mm_maddubs_epi16(bytes1, tap1), ones));
+				v_s1 = _mm_add_epi32(v_s1, _mm_sad_epu8(bytes2, zero));
+				v_s2 = _mm_add_epi32(v_s2, _mm_madd_epi16(_mm_maddubs_epi16(bytes2, tap2), ones));
+				p_in += BLOCK_SIZE;
+			} while (--n);
+			v_s2 = _mm_add_epi32(v_s2, _mm_slli_epi32(v_ps, 5));
+
+			// Horizontal sums
+			v_s1 = _mm_add_epi32(v_s1, _mm_shuffle_epi32(v_s1, _MM_SHUFFLE(2, 3, 0, 1)));
+			v_s1 = _mm_add_epi32(v_s1, _mm_shuffle_epi32(v_s1, _MM_SHUFFLE(1, 0, 3, 2)));
+			v_s2 = _mm_add_epi32(v_s2, _mm_shuffle_epi32(v_s2, _MM_SHUFFLE(2, 3, 0, 1)));
+			v_s2 = _mm_add_epi32(v_s2, _mm_shuffle_epi32(v_s2, _MM_SHUFFLE(1, 0, 3, 2)));
+			a1 = (a1 + (u32)_mm_cvtsi128_si32(v_s1)) % CRCAdler::BASE32;
+			a2 = ((u32)_mm_cvtsi128_si32(v_s2)) % CRCAdler::BASE32;
+		}
+
+		ioDataPtr = p_in;
+		ioA1      = a1;
+		ioA2      = a2;
+	}
+
+	/**
+	 * AVX2 variant of sAdler32_SSSE3, one 32 byte block per load
+	 */
+	CHASH_TARGET("avx2")
+	static void		sAdler32_AVX2(u8 const*& ioDataPtr, s64& ioLength, u32& ioA1, u32& ioA2)
+	{
+		enum { BLOCK_SIZE = 32 };
+
+		u8 const* p_in   = ioDataPtr;
+		s64       blocks = ioLength / BLOCK_SIZE;
+		ioLength -= blocks * BLOCK_SIZE;
+
+		__m256i const tap  = _mm256_setr_epi8(32, 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17, 16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1);
+		__m256i const zero = _mm256_setzero_si256();
+		__m256i const ones = _mm256_set1_epi16(1);
+
+		u32 a1 = ioA1;
+		u32 a2 = ioA2;
+		while (blocks)
+		{
+			s64 n = CRCAdler::NMAX32 / BLOCK_SIZE;
+			if (n > blocks)
+				n = blocks;
+			blocks -= n;
+
+			__m256i v_ps = _mm256_setr_epi32((s32)(a1 * (u32)n), 0, 0, 0, 0, 0, 0, 0);
+			__m256i v_s2 = _mm256_setr_epi32((s32)a2, 0, 0, 0, 0, 0, 0, 0);
+			__m256i v_s1 = _mm256_setzero_si256();
+			do
+			{
+				__m256i const bytes = _mm256_loadu_si256((__m256i const*)p_in);
+				v_ps = _mm256_add_epi32(v_ps, v_s1);
+				v_s1 = _mm256_add_epi32(v_s1, _mm256_sad_epu8(bytes, zero));
+				v_s2 = _mm256_add_epi32(v_s2, _mm256_madd_epi16(_mm256_maddubs_epi16(bytes, tap), ones));
+				p_in += BLOCK_SIZE;
+			} while (--n);
+			v_s2 = _mm256_add_epi32(v_s2, _mm256_slli_epi32(v_ps, 5));
+
+			// Horizontal sums, first fold the upper 128 bits onto the lower 128 bits
+			__m128i s1 = _mm_add_epi32(_mm256_castsi256_si128(v_s1), _mm256_extracti128_si256(v_s1, 1));
+			__m128i s2 = _mm_add_epi32(_mm256_castsi256_si128(v_s2), _mm256_extracti128_si256(v_s2, 1));
+			s1 = _mm_add_epi32(s1, _mm_shuffle_epi32(s1, _MM_SHUFFLE(2, 3, 0, 1)));
+			s1 = _mm_add_epi32(s1, _mm_shuffle_epi32(s1, _MM_SHUFFLE(1, 0, 3, 2)));
+			s2 = _mm_add_epi32(s2, _mm_shuffle_epi32(s2, _MM_SHUFFLE(2, 3, 0, 1)));
+			s2 = _mm_add_epi32(s2, _mm_shuffle_epi32(s2, _MM_SHUFFLE(1, 0, 3, 2)));
+			a1 = (a1 + (u32)_mm_cvtsi128_si32(s1)) % CRCAdler::BASE32;
+			a2 = ((u32)_mm_cvtsi128_si32(s2)) % CRCAdler::BASE32;
+		}
+
+		ioDataPtr = p_in;
+		ioA1      = a1;
+		ioA2      = a2;
+	}
+#endif
+
 	/**
 	 * @group		xhash
 	 * Calculate running Adler32 of <inInitVal> over <inBuffer> with length <inLength>
@@ -89,6 +706,18 @@ namespace ncore
 
 		// Go on doing bits and pieces of the area until we're done
 		s64 len = buffer.size();
+
+#if defined(CHASH_X64)
+		// Whole blocks with SIMD, CRCAdler handles the remaining bytes
+		if (len >= 64)
+		{
+			if (nhash_cpu::has(nhash_cpu::AVX2))
+				sAdler32_AVX2(p_in, len, a1, a2);
+			else if (nhash_cpu::has(nhash_cpu::SSSE3))
+				sAdler32_SSSE3(p_in, len, a1, a2);
+		}
+#endif
+
 		while (len)
 		{
 			s64 max_do = (len < (s32)CRCAdler::NMAX32) ? len : ((s32)CRCAdler::NMAX32);
@@ -104,6 +733,27 @@ namespace ncore
 		return (a1 | (a2 << 16));
 	}
 
+	/**
+	 * @group		xhash
+	 * Combine the Adler32 of A and the Adler32 of B (with length <inLengthB>) into the Adler32 of A followed by B.
+	 * Both checksums must have been computed with the default initial value of 1.
+	 */
+	u32 crc_t::adler32_combine(u32 inAdlerA, u32 inAdlerB, u64 inLengthB)
+	{
+		u32 const base = CRCAdler::BASE32;
+		u32 const rem  = (u32)(inLengthB % base);
+
+		u32 sum1 = inAdlerA & 0xFFFF;
+		u32 sum2 = (u32)(((u64)rem * sum1) % base);
+		sum1 += (inAdlerB & 0xFFFF) + base - 1;
+		sum2 += ((inAdlerA >> 16) & 0xFFFF) + ((inAdlerB >> 16) & 0xFFFF) + base - rem;
+		if (sum1 >= base) sum1 -= base;
+		if (sum1 >= base) sum1 -= base;
+		if (sum2 >= (base << 1)) sum2 -= (base << 1);
+		if (sum2 >= base) sum2 -= base;
+		return sum1 | (sum2 << 16);
+	}
+
 
 
 	/**
@@ -134,4 +784,156 @@ namespace ncore
 		return (a1 | (a2<<8));
 	}
 
+
+
+	/**
+	 *	Parallel checksums, the buffer is cut into stripes that are checksummed as independent jobs
+	 *	and the stripe checksums are then merged in order with the matching combine function.
+	 */
+	class CRCParallel
+	{
+	public:
+		enum EConstants
+		{
+			STRIPE_MIN		= 256 * 1024,											///< Smallest stripe, about the size of a L2 cache
+			STRIPE_ALIGN	= 4096,
+			STRIPES_MAX		= 64,													///< Stripes per pass, bounds the size of mResults
+		};
+
+		typedef u32			(*checksum_fn)(cbuffer_t const& buffer, u32 inInitVal);
+		typedef u32			(*combine_fn)(u32 inA, u32 inB, u64 inLengthB);
+
+		u8 const*			mData;
+		u64					mSize;
+		u64					mStripe;
+		u32					mInitVal;
+		checksum_fn			mChecksum;
+		u32					mResults[STRIPES_MAX];
+
+		static void			Job(void* inUser, s32 inIndex)
+		{
+			CRCParallel* ctx   = (CRCParallel*)inUser;
+			u64 const    begin = (u64)inIndex * ctx->mStripe;
+			u64 const    end   = (begin + ctx->mStripe) < ctx->mSize ? (begin + ctx->mStripe) : ctx->mSize;
+			ctx->mResults[inIndex] = ctx->mChecksum(cbuffer_t(ctx->mData + begin, ctx->mData + end), ctx->mInitVal);
+		}
+
+		static u32			Run(cbuffer_t const& buffer, hash_jobs_t* jobs, u32 inInitVal, u32 inStripeInitVal, checksum_fn inChecksum, combine_fn inCombine)
+		{
+			u64 const size    = buffer.size();
+			s32 const workers = jobs != nullptr ? jobs->workers() : 1;
+
+			u64 stripe = size / ((u64)workers * 4);
+			if (stripe < STRIPE_MIN)
+				stripe = STRIPE_MIN;
+			stripe = (stripe + STRIPE_ALIGN - 1) & ~((u64)STRIPE_ALIGN - 1);
+
+			if (workers <= 1 || size < 2 * stripe)
+				return inChecksum(buffer, inInitVal);
+
+			CRCParallel ctx;
+			ctx.mStripe   = stripe;
+			ctx.mInitVal  = inStripeInitVal;
+			ctx.mChecksum = inChecksum;
+
+			u32       result = inInitVal;
+			u8 const* data   = (u8 const*)buffer.m_begin;
+			u64       todo   = size;
+			while (todo > 0)
+			{
+				u64 const pass_size = todo < (stripe * STRIPES_MAX) ? todo : (stripe * STRIPES_MAX);
+				s32 const count     = (s32)((pass_size + stripe - 1) / stripe);
+				ctx.mData           = data;
+				ctx.mSize           = pass_size;
+				jobs->run(&CRCParallel::Job, &ctx, count);
+
+				for (s32 i = 0; i < count; ++i)
+				{
+					u64 const begin = (u64)i * stripe;
+					u64 const len   = (begin + stripe) < pass_size ? stripe : (pass_size - begin);
+					result          = inCombine(result, ctx.mResults[i], len);
+				}
+				data += pass_size;
+				todo -= pass_size;
+			}
+			return result;
+		}
+	};
+
+	/**
+	 * @group		xhash
+	 * Calculate running CRC32 of <inInitVal> over <inBuffer> using the job system
+	 */
+	u32 crc_t::crc32_parallel(cbuffer_t const& buffer, hash_jobs_t* jobs, u32 inInitVal)
+	{
+		return CRCParallel::Run(buffer, jobs, inInitVal, 0, &crc_t::crc32, &crc_t::crc32_combine);
+	}
+
+	/**
+	 * @group		xhash
+	 * Calculate running CRC32C of <inInitVal> over <inBuffer> using the job system
+	 */
+	u32 crc_t::crc32c_parallel(cbuffer_t const& buffer, hash_jobs_t* jobs, u32 inInitVal)
+	{
+		return CRCParallel::Run(buffer, jobs, inInitVal, 0, &crc_t::crc32c, &crc_t::crc32c_combine);
+	}
+
+	/**
+	 * @group		xhash
+	 * Calculate running Adler32 of <inInitVal> over <inBuffer> using the job system
+	 */
+	u32 crc_t::adler32_parallel(cbuffer_t const& buffer, hash_jobs_t* jobs, u32 inInitVal)
+	{
+		return CRCParallel::Run(buffer, jobs, inInitVal, 1, &crc_t::adler32, &crc_t::adler32_combine);
+	}
+
+
+
+	// crc_t asserts on a null buffer, an empty range (possibly nullptr, nullptr) leaves the value unchanged
+	namespace nhash_private
+	{
+		static void		sWriteBE32(u8* outHash, u32 inValue)
+		{
+			outHash[0] = (u8)(inValue >> 24);
+			outHash[1] = (u8)(inValue >> 16);
+			outHash[2] = (u8)(inValue >> 8);
+			outHash[3] = (u8)(inValue);
+		}
+
+		void crc32_t::reset(u64 seed)								{ m_seed = (u32)seed; m_crc = m_seed; }
+		void crc32_t::hash(u8 const* data, u8 const* end)			{ if (data != end) m_crc = crc_t::crc32(cbuffer_t(data, end), m_crc); }
+		void crc32_t::end(u8* hash)									{ sWriteBE32(hash, m_crc); }
+
+		void crc32c_t::reset(u64 seed)								{ m_seed = (u32)seed; m_crc = m_seed; }
+		void crc32c_t::hash(u8 const* data, u8 const* end)			{ if (data != end) m_crc = crc_t::crc32c(cbuffer_t(data, end), m_crc); }
+		void crc32c_t::end(u8* hash)								{ sWriteBE32(hash, m_crc); }
+
+		void adler32_t::reset(u64 seed)								{ m_seed = (u32)seed; m_adler = m_seed; }
+		void adler32_t::hash(u8 const* data, u8 const* end)			{ if (data != end) m_adler = crc_t::adler32(cbuffer_t(data, end), m_adler); }
+		void adler32_t::end(u8* hash)								{ sWriteBE32(hash, m_adler); }
+	}
+
+	namespace nhash
+	{
+		crc32 hash_crc32(u8 const* data, u64 len)
+		{
+			crc32 digest;
+			nhash_private::sWriteBE32(digest.m_data, len == 0 ? 0 : crc_t::crc32(cbuffer_t(data, data + len)));
+			return digest;
+		}
+
+		crc32c hash_crc32c(u8 const* data, u64 len)
+		{
+			crc32c digest;
+			nhash_private::sWriteBE32(digest.m_data, len == 0 ? 0 : crc_t::crc32c(cbuffer_t(data, data + len)));
+			return digest;
+		}
+
+		adler32 hash_adler32(u8 const* data, u64 len)
+		{
+			adler32 digest;
+			nhash_private::sWriteBE32(digest.m_data, len == 0 ? 1 : crc_t::adler32(cbuffer_t(data, data + len)));
+			return digest;
+		}
+	}
 }
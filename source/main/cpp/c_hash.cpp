@@ -8,7 +8,7 @@ namespace ncore
 {
     using namespace nhash_private;
 
-    static inline void ctxt_clear(hash_instance_t ctxt, u32 size, u16 type)
+    static inline void ctxt_clear(hash_instance_t ctxt, u32 size, u32 type)
     {
         u8* data = (u8*)ctxt;
         for (u32 i = 0; i < size; ++i)
@@ -42,13 +42,25 @@ namespace ncore
         {
             case ehashtype::MD5: ((md5_t*)ctxt)->reset(); break;
             case ehashtype::SHA1: ((sha1_t*)ctxt)->reset(); break;
+            case ehashtype::SHA256: ((sha256_t*)ctxt)->reset(); break;
+            case ehashtype::SHA512: ((sha512_t*)ctxt)->reset(); break;
             case ehashtype::Skein256: ((skein256_t*)ctxt)->reset(); break;
             case ehashtype::Skein512: ((skein512_t*)ctxt)->reset(); break;
             case ehashtype::Skein1024: ((skein1024_t*)ctxt)->reset(); break;
             case ehashtype::Murmur32: ((murmur32_t*)ctxt)->reset(); break;
             case ehashtype::Murmur64: ((murmur64_t*)ctxt)->reset(); break;
+            case ehashtype::Murmur3_32: ((murmur3_32_t*)ctxt)->reset(); break;
+            case ehashtype::Murmur3_128: ((murmur3_128_t*)ctxt)->reset(); break;
             case ehashtype::XXHash64: ((xxhash64_t*)ctxt)->reset(); break;
+            case ehashtype::XXHash64Legacy: ((xxhash64_legacy_t*)ctxt)->reset(); break;
+            case ehashtype::XXH3_64: ((xxh3_64_t*)ctxt)->reset(); break;
+            case ehashtype::XXH3_128: ((xxh3_128_t*)ctxt)->reset(); break;
+            case ehashtype::XXHash32: ((xxhash32_t*)ctxt)->reset(); break;
             case ehashtype::SpookyHashV2: ((spookyhashv2_t*)ctxt)->reset(); break;
+            case ehashtype::CRC32: ((crc32_t*)ctxt)->reset(); break;
+            case ehashtype::CRC32C: ((crc32c_t*)ctxt)->reset(); break;
+            case ehashtype::Adler32: ((adler32_t*)ctxt)->reset(); break;
+            case ehashtype::BLAKE3: ((blake3_t*)ctxt)->reset(); break;
         }
     }
 
@@ -59,13 +71,25 @@ namespace ncore
         {
             case ehashtype::MD5: ((md5_t*)ctxt)->hash(begin, end); break;
             case ehashtype::SHA1: ((sha1_t*)ctxt)->hash(begin, end); break;
+            case ehashtype::SHA256: ((sha256_t*)ctxt)->hash(begin, end); break;
+            case ehashtype::SHA512: ((sha512_t*)ctxt)->hash(begin, end); break;
             case ehashtype::Skein256: ((skein256_t*)ctxt)->hash(begin, end); break;
             case ehashtype::Skein512: ((skein512_t*)ctxt)->hash(begin, end); break;
             case ehashtype::Skein1024: ((skein1024_t*)ctxt)->hash(begin, end); break;
             case ehashtype::Murmur32: ((murmur32_t*)ctxt)->hash(begin, end); break;
             case ehashtype::Murmur64: ((murmur64_t*)ctxt)->hash(begin, end); break;
+            case ehashtype::Murmur3_32: ((murmur3_32_t*)ctxt)->hash(begin, end); break;
+            case ehashtype::Murmur3_128: ((murmur3_128_t*)ctxt)->hash(begin, end); break;
             case ehashtype::XXHash64: ((xxhash64_t*)ctxt)->hash(begin, end); break;
+            case ehashtype::XXHash64Legacy: ((xxhash64_legacy_t*)ctxt)->hash(begin, end); break;
+            case ehashtype::XXH3_64: ((xxh3_64_t*)ctxt)->hash(begin, end); break;
+            case ehashtype::XXH3_128: ((xxh3_128_t*)ctxt)->hash(begin, end); break;
+            case ehashtype::XXHash32: ((xxhash32_t*)ctxt)->hash(begin, end); break;
             case ehashtype::SpookyHashV2: ((spookyhashv2_t*)ctxt)->hash(begin, end); break;
+            case ehashtype::CRC32: ((crc32_t*)ctxt)->hash(begin, end); break;
+            case ehashtype::CRC32C: ((crc32c_t*)ctxt)->hash(begin, end); break;
+            case ehashtype::Adler32: ((adler32_t*)ctxt)->hash(begin, end); break;
+            case ehashtype::BLAKE3: ((blake3_t*)ctxt)->hash(begin, end); break;
         }
     }
 
@@ -76,14 +100,72 @@ namespace ncore
         {
             case ehashtype::MD5: ((md5_t*)ctxt)->end(out_hash); break;
             case ehashtype::SHA1: ((sha1_t*)ctxt)->end(out_hash); break;
+            case ehashtype::SHA256: ((sha256_t*)ctxt)->end(out_hash); break;
+            case ehashtype::SHA512: ((sha512_t*)ctxt)->end(out_hash); break;
             case ehashtype::Skein256: ((skein256_t*)ctxt)->end(out_hash); break;
             case ehashtype::Skein512: ((skein512_t*)ctxt)->end(out_hash); break;
             case ehashtype::Skein1024: ((skein1024_t*)ctxt)->end(out_hash); break;
             case ehashtype::Murmur32: ((murmur32_t*)ctxt)->end(out_hash); break;
             case ehashtype::Murmur64: ((murmur64_t*)ctxt)->end(out_hash); break;
+            case ehashtype::Murmur3_32: ((murmur3_32_t*)ctxt)->end(out_hash); break;
+            case ehashtype::Murmur3_128: ((murmur3_128_t*)ctxt)->end(out_hash); break;
             case ehashtype::XXHash64: ((xxhash64_t*)ctxt)->end(out_hash); break;
+            case ehashtype::XXHash64Legacy: ((xxhash64_legacy_t*)ctxt)->end(out_hash); break;
+            case ehashtype::XXH3_64: ((xxh3_64_t*)ctxt)->end(out_hash); break;
+            case ehashtype::XXH3_128: ((xxh3_128_t*)ctxt)->end(out_hash); break;
+            case ehashtype::XXHash32: ((xxhash32_t*)ctxt)->end(out_hash); break;
             case ehashtype::SpookyHashV2: ((spookyhashv2_t*)ctxt)->end(out_hash); break;
+            case ehashtype::CRC32: ((crc32_t*)ctxt)->end(out_hash); break;
+            case ehashtype::CRC32C: ((crc32c_t*)ctxt)->end(out_hash); break;
+            case ehashtype::Adler32: ((adler32_t*)ctxt)->end(out_hash); break;
+            case ehashtype::BLAKE3: ((blake3_t*)ctxt)->end(out_hash); break;
         }
     }
 
+    void hash_set_jobs(hash_instance_t ctxt, hash_jobs_t* jobs)
+    {
+        hash_header_t* hash = (hash_header_t*)ctxt;
+        switch (hash->type)
+        {
+            case ehashtype::BLAKE3: ((blake3_t*)ctxt)->m_jobs = jobs; break;
+        }
+    }
+
+    namespace nhash
+    {
+        template <typename D> static inline void copy_digest(D const& digest, u8* out_hash)
+        {
+            for (s32 i = 0; i < D::SIZE; ++i)
+                out_hash[i] = digest.m_data[i];
+        }
+
+        void hash(ehashtype::value_t type, u8 const* data, u64 len, u8* out_hash)
+        {
+            switch (type)
+            {
+                case ehashtype::MD5: copy_digest(hash_md5(data, len), out_hash); break;
+                case ehashtype::SHA1: copy_digest(hash_sha1(data, len), out_hash); break;
+                case ehashtype::SHA256: copy_digest(hash_sha256(data, len), out_hash); break;
+                case ehashtype::SHA512: copy_digest(hash_sha512(data, len), out_hash); break;
+                case ehashtype::Skein256: copy_digest(hash_skein256(data, len), out_hash); break;
+                case ehashtype::Skein512: copy_digest(hash_skein512(data, len), out_hash); break;
+                case ehashtype::Skein1024: copy_digest(hash_skein1024(data, len), out_hash); break;
+                case ehashtype::Murmur32: copy_digest(hash_murmur32(data, len), out_hash); break;
+                case ehashtype::Murmur64: copy_digest(hash_murmur64(data, len), out_hash); break;
+                case ehashtype::Murmur3_32: copy_digest(hash_murmur3_32(data, len), out_hash); break;
+                case ehashtype::Murmur3_128: copy_digest(hash_murmur3_128(data, len), out_hash); break;
+                case ehashtype::XXHash64: copy_digest(hash_xxhash64(data, len), out_hash); break;
+                case ehashtype::XXHash64Legacy: copy_digest(hash_xxhash64legacy(data, len), out_hash); break;
+                case ehashtype::XXH3_64: copy_digest(hash_xxh3_64(data, len), out_hash); break;
+                case ehashtype::XXH3_128: copy_digest(hash_xxh3_128(data, len), out_hash); break;
+                case ehashtype::XXHash32: copy_digest(hash_xxhash32(data, len), out_hash); break;
+                case ehashtype::SpookyHashV2: copy_digest(hash_spookyhashv2(data, len), out_hash); break;
+                case ehashtype::CRC32: copy_digest(hash_crc32(data, len), out_hash); break;
+                case ehashtype::CRC32C: copy_digest(hash_crc32c(data, len), out_hash); break;
+                case ehashtype::Adler32: copy_digest(hash_adler32(data, len), out_hash); break;
+                case ehashtype::BLAKE3: copy_digest(hash_blake3(data, len), out_hash); break;
+            }
+        }
+    } // namespace nhash
+
 } // namespace ncore
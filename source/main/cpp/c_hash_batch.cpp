@@ -0,0 +1,306 @@
+#include "ccore/c_target.h"
+
+#include "chash/private/c_hash_cpu.h"
+#include "chash/private/c_hash_mix.h"
+#include "chash/c_hash.h"
+
+#if defined(CHASH_X64)
+#    include <immintrin.h>
+#endif
+
+namespace ncore
+{
+    // Hashing of fixed width integer keys, every function has a scalar version for a single key which
+    // is also used for the remainder of a batch, and an AVX2 version that returns how many keys it
+    // processed (a multiple of its lane count).
+
+    using nhash_private::fmix32;
+    using nhash_private::fmix64;
+    using nhash_private::FMIX32_C1;
+    using nhash_private::FMIX32_C2;
+    using nhash_private::FMIX64_C1;
+    using nhash_private::FMIX64_C2;
+    using nhash_private::MURMUR2_M;
+    using nhash_private::MURMUR2_R;
+    using nhash_private::murmur2_final;
+    using nhash_private::murmur2_mix;
+    using nhash_private::xxh64_avalanche;
+    using nhash_private::xxh64_round;
+    using nhash_private::xxh_rotl64;
+    using nhash_private::XXH_PRIME64_1;
+    using nhash_private::XXH_PRIME64_2;
+    using nhash_private::XXH_PRIME64_3;
+    using nhash_private::XXH_PRIME64_4;
+    using nhash_private::XXH_PRIME64_5;
+
+    static inline u32 murmur2_u32(u32 key, u32 seed) { return murmur2_final(murmur2_mix(seed ^ 4, key)); }
+    static inline u32 murmur2_u64(u64 key, u32 seed) { return murmur2_final(murmur2_mix(murmur2_mix(seed ^ 8, (u32)key), (u32)(key >> 32))); }
+
+    static inline u64 murmur64b_u64(u64 key, u64 seed)
+    {
+        u32 h1 = murmur2_mix((u32)seed ^ 8, (u32)key);
+        u32 h2 = murmur2_mix((u32)(seed >> 32), (u32)(key >> 32));
+        h1 ^= h2 >> 18;
+        h1 *= MURMUR2_M;
+        h2 ^= h1 >> 22;
+        h2 *= MURMUR2_M;
+        h1 ^= h2 >> 17;
+        h1 *= MURMUR2_M;
+        h2 ^= h1 >> 19;
+        h2 *= MURMUR2_M;
+        return ((u64)h1 << 32) | h2;
+    }
+
+    static inline u64 xxh64_u32(u32 key, u64 seed)
+    {
+        u64 h = seed + XXH_PRIME64_5 + 4;
+        h ^= (u64)key * XXH_PRIME64_1;
+        h = xxh_rotl64(h, 23) * XXH_PRIME64_2 + XXH_PRIME64_3;
+        return xxh64_avalanche(h);
+    }
+
+    static inline u64 xxh64_u64(u64 key, u64 seed)
+    {
+        u64 h = (seed + XXH_PRIME64_5 + 8) ^ xxh64_round(0, key);
+        h     = xxh_rotl64(h, 27) * XXH_PRIME64_1 + XXH_PRIME64_4;
+        return xxh64_avalanche(h);
+    }
+
+#if defined(CHASH_X64)
+    // The 32-bit hashes run 8 keys per vector, the 64-bit hashes 4 keys per vector. AVX2 has no 64-bit
+    // multiply, a 64-bit product with a constant is assembled from three 32x32->64 multiplies.
+
+    CHASH_TARGET("avx2")
+    static inline __m256i murmur2_mix_avx2(__m256i h, __m256i k, __m256i m)
+    {
+        k = _mm256_mullo_epi32(k, m);
+        k = _mm256_xor_si256(k, _mm256_srli_epi32(k, MURMUR2_R));
+        k = _mm256_mullo_epi32(k, m);
+        return _mm256_xor_si256(_mm256_mullo_epi32(h, m), k);
+    }
+
+    CHASH_TARGET("avx2")
+    static inline __m256i murmur2_final_avx2(__m256i h, __m256i m)
+    {
+        h = _mm256_xor_si256(h, _mm256_srli_epi32(h, 13));
+        h = _mm256_mullo_epi32(h, m);
+        return _mm256_xor_si256(h, _mm256_srli_epi32(h, 15));
+    }
+
+    // Split 8 u64 keys into a vector of their low words and a vector of their high words, key order is kept
+    CHASH_TARGET("avx2")
+    static inline void split_u64_avx2(u64 const* keys, __m256i& lo, __m256i& hi)
+    {
+        __m256i const idx = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+        __m256i const a   = _mm256_permutevar8x32_epi32(_mm256_loadu_si256((__m256i const*)keys + 0), idx);
+        __m256i const b   = _mm256_permutevar8x32_epi32(_mm256_loadu_si256((__m256i const*)keys + 1), idx);
+        lo                = _mm256_permute2x128_si256(a, b, 0x20);
+        hi                = _mm256_permute2x128_si256(a, b, 0x31);
+    }
+
+    CHASH_TARGET("avx2")
+    static inline __m256i mul64_avx2(__m256i a, __m256i c_lo, __m256i c_hi)
+    {
+        __m256i const lo    = _mm256_mul_epu32(a, c_lo);
+        __m256i const cross = _mm256_add_epi64(_mm256_mul_epu32(_mm256_srli_epi64(a, 32), c_lo), _mm256_mul_epu32(a, c_hi));
+        return _mm256_add_epi64(lo, _mm256_slli_epi64(cross, 32));
+    }
+
+    CHASH_TARGET("avx2")
+    static inline __m256i rotl64_avx2(__m256i x, s32 r) { return _mm256_or_si256(_mm256_slli_epi64(x, r), _mm256_srli_epi64(x, 64 - r)); }
+
+#    define BATCH_SET1_64(c)   _mm256_set1_epi64x((long long)(c))
+#    define BATCH_SET1_LO64(c) _mm256_set1_epi64x((long long)(u32)(c))
+#    define BATCH_SET1_HI64(c) _mm256_set1_epi64x((long long)((c) >> 32))
+
+    CHASH_TARGET("avx2")
+    static inline __m256i xxh64_avalanche_avx2(__m256i h)
+    {
+        h = _mm256_xor_si256(h, _mm256_srli_epi64(h, 33));
+        h = mul64_avx2(h, BATCH_SET1_LO64(XXH_PRIME64_2), BATCH_SET1_HI64(XXH_PRIME64_2));
+        h = _mm256_xor_si256(h, _mm256_srli_epi64(h, 29));
+        h = mul64_avx2(h, BATCH_SET1_LO64(XXH_PRIME64_3), BATCH_SET1_HI64(XXH_PRIME64_3));
+        return _mm256_xor_si256(h, _mm256_srli_epi64(h, 32));
+    }
+
+    CHASH_TARGET("avx2")
+    static u64 murmur2_u32_avx2(u32 const* keys, u32* out, u64 n, u32 seed)
+    {
+        __m256i const m  = _mm256_set1_epi32((int)MURMUR2_M);
+        __m256i const h0 = _mm256_set1_epi32((int)(seed ^ 4));
+        u64           i  = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            __m256i const k = _mm256_loadu_si256((__m256i const*)(keys + i));
+            _mm256_storeu_si256((__m256i*)(out + i), murmur2_final_avx2(murmur2_mix_avx2(h0, k, m), m));
+        }
+        return i;
+    }
+
+    CHASH_TARGET("avx2")
+    static u64 murmur2_u64_avx2(u64 const* keys, u32* out, u64 n, u32 seed)
+    {
+        __m256i const m  = _mm256_set1_epi32((int)MURMUR2_M);
+        __m256i const h0 = _mm256_set1_epi32((int)(seed ^ 8));
+        u64           i  = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            __m256i lo, hi;
+            split_u64_avx2(keys + i, lo, hi);
+            __m256i const h = murmur2_mix_avx2(murmur2_mix_avx2(h0, lo, m), hi, m);
+            _mm256_storeu_si256((__m256i*)(out + i), murmur2_final_avx2(h, m));
+        }
+        return i;
+    }
+
+    CHASH_TARGET("avx2")
+    static u64 murmur64b_u64_avx2(u64 const* keys, u64* out, u64 n, u64 seed)
+    {
+        __m256i const m   = _mm256_set1_epi32((int)MURMUR2_M);
+        __m256i const h10 = _mm256_set1_epi32((int)((u32)seed ^ 8));
+        __m256i const h20 = _mm256_set1_epi32((int)(u32)(seed >> 32));
+        __m256i const idx = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+        u64           i   = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            __m256i lo, hi;
+            split_u64_avx2(keys + i, lo, hi);
+            __m256i h1 = murmur2_mix_avx2(h10, lo, m);
+            __m256i h2 = murmur2_mix_avx2(h20, hi, m);
+            h1         = _mm256_mullo_epi32(_mm256_xor_si256(h1, _mm256_srli_epi32(h2, 18)), m);
+            h2         = _mm256_mullo_epi32(_mm256_xor_si256(h2, _mm256_srli_epi32(h1, 22)), m);
+            h1         = _mm256_mullo_epi32(_mm256_xor_si256(h1, _mm256_srli_epi32(h2, 17)), m);
+            h2         = _mm256_mullo_epi32(_mm256_xor_si256(h2, _mm256_srli_epi32(h1, 19)), m);
+
+            // Interleave back to (h1 << 32) | h2 per key
+            __m256i const a = _mm256_permutevar8x32_epi32(_mm256_permute2x128_si256(h2, h1, 0x20), idx);
+            __m256i const b = _mm256_permutevar8x32_epi32(_mm256_permute2x128_si256(h2, h1, 0x31), idx);
+            _mm256_storeu_si256((__m256i*)(out + i) + 0, a);
+            _mm256_storeu_si256((__m256i*)(out + i) + 1, b);
+        }
+        return i;
+    }
+
+    CHASH_TARGET("avx2")
+    static u64 xxh64_u32_avx2(u32 const* keys, u64* out, u64 n, u64 seed)
+    {
+        __m256i const h0 = BATCH_SET1_64(seed + XXH_PRIME64_5 + 4);
+        u64           i  = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            __m256i const k = _mm256_cvtepu32_epi64(_mm_loadu_si128((__m128i const*)(keys + i)));
+            // <k> fits in 32 bits, so k * PRIME_1 only needs two partial products
+            __m256i const kp = _mm256_add_epi64(_mm256_mul_epu32(k, BATCH_SET1_LO64(XXH_PRIME64_1)), _mm256_slli_epi64(_mm256_mul_epu32(k, BATCH_SET1_HI64(XXH_PRIME64_1)), 32));
+            __m256i       h  = _mm256_xor_si256(h0, kp);
+            h                = _mm256_add_epi64(mul64_avx2(rotl64_avx2(h, 23), BATCH_SET1_LO64(XXH_PRIME64_2), BATCH_SET1_HI64(XXH_PRIME64_2)), BATCH_SET1_64(XXH_PRIME64_3));
+            _mm256_storeu_si256((__m256i*)(out + i), xxh64_avalanche_avx2(h));
+        }
+        return i;
+    }
+
+    CHASH_TARGET("avx2")
+    static u64 fmix32_avx2(u32 const* keys, u32* out, u64 n, u32 seed)
+    {
+        __m256i const s  = _mm256_set1_epi32((int)seed);
+        __m256i const c1 = _mm256_set1_epi32((int)FMIX32_C1);
+        __m256i const c2 = _mm256_set1_epi32((int)FMIX32_C2);
+        u64           i  = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            __m256i h = _mm256_xor_si256(_mm256_loadu_si256((__m256i const*)(keys + i)), s);
+            h         = _mm256_mullo_epi32(_mm256_xor_si256(h, _mm256_srli_epi32(h, 16)), c1);
+            h         = _mm256_mullo_epi32(_mm256_xor_si256(h, _mm256_srli_epi32(h, 13)), c2);
+            h         = _mm256_xor_si256(h, _mm256_srli_epi32(h, 16));
+            _mm256_storeu_si256((__m256i*)(out + i), h);
+        }
+        return i;
+    }
+
+    CHASH_TARGET("avx2")
+    static u64 fmix64_avx2(u64 const* keys, u64* out, u64 n, u64 seed)
+    {
+        __m256i const s = BATCH_SET1_64(seed);
+        u64           i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            __m256i k = _mm256_xor_si256(_mm256_loadu_si256((__m256i const*)(keys + i)), s);
+            k         = mul64_avx2(_mm256_xor_si256(k, _mm256_srli_epi64(k, 33)), BATCH_SET1_LO64(FMIX64_C1), BATCH_SET1_HI64(FMIX64_C1));
+            k         = mul64_avx2(_mm256_xor_si256(k, _mm256_srli_epi64(k, 33)), BATCH_SET1_LO64(FMIX64_C2), BATCH_SET1_HI64(FMIX64_C2));
+            k         = _mm256_xor_si256(k, _mm256_srli_epi64(k, 33));
+            _mm256_storeu_si256((__m256i*)(out + i), k);
+        }
+        return i;
+    }
+
+#    undef BATCH_SET1_64
+#    undef BATCH_SET1_LO64
+#    undef BATCH_SET1_HI64
+
+#    define BATCH_AVX2(fn) \
+        if (nhash_cpu::has(nhash_cpu::AVX2)) \
+            i = fn(keys, out, n, seed);
+#else
+#    define BATCH_AVX2(fn)
+#endif
+
+    namespace nhash
+    {
+        void hash_murmur2_batch(u32 const* keys, u32* out, u64 n, u32 seed)
+        {
+            u64 i = 0;
+            BATCH_AVX2(murmur2_u32_avx2);
+            for (; i < n; ++i)
+                out[i] = murmur2_u32(keys[i], seed);
+        }
+
+        void hash_murmur2_batch(u64 const* keys, u32* out, u64 n, u32 seed)
+        {
+            u64 i = 0;
+            BATCH_AVX2(murmur2_u64_avx2);
+            for (; i < n; ++i)
+                out[i] = murmur2_u64(keys[i], seed);
+        }
+
+        void hash_murmur64b_batch(u64 const* keys, u64* out, u64 n, u64 seed)
+        {
+            u64 i = 0;
+            BATCH_AVX2(murmur64b_u64_avx2);
+            for (; i < n; ++i)
+                out[i] = murmur64b_u64(keys[i], seed);
+        }
+
+        void hash_xxhash64_batch(u32 const* keys, u64* out, u64 n, u64 seed)
+        {
+            u64 i = 0;
+            BATCH_AVX2(xxh64_u32_avx2);
+            for (; i < n; ++i)
+                out[i] = xxh64_u32(keys[i], seed);
+        }
+
+        // Five full 64-bit multiplies per key, emulating them with AVX2 is not faster than the scalar loop
+        void hash_xxhash64_batch(u64 const* keys, u64* out, u64 n, u64 seed)
+        {
+            for (u64 i = 0; i < n; ++i)
+                out[i] = xxh64_u64(keys[i], seed);
+        }
+
+        void hash_fmix32_batch(u32 const* keys, u32* out, u64 n, u32 seed)
+        {
+            u64 i = 0;
+            BATCH_AVX2(fmix32_avx2);
+            for (; i < n; ++i)
+                out[i] = fmix32(keys[i] ^ seed);
+        }
+
+        void hash_fmix64_batch(u64 const* keys, u64* out, u64 n, u64 seed)
+        {
+            u64 i = 0;
+            BATCH_AVX2(fmix64_avx2);
+            for (; i < n; ++i)
+                out[i] = fmix64(keys[i] ^ seed);
+        }
+    } // namespace nhash
+
+#undef BATCH_AVX2
+
+} // namespace ncore
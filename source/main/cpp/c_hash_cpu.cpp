@@ -0,0 +1,89 @@
+#include "ccore/c_target.h"
+
+#include "chash/private/c_hash_cpu.h"
+
+#if defined(CHASH_X64)
+#    if defined(_MSC_VER)
+#        include <intrin.h>
+#    else
+#        include <cpuid.h>
+#    endif
+#endif
+
+namespace ncore
+{
+    namespace nhash_cpu
+    {
+#if defined(CHASH_X64)
+        static void cpuid(u32 leaf, u32 subleaf, u32 regs[4])
+        {
+#    if defined(_MSC_VER)
+            int r[4];
+            __cpuidex(r, (int)leaf, (int)subleaf);
+            regs[0] = (u32)r[0];
+            regs[1] = (u32)r[1];
+            regs[2] = (u32)r[2];
+            regs[3] = (u32)r[3];
+#    else
+            __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#    endif
+        }
+
+        static u64 xgetbv0()
+        {
+#    if defined(_MSC_VER)
+            return _xgetbv(0);
+#    else
+            u32 lo, hi;
+            __asm__ __volatile__("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+            return ((u64)hi << 32) | lo;
+#    endif
+        }
+
+        static u32 detect()
+        {
+            u32 regs[4];
+            cpuid(0, 0, regs);
+            u32 const max_leaf = regs[0];
+
+            u32 f = 0;
+            cpuid(1, 0, regs);
+            if (regs[3] & (1 << 26))
+                f |= SSE2;
+            if (regs[2] & (1 << 9))
+                f |= SSSE3;
+            if (regs[2] & (1 << 19))
+                f |= SSE41;
+            if (regs[2] & (1 << 20))
+                f |= SSE42;
+            if (regs[2] & (1 << 1))
+                f |= PCLMUL;
+
+            // AVX2 also needs the OS to save the YMM registers on a context switch
+            bool const osxsave = (regs[2] & (1 << 27)) != 0;
+            bool const ymm     = osxsave && ((xgetbv0() & 0x6) == 0x6);
+            if (max_leaf >= 7)
+            {
+                cpuid(7, 0, regs);
+                if (ymm && (regs[1] & (1 << 5)))
+                    f |= AVX2;
+                if (regs[1] & (1 << 29))
+                    f |= SHA;
+            }
+            return f;
+        }
+#else
+        static u32 detect() { return 0; }
+#endif
+
+        static u32 s_disabled = 0;
+
+        u32 features()
+        {
+            static u32 const s_detected = detect();
+            return s_detected & ~s_disabled;
+        }
+
+        void disable(u32 features) { s_disabled = features; }
+    } // namespace nhash_cpu
+} // namespace ncore
@@ -0,0 +1,205 @@
+#include "ccore/c_target.h"
+#include "cbase/c_memory.h"
+
+#include "chash/private/c_hash_cpu.h"
+#include "chash/private/c_hash_multi.h"
+
+#if defined(CHASH_X64)
+#    include <immintrin.h>
+#endif
+
+namespace ncore
+{
+    namespace nhash_private
+    {
+        static const s32 LANES = multi_algo_t::LANES;
+
+        // With no messages waiting and this many lanes (or less) still busy, the remaining
+        // messages are finished one at a time with the single message block function.
+        static const s32 MULTI_DRAIN_LANES = 2;
+
+        static const u32 MULTI_IDLE = 0xFFFFFFFF;
+
+        struct multi_lane_t
+        {
+            u8 const* next;        // Next whole block of the message
+            u64       blocks;      // Whole blocks of the message left
+            u32       tail;        // Padded tail blocks left
+            u32       tail_blocks; // Padded tail blocks in total, 1 or 2
+            u32       msg;         // Index of the message, MULTI_IDLE when the lane is empty
+            u32       reserved;
+            u8        buffer[128]; // The last partial block, padding and length
+        };
+
+        static void multi_lane_start(multi_algo_t const& algo, multi_lane_t& lane, u8 const* data, u64 len, u32 msg)
+        {
+            lane.next   = data;
+            lane.blocks = len / 64;
+            lane.msg    = msg;
+
+            u32 const rest = (u32)(len & 63);
+            nmem::memclr(lane.buffer, sizeof(lane.buffer));
+            nmem::memcpy(lane.buffer, data + (len & ~(u64)63), rest);
+            lane.buffer[rest] = 0x80;
+            lane.tail_blocks  = (rest < 56) ? 1 : 2;
+            lane.tail         = lane.tail_blocks;
+
+            u64 const bits = len << 3;
+            u8*       p    = lane.buffer + lane.tail_blocks * 64 - 8;
+            for (s32 i = 0; i < 8; ++i)
+                p[i] = (u8)(bits >> (algo.length_be ? (56 - 8 * i) : (8 * i)));
+        }
+
+        static inline u8 const* multi_lane_block(multi_lane_t const& lane) { return lane.blocks != 0 ? lane.next : lane.buffer + (lane.tail_blocks - lane.tail) * 64; }
+
+        // Returns true when the message in the lane is done
+        static inline bool multi_lane_advance(multi_lane_t& lane)
+        {
+            if (lane.blocks != 0)
+            {
+                lane.next += 64;
+                lane.blocks--;
+            }
+            else
+            {
+                lane.tail--;
+            }
+            return lane.blocks == 0 && lane.tail == 0;
+        }
+
+        static void multi_lane_finish(multi_algo_t const& algo, multi_lane_t const& lane, u32* state, u8* digest)
+        {
+            algo.blocks(state, lane.next, (uint_t)lane.blocks);
+            algo.blocks(state, lane.buffer + (lane.tail_blocks - lane.tail) * 64, lane.tail);
+            algo.digest(state, digest);
+        }
+
+        // words[w][l] = word w of the block of lane l
+#if defined(CHASH_X64)
+        CHASH_TARGET("avx2")
+        static void multi_transpose(u8 const* const* blocks, u32 (*words)[LANES])
+        {
+            for (s32 half = 0; half < 2; ++half)
+            {
+                __m256i r[8];
+                for (s32 l = 0; l < 8; ++l)
+                    r[l] = _mm256_loadu_si256((__m256i const*)(blocks[l] + half * 32));
+
+                __m256i const t0 = _mm256_unpacklo_epi32(r[0], r[1]);
+                __m256i const t1 = _mm256_unpackhi_epi32(r[0], r[1]);
+                __m256i const t2 = _mm256_unpacklo_epi32(r[2], r[3]);
+                __m256i const t3 = _mm256_unpackhi_epi32(r[2], r[3]);
+                __m256i const t4 = _mm256_unpacklo_epi32(r[4], r[5]);
+                __m256i const t5 = _mm256_unpackhi_epi32(r[4], r[5]);
+                __m256i const t6 = _mm256_unpacklo_epi32(r[6], r[7]);
+                __m256i const t7 = _mm256_unpackhi_epi32(r[6], r[7]);
+
+                __m256i const u0 = _mm256_unpacklo_epi64(t0, t2);
+                __m256i const u1 = _mm256_unpackhi_epi64(t0, t2);
+                __m256i const u2 = _mm256_unpacklo_epi64(t1, t3);
+                __m256i const u3 = _mm256_unpackhi_epi64(t1, t3);
+                __m256i const u4 = _mm256_unpacklo_epi64(t4, t6);
+                __m256i const u5 = _mm256_unpackhi_epi64(t4, t6);
+                __m256i const u6 = _mm256_unpacklo_epi64(t5, t7);
+                __m256i const u7 = _mm256_unpackhi_epi64(t5, t7);
+
+                __m256i* out = (__m256i*)words[half * 8];
+                _mm256_storeu_si256(out + 0, _mm256_permute2x128_si256(u0, u4, 0x20));
+                _mm256_storeu_si256(out + 1, _mm256_permute2x128_si256(u1, u5, 0x20));
+                _mm256_storeu_si256(out + 2, _mm256_permute2x128_si256(u2, u6, 0x20));
+                _mm256_storeu_si256(out + 3, _mm256_permute2x128_si256(u3, u7, 0x20));
+                _mm256_storeu_si256(out + 4, _mm256_permute2x128_si256(u0, u4, 0x31));
+                _mm256_storeu_si256(out + 5, _mm256_permute2x128_si256(u1, u5, 0x31));
+                _mm256_storeu_si256(out + 6, _mm256_permute2x128_si256(u2, u6, 0x31));
+                _mm256_storeu_si256(out + 7, _mm256_permute2x128_si256(u3, u7, 0x31));
+            }
+        }
+#else
+        static void multi_transpose(u8 const* const* blocks, u32 (*words)[LANES])
+        {
+            for (s32 l = 0; l < LANES; ++l)
+                for (s32 w = 0; w < 16; ++w)
+                    nmem::memcpy(&words[w][l], blocks[l] + 4 * w, 4);
+        }
+#endif
+
+        void multi_buffer_hash(multi_algo_t const& algo, u8 const* const* data, u64 const* lens, u8* digests, u32 count)
+        {
+            multi_lane_t lane;
+            u32          state[8];
+
+            if (algo.lanes == nullptr)
+            {
+                for (u32 i = 0; i < count; ++i)
+                {
+                    multi_lane_start(algo, lane, data[i], lens[i], i);
+                    nmem::memcpy(state, algo.iv, algo.state_words * sizeof(u32));
+                    multi_lane_finish(algo, lane, state, digests + (u64)i * algo.digest_size);
+                }
+                return;
+            }
+
+            static const u8 s_idle_block[64] = {0};
+
+            multi_lane_t lanes[LANES];
+            u32          lane_state[8][LANES];
+            u32          words[16][LANES];
+            u8 const*    blocks[LANES];
+
+            u32 next   = 0;
+            s32 active = 0;
+            for (s32 l = 0; l < LANES; ++l)
+            {
+                lanes[l].msg = MULTI_IDLE;
+                if (next < count)
+                {
+                    multi_lane_start(algo, lanes[l], data[next], lens[next], next);
+                    for (s32 w = 0; w < algo.state_words; ++w)
+                        lane_state[w][l] = algo.iv[w];
+                    next++;
+                    active++;
+                }
+            }
+
+            while (active > MULTI_DRAIN_LANES || (active > 0 && next < count))
+            {
+                for (s32 l = 0; l < LANES; ++l)
+                    blocks[l] = (lanes[l].msg != MULTI_IDLE) ? multi_lane_block(lanes[l]) : s_idle_block;
+                multi_transpose(blocks, words);
+                algo.lanes(lane_state, words);
+
+                for (s32 l = 0; l < LANES; ++l)
+                {
+                    if (lanes[l].msg == MULTI_IDLE || !multi_lane_advance(lanes[l]))
+                        continue;
+
+                    for (s32 w = 0; w < algo.state_words; ++w)
+                        state[w] = lane_state[w][l];
+                    algo.digest(state, digests + (u64)lanes[l].msg * algo.digest_size);
+
+                    if (next < count)
+                    {
+                        multi_lane_start(algo, lanes[l], data[next], lens[next], next);
+                        for (s32 w = 0; w < algo.state_words; ++w)
+                            lane_state[w][l] = algo.iv[w];
+                        next++;
+                    }
+                    else
+                    {
+                        lanes[l].msg = MULTI_IDLE;
+                        active--;
+                    }
+                }
+            }
+
+            for (s32 l = 0; l < LANES; ++l)
+            {
+                if (lanes[l].msg == MULTI_IDLE)
+                    continue;
+                for (s32 w = 0; w < algo.state_words; ++w)
+                    state[w] = lane_state[w][l];
+                multi_lane_finish(algo, lanes[l], state, digests + (u64)lanes[l].msg * algo.digest_size);
+            }
+        }
+    } // namespace nhash_private
+} // namespace ncore
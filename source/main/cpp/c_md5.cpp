@@ -1,8 +1,16 @@
 #include "ccore/c_endian.h"
 #include "cbase/c_allocator.h"
 #include "cbase/c_memory.h"
+#include "chash/private/c_hash_cpu.h"
+#include "chash/private/c_hash_multi.h"
+#include "chash/c_hash.h"
+#include "chash/private/c_hash_load.h"
 #include "chash/private/c_internal_hash.h"
 
+#if defined(CHASH_X64)
+#    include <immintrin.h>
+#endif
+
 namespace ncore
 {
     //---------------------------------------------------------------------------------------------------------------------
@@ -28,16 +36,15 @@ namespace ncore
 
         DCORE_CLASS_PLACEMENT_NEW_DELETE
     private:
-        void transform();
+        void transform(u8 const* blocks, uint_t nblocks);
 
-        u32 mMD5[4]; ///< 128 bits MD5 hash value
+        u32 mMD5[4];  ///< 128 bits MD5 hash value
+        u64 mLength;  ///< Total length of the message in bytes
         u32 mState;
-        u32 mLength;
 
         struct ctx_t
         {
-            u32 mInput[16]; ///< 64 byte input buffer
-            u8  mSlack[8];  ///< Slack space because internal memcopy copies gready (i.e. up to 7 bytes past mInput)
+            u32 mInput[16]; ///< 64 byte input buffer, the message bytes of a partial block
         };
         ctx_t mBuffer;
     };
@@ -87,19 +94,12 @@ namespace ncore
         * 			under a public-key cryptosystem such as RSA or PGP.
         */
 
-    /**
-     * @brief		Byteswap an area of memory
-
-        * 			This area converts a number of u32's to little endian format to be compatible
-        * 			with the MD5 hash algorithm.
-
-        * @param		ioBuffer	Pointer to data to swap
-        * @param		inLength	Number of u32's to swap
-        */
-    static void sByteSwap(u32* ioBuffer, s32 inLength)
+    static inline void sWrite32(u8* p, u32 v)
     {
-        for (s32 i = 0; i < inLength; i++)
-            ioBuffer[i] = nendian::read_u32((u8 const*)&ioBuffer[i]);
+        p[0] = (u8)v;
+        p[1] = (u8)(v >> 8);
+        p[2] = (u8)(v >> 16);
+        p[3] = (u8)(v >> 24);
     }
 
     /**
@@ -112,8 +112,8 @@ namespace ncore
         * @see		Update GetHash
         */
     md5_ctx_t::md5_ctx_t()
-        : mState(md5_ctx_t::CLOSED)
-        , mLength(0)
+        : mLength(0)
+        , mState(md5_ctx_t::CLOSED)
     {
     }
 
@@ -132,11 +132,11 @@ namespace ncore
         ASSERTS(mState == OPEN, "Can't compute hash value before Open() has been called!");
 
         // Calculate current offset in buffer and bytes left
-        u32 buffer_offset = (mLength & 63);     // Current offset in buffer
-        u32 space_left    = 64 - buffer_offset; // Space available in mBuffer.mInput (at least 1)
+        u32 buffer_offset = (u32)(mLength & 63); // Current offset in buffer
+        u32 space_left    = 64 - buffer_offset;  // Space available in mBuffer.mInput (at least 1)
 
         // Update length
-        u32 const len = (u32)(end - begin);
+        u64 const len = (u64)(end - begin);
         mLength += len;
 
         // If there's enough space in the buffer, just copy and exit
@@ -146,27 +146,25 @@ namespace ncore
             return;
         }
 
-        // Fill up current buffer until it's full
         u8 const* data   = (u8 const*)begin;
-        u32       length = len;
-        nmem::memcpy((u8*)mBuffer.mInput + buffer_offset, data, space_left);
-        sByteSwap(mBuffer.mInput, 16);
-        transform();
-        data += space_left;
-        length -= space_left;
-
-        // Process data in 64-byte chunks
-        while (length >= 64)
+        u64       length = len;
+
+        // Only a partial block from an earlier update goes through the buffer
+        if (buffer_offset != 0)
         {
-            nmem::memcpy((u64*)mBuffer.mInput, (u64*)data, 64);
-            sByteSwap(mBuffer.mInput, 16);
-            transform();
-            data += 64;
-            length -= 64;
+            nmem::memcpy((u8*)mBuffer.mInput + buffer_offset, data, space_left);
+            transform((u8 const*)mBuffer.mInput, 1);
+            data += space_left;
+            length -= space_left;
         }
 
+        // Whole 64-byte blocks are transformed straight from the input
+        transform(data, (uint_t)(length / 64));
+        data += length & ~63;
+        length &= 63;
+
         // Handle any remaining bytes of data
-        nmem::memcpy(mBuffer.mInput, data, length);
+        nmem::memcpy(mBuffer.mInput, data, (u32)length);
     }
 
     /**
@@ -177,7 +175,7 @@ namespace ncore
         // If this is the first time we call GetHash(), finish the last transform
         if (mState == OPEN)
         {
-            u32 count = mLength & 63; // Number of bytes in mBuffer.mInput
+            s32 count = (s32)(mLength & 63); // Number of bytes in mBuffer.mInput
             u8* p     = (u8*)mBuffer.mInput + count;
 
             // Set the first char of padding to 0x80.  There is always room.
@@ -190,20 +188,18 @@ namespace ncore
             if (count < 0)
             {
                 nmem::memclr(p, count + 8);
-                sByteSwap(mBuffer.mInput, 16);
-                transform();
+                transform((u8 const*)mBuffer.mInput, 1);
                 p     = (u8*)mBuffer.mInput;
                 count = 56;
             }
             nmem::memclr(p, count);
-            sByteSwap(mBuffer.mInput, 14);
 
             // Append length of message in bits
-            mBuffer.mInput[14] = (u32)(mLength << 3);
-            mBuffer.mInput[15] = (u32)(mLength >> 29);
+            sWrite32((u8*)&mBuffer.mInput[14], (u32)(mLength << 3));
+            sWrite32((u8*)&mBuffer.mInput[15], (u32)(mLength >> 29));
 
             // Final transform
-            transform();
+            transform((u8 const*)mBuffer.mInput, 1);
 
             mState = CLOSED;
         }
@@ -239,90 +235,226 @@ namespace ncore
      * The core of the MD5 algorithm, this alters an existing MD5 hash to
      * reflect the addition of 16 longwords of new data.  MD5Update blocks
      * the data and converts bytes into longwords for this routine.
+     *
+     * @param md5	The 4 word hash value to update
+     * @param block	64 byte block, 16 little-endian message words
      */
-    void md5_ctx_t::transform()
+#define MD5IN(i) nhash_private::load_le32(block + 4 * (i))
+    static void sTransform(u32* md5, u8 const* block)
+    {
+        u32 a = md5[0];
+        u32 b = md5[1];
+        u32 c = md5[2];
+        u32 d = md5[3];
+
+        MD5STEP(MD5F1, a, b, c, d, MD5IN(0) + 0xd76aa478, 7);
+        MD5STEP(MD5F1, d, a, b, c, MD5IN(1) + 0xe8c7b756, 12);
+        MD5STEP(MD5F1, c, d, a, b, MD5IN(2) + 0x242070db, 17);
+        MD5STEP(MD5F1, b, c, d, a, MD5IN(3) + 0xc1bdceee, 22);
+        MD5STEP(MD5F1, a, b, c, d, MD5IN(4) + 0xf57c0faf, 7);
+        MD5STEP(MD5F1, d, a, b, c, MD5IN(5) + 0x4787c62a, 12);
+        MD5STEP(MD5F1, c, d, a, b, MD5IN(6) + 0xa8304613, 17);
+        MD5STEP(MD5F1, b, c, d, a, MD5IN(7) + 0xfd469501, 22);
+        MD5STEP(MD5F1, a, b, c, d, MD5IN(8) + 0x698098d8, 7);
+        MD5STEP(MD5F1, d, a, b, c, MD5IN(9) + 0x8b44f7af, 12);
+        MD5STEP(MD5F1, c, d, a, b, MD5IN(10) + 0xffff5bb1, 17);
+        MD5STEP(MD5F1, b, c, d, a, MD5IN(11) + 0x895cd7be, 22);
+        MD5STEP(MD5F1, a, b, c, d, MD5IN(12) + 0x6b901122, 7);
+        MD5STEP(MD5F1, d, a, b, c, MD5IN(13) + 0xfd987193, 12);
+        MD5STEP(MD5F1, c, d, a, b, MD5IN(14) + 0xa679438e, 17);
+        MD5STEP(MD5F1, b, c, d, a, MD5IN(15) + 0x49b40821, 22);
+
+        MD5STEP(MD5F2, a, b, c, d, MD5IN(1) + 0xf61e2562, 5);
+        MD5STEP(MD5F2, d, a, b, c, MD5IN(6) + 0xc040b340, 9);
+        MD5STEP(MD5F2, c, d, a, b, MD5IN(11) + 0x265e5a51, 14);
+        MD5STEP(MD5F2, b, c, d, a, MD5IN(0) + 0xe9b6c7aa, 20);
+        MD5STEP(MD5F2, a, b, c, d, MD5IN(5) + 0xd62f105d, 5);
+        MD5STEP(MD5F2, d, a, b, c, MD5IN(10) + 0x02441453, 9);
+        MD5STEP(MD5F2, c, d, a, b, MD5IN(15) + 0xd8a1e681, 14);
+        MD5STEP(MD5F2, b, c, d, a, MD5IN(4) + 0xe7d3fbc8, 20);
+        MD5STEP(MD5F2, a, b, c, d, MD5IN(9) + 0x21e1cde6, 5);
+        MD5STEP(MD5F2, d, a, b, c, MD5IN(14) + 0xc33707d6, 9);
+        MD5STEP(MD5F2, c, d, a, b, MD5IN(3) + 0xf4d50d87, 14);
+        MD5STEP(MD5F2, b, c, d, a, MD5IN(8) + 0x455a14ed, 20);
+        MD5STEP(MD5F2, a, b, c, d, MD5IN(13) + 0xa9e3e905, 5);
+        MD5STEP(MD5F2, d, a, b, c, MD5IN(2) + 0xfcefa3f8, 9);
+        MD5STEP(MD5F2, c, d, a, b, MD5IN(7) + 0x676f02d9, 14);
+        MD5STEP(MD5F2, b, c, d, a, MD5IN(12) + 0x8d2a4c8a, 20);
+
+        MD5STEP(MD5F3, a, b, c, d, MD5IN(5) + 0xfffa3942, 4);
+        MD5STEP(MD5F3, d, a, b, c, MD5IN(8) + 0x8771f681, 11);
+        MD5STEP(MD5F3, c, d, a, b, MD5IN(11) + 0x6d9d6122, 16);
+        MD5STEP(MD5F3, b, c, d, a, MD5IN(14) + 0xfde5380c, 23);
+        MD5STEP(MD5F3, a, b, c, d, MD5IN(1) + 0xa4beea44, 4);
+        MD5STEP(MD5F3, d, a, b, c, MD5IN(4) + 0x4bdecfa9, 11);
+        MD5STEP(MD5F3, c, d, a, b, MD5IN(7) + 0xf6bb4b60, 16);
+        MD5STEP(MD5F3, b, c, d, a, MD5IN(10) + 0xbebfbc70, 23);
+        MD5STEP(MD5F3, a, b, c, d, MD5IN(13) + 0x289b7ec6, 4);
+        MD5STEP(MD5F3, d, a, b, c, MD5IN(0) + 0xeaa127fa, 11);
+        MD5STEP(MD5F3, c, d, a, b, MD5IN(3) + 0xd4ef3085, 16);
+        MD5STEP(MD5F3, b, c, d, a, MD5IN(6) + 0x04881d05, 23);
+        MD5STEP(MD5F3, a, b, c, d, MD5IN(9) + 0xd9d4d039, 4);
+        MD5STEP(MD5F3, d, a, b, c, MD5IN(12) + 0xe6db99e5, 11);
+        MD5STEP(MD5F3, c, d, a, b, MD5IN(15) + 0x1fa27cf8, 16);
+        MD5STEP(MD5F3, b, c, d, a, MD5IN(2) + 0xc4ac5665, 23);
+
+        MD5STEP(MD5F4, a, b, c, d, MD5IN(0) + 0xf4292244, 6);
+        MD5STEP(MD5F4, d, a, b, c, MD5IN(7) + 0x432aff97, 10);
+        MD5STEP(MD5F4, c, d, a, b, MD5IN(14) + 0xab9423a7, 15);
+        MD5STEP(MD5F4, b, c, d, a, MD5IN(5) + 0xfc93a039, 21);
+        MD5STEP(MD5F4, a, b, c, d, MD5IN(12) + 0x655b59c3, 6);
+        MD5STEP(MD5F4, d, a, b, c, MD5IN(3) + 0x8f0ccc92, 10);
+        MD5STEP(MD5F4, c, d, a, b, MD5IN(10) + 0xffeff47d, 15);
+        MD5STEP(MD5F4, b, c, d, a, MD5IN(1) + 0x85845dd1, 21);
+        MD5STEP(MD5F4, a, b, c, d, MD5IN(8) + 0x6fa87e4f, 6);
+        MD5STEP(MD5F4, d, a, b, c, MD5IN(15) + 0xfe2ce6e0, 10);
+        MD5STEP(MD5F4, c, d, a, b, MD5IN(6) + 0xa3014314, 15);
+        MD5STEP(MD5F4, b, c, d, a, MD5IN(13) + 0x4e0811a1, 21);
+        MD5STEP(MD5F4, a, b, c, d, MD5IN(4) + 0xf7537e82, 6);
+        MD5STEP(MD5F4, d, a, b, c, MD5IN(11) + 0xbd3af235, 10);
+        MD5STEP(MD5F4, c, d, a, b, MD5IN(2) + 0x2ad7d2bb, 15);
+        MD5STEP(MD5F4, b, c, d, a, MD5IN(9) + 0xeb86d391, 21);
+
+        md5[0] += a;
+        md5[1] += b;
+        md5[2] += c;
+        md5[3] += d;
+    }
+#undef MD5IN
+
+    //---------------------------------------------------------------------------------------------------------------------
+    //	Multi-buffer
+    //---------------------------------------------------------------------------------------------------------------------
+
+    static void sBlocks(u32* md5, u8 const* blocks, uint_t nblocks)
     {
-        u32 a = mMD5[0];
-        u32 b = mMD5[1];
-        u32 c = mMD5[2];
-        u32 d = mMD5[3];
-
-        MD5STEP(MD5F1, a, b, c, d, mBuffer.mInput[0] + 0xd76aa478, 7);
-        MD5STEP(MD5F1, d, a, b, c, mBuffer.mInput[1] + 0xe8c7b756, 12);
-        MD5STEP(MD5F1, c, d, a, b, mBuffer.mInput[2] + 0x242070db, 17);
-        MD5STEP(MD5F1, b, c, d, a, mBuffer.mInput[3] + 0xc1bdceee, 22);
-        MD5STEP(MD5F1, a, b, c, d, mBuffer.mInput[4] + 0xf57c0faf, 7);
-        MD5STEP(MD5F1, d, a, b, c, mBuffer.mInput[5] + 0x4787c62a, 12);
-        MD5STEP(MD5F1, c, d, a, b, mBuffer.mInput[6] + 0xa8304613, 17);
-        MD5STEP(MD5F1, b, c, d, a, mBuffer.mInput[7] + 0xfd469501, 22);
-        MD5STEP(MD5F1, a, b, c, d, mBuffer.mInput[8] + 0x698098d8, 7);
-        MD5STEP(MD5F1, d, a, b, c, mBuffer.mInput[9] + 0x8b44f7af, 12);
-        MD5STEP(MD5F1, c, d, a, b, mBuffer.mInput[10] + 0xffff5bb1, 17);
-        MD5STEP(MD5F1, b, c, d, a, mBuffer.mInput[11] + 0x895cd7be, 22);
-        MD5STEP(MD5F1, a, b, c, d, mBuffer.mInput[12] + 0x6b901122, 7);
-        MD5STEP(MD5F1, d, a, b, c, mBuffer.mInput[13] + 0xfd987193, 12);
-        MD5STEP(MD5F1, c, d, a, b, mBuffer.mInput[14] + 0xa679438e, 17);
-        MD5STEP(MD5F1, b, c, d, a, mBuffer.mInput[15] + 0x49b40821, 22);
-
-        MD5STEP(MD5F2, a, b, c, d, mBuffer.mInput[1] + 0xf61e2562, 5);
-        MD5STEP(MD5F2, d, a, b, c, mBuffer.mInput[6] + 0xc040b340, 9);
-        MD5STEP(MD5F2, c, d, a, b, mBuffer.mInput[11] + 0x265e5a51, 14);
-        MD5STEP(MD5F2, b, c, d, a, mBuffer.mInput[0] + 0xe9b6c7aa, 20);
-        MD5STEP(MD5F2, a, b, c, d, mBuffer.mInput[5] + 0xd62f105d, 5);
-        MD5STEP(MD5F2, d, a, b, c, mBuffer.mInput[10] + 0x02441453, 9);
-        MD5STEP(MD5F2, c, d, a, b, mBuffer.mInput[15] + 0xd8a1e681, 14);
-        MD5STEP(MD5F2, b, c, d, a, mBuffer.mInput[4] + 0xe7d3fbc8, 20);
-        MD5STEP(MD5F2, a, b, c, d, mBuffer.mInput[9] + 0x21e1cde6, 5);
-        MD5STEP(MD5F2, d, a, b, c, mBuffer.mInput[14] + 0xc33707d6, 9);
-        MD5STEP(MD5F2, c, d, a, b, mBuffer.mInput[3] + 0xf4d50d87, 14);
-        MD5STEP(MD5F2, b, c, d, a, mBuffer.mInput[8] + 0x455a14ed, 20);
-        MD5STEP(MD5F2, a, b, c, d, mBuffer.mInput[13] + 0xa9e3e905, 5);
-        MD5STEP(MD5F2, d, a, b, c, mBuffer.mInput[2] + 0xfcefa3f8, 9);
-        MD5STEP(MD5F2, c, d, a, b, mBuffer.mInput[7] + 0x676f02d9, 14);
-        MD5STEP(MD5F2, b, c, d, a, mBuffer.mInput[12] + 0x8d2a4c8a, 20);
-
-        MD5STEP(MD5F3, a, b, c, d, mBuffer.mInput[5] + 0xfffa3942, 4);
-        MD5STEP(MD5F3, d, a, b, c, mBuffer.mInput[8] + 0x8771f681, 11);
-        MD5STEP(MD5F3, c, d, a, b, mBuffer.mInput[11] + 0x6d9d6122, 16);
-        MD5STEP(MD5F3, b, c, d, a, mBuffer.mInput[14] + 0xfde5380c, 23);
-        MD5STEP(MD5F3, a, b, c, d, mBuffer.mInput[1] + 0xa4beea44, 4);
-        MD5STEP(MD5F3, d, a, b, c, mBuffer.mInput[4] + 0x4bdecfa9, 11);
-        MD5STEP(MD5F3, c, d, a, b, mBuffer.mInput[7] + 0xf6bb4b60, 16);
-        MD5STEP(MD5F3, b, c, d, a, mBuffer.mInput[10] + 0xbebfbc70, 23);
-        MD5STEP(MD5F3, a, b, c, d, mBuffer.mInput[13] + 0x289b7ec6, 4);
-        MD5STEP(MD5F3, d, a, b, c, mBuffer.mInput[0] + 0xeaa127fa, 11);
-        MD5STEP(MD5F3, c, d, a, b, mBuffer.mInput[3] + 0xd4ef3085, 16);
-        MD5STEP(MD5F3, b, c, d, a, mBuffer.mInput[6] + 0x04881d05, 23);
-        MD5STEP(MD5F3, a, b, c, d, mBuffer.mInput[9] + 0xd9d4d039, 4);
-        MD5STEP(MD5F3, d, a, b, c, mBuffer.mInput[12] + 0xe6db99e5, 11);
-        MD5STEP(MD5F3, c, d, a, b, mBuffer.mInput[15] + 0x1fa27cf8, 16);
-        MD5STEP(MD5F3, b, c, d, a, mBuffer.mInput[2] + 0xc4ac5665, 23);
-
-        MD5STEP(MD5F4, a, b, c, d, mBuffer.mInput[0] + 0xf4292244, 6);
-        MD5STEP(MD5F4, d, a, b, c, mBuffer.mInput[7] + 0x432aff97, 10);
-        MD5STEP(MD5F4, c, d, a, b, mBuffer.mInput[14] + 0xab9423a7, 15);
-        MD5STEP(MD5F4, b, c, d, a, mBuffer.mInput[5] + 0xfc93a039, 21);
-        MD5STEP(MD5F4, a, b, c, d, mBuffer.mInput[12] + 0x655b59c3, 6);
-        MD5STEP(MD5F4, d, a, b, c, mBuffer.mInput[3] + 0x8f0ccc92, 10);
-        MD5STEP(MD5F4, c, d, a, b, mBuffer.mInput[10] + 0xffeff47d, 15);
-        MD5STEP(MD5F4, b, c, d, a, mBuffer.mInput[1] + 0x85845dd1, 21);
-        MD5STEP(MD5F4, a, b, c, d, mBuffer.mInput[8] + 0x6fa87e4f, 6);
-        MD5STEP(MD5F4, d, a, b, c, mBuffer.mInput[15] + 0xfe2ce6e0, 10);
-        MD5STEP(MD5F4, c, d, a, b, mBuffer.mInput[6] + 0xa3014314, 15);
-        MD5STEP(MD5F4, b, c, d, a, mBuffer.mInput[13] + 0x4e0811a1, 21);
-        MD5STEP(MD5F4, a, b, c, d, mBuffer.mInput[4] + 0xf7537e82, 6);
-        MD5STEP(MD5F4, d, a, b, c, mBuffer.mInput[11] + 0xbd3af235, 10);
-        MD5STEP(MD5F4, c, d, a, b, mBuffer.mInput[2] + 0x2ad7d2bb, 15);
-        MD5STEP(MD5F4, b, c, d, a, mBuffer.mInput[9] + 0xeb86d391, 21);
-
-        mMD5[0] += a;
-        mMD5[1] += b;
-        mMD5[2] += c;
-        mMD5[3] += d;
+        for (uint_t i = 0; i < nblocks; ++i, blocks += 64)
+            sTransform(md5, blocks);
     }
 
+    void md5_ctx_t::transform(u8 const* blocks, uint_t nblocks) { sBlocks(mMD5, blocks, nblocks); }
+
+    static void sDigest(u32 const* md5, u8* digest)
+    {
+        u8 const* src = (u8 const*)&md5[0];
+        for (s32 i = 0; i < 16; ++i)
+            digest[i] = src[i];
+    }
+
+#if defined(CHASH_X64)
+#    define MD5F1_X8(x, y, z) _mm256_xor_si256(z, _mm256_and_si256(x, _mm256_xor_si256(y, z)))
+#    define MD5F2_X8(x, y, z) MD5F1_X8(z, x, y)
+#    define MD5F3_X8(x, y, z) _mm256_xor_si256(_mm256_xor_si256(x, y), z)
+#    define MD5F4_X8(x, y, z) _mm256_xor_si256(y, _mm256_or_si256(x, _mm256_xor_si256(z, ones)))
+#    define MD5STEP_X8(f, w, x, y, z, in, k, s)                                                   \
+        w = _mm256_add_epi32(w, _mm256_add_epi32(f(x, y, z), _mm256_add_epi32(in, _mm256_set1_epi32((int)k)))); \
+        w = _mm256_add_epi32(_mm256_or_si256(_mm256_slli_epi32(w, s), _mm256_srli_epi32(w, 32 - s)), x)
+
+    // sTransform on 8 messages at once, one per 32-bit lane
+    CHASH_TARGET("avx2")
+    static void sTransformX8(u32 (*md5)[8], u32 const (*words)[8])
+    {
+        __m256i const ones = _mm256_set1_epi32(-1);
+
+        __m256i in[16];
+        for (s32 i = 0; i < 16; ++i)
+            in[i] = _mm256_loadu_si256((__m256i const*)words[i]);
+
+        __m256i a = _mm256_loadu_si256((__m256i const*)md5[0]);
+        __m256i b = _mm256_loadu_si256((__m256i const*)md5[1]);
+        __m256i c = _mm256_loadu_si256((__m256i const*)md5[2]);
+        __m256i d = _mm256_loadu_si256((__m256i const*)md5[3]);
+        __m256i const a0 = a;
+        __m256i const b0 = b;
+        __m256i const c0 = c;
+        __m256i const d0 = d;
+
+        MD5STEP_X8(MD5F1_X8, a, b, c, d, in[0], 0xd76aa478, 7);
+        MD5STEP_X8(MD5F1_X8, d, a, b, c, in[1], 0xe8c7b756, 12);
+        MD5STEP_X8(MD5F1_X8, c, d, a, b, in[2], 0x242070db, 17);
+        MD5STEP_X8(MD5F1_X8, b, c, d, a, in[3], 0xc1bdceee, 22);
+        MD5STEP_X8(MD5F1_X8, a, b, c, d, in[4], 0xf57c0faf, 7);
+        MD5STEP_X8(MD5F1_X8, d, a, b, c, in[5], 0x4787c62a, 12);
+        MD5STEP_X8(MD5F1_X8, c, d, a, b, in[6], 0xa8304613, 17);
+        MD5STEP_X8(MD5F1_X8, b, c, d, a, in[7], 0xfd469501, 22);
+        MD5STEP_X8(MD5F1_X8, a, b, c, d, in[8], 0x698098d8, 7);
+        MD5STEP_X8(MD5F1_X8, d, a, b, c, in[9], 0x8b44f7af, 12);
+        MD5STEP_X8(MD5F1_X8, c, d, a, b, in[10], 0xffff5bb1, 17);
+        MD5STEP_X8(MD5F1_X8, b, c, d, a, in[11], 0x895cd7be, 22);
+        MD5STEP_X8(MD5F1_X8, a, b, c, d, in[12], 0x6b901122, 7);
+        MD5STEP_X8(MD5F1_X8, d, a, b, c, in[13], 0xfd987193, 12);
+        MD5STEP_X8(MD5F1_X8, c, d, a, b, in[14], 0xa679438e, 17);
+        MD5STEP_X8(MD5F1_X8, b, c, d, a, in[15], 0x49b40821, 22);
+
+        MD5STEP_X8(MD5F2_X8, a, b, c, d, in[1], 0xf61e2562, 5);
+        MD5STEP_X8(MD5F2_X8, d, a, b, c, in[6], 0xc040b340, 9);
+        MD5STEP_X8(MD5F2_X8, c, d, a, b, in[11], 0x265e5a51, 14);
+        MD5STEP_X8(MD5F2_X8, b, c, d, a, in[0], 0xe9b6c7aa, 20);
+        MD5STEP_X8(MD5F2_X8, a, b, c, d, in[5], 0xd62f105d, 5);
+        MD5STEP_X8(MD5F2_X8, d, a, b, c, in[10], 0x02441453, 9);
+        MD5STEP_X8(MD5F2_X8, c, d, a, b, in[15], 0xd8a1e681, 14);
+        MD5STEP_X8(MD5F2_X8, b, c, d, a, in[4], 0xe7d3fbc8, 20);
+        MD5STEP_X8(MD5F2_X8, a, b, c, d, in[9], 0x21e1cde6, 5);
+        MD5STEP_X8(MD5F2_X8, d, a, b, c, in[14], 0xc33707d6, 9);
+        MD5STEP_X8(MD5F2_X8, c, d, a, b, in[3], 0xf4d50d87, 14);
+        MD5STEP_X8(MD5F2_X8, b, c, d, a, in[8], 0x455a14ed, 20);
+        MD5STEP_X8(MD5F2_X8, a, b, c, d, in[13], 0xa9e3e905, 5);
+        MD5STEP_X8(MD5F2_X8, d, a, b, c, in[2], 0xfcefa3f8, 9);
+        MD5STEP_X8(MD5F2_X8, c, d, a, b, in[7], 0x676f02d9, 14);
+        MD5STEP_X8(MD5F2_X8, b, c, d, a, in[12], 0x8d2a4c8a, 20);
+
+        MD5STEP_X8(MD5F3_X8, a, b, c, d, in[5], 0xfffa3942, 4);
+        MD5STEP_X8(MD5F3_X8, d, a, b, c, in[8], 0x8771f681, 11);
+        MD5STEP_X8(MD5F3_X8, c, d, a, b, in[11], 0x6d9d6122, 16);
+        MD5STEP_X8(MD5F3_X8, b, c, d, a, in[14], 0xfde5380c, 23);
+        MD5STEP_X8(MD5F3_X8, a, b, c, d, in[1], 0xa4beea44, 4);
+        MD5STEP_X8(MD5F3_X8, d, a, b, c, in[4], 0x4bdecfa9, 11);
+        MD5STEP_X8(MD5F3_X8, c, d, a, b, in[7], 0xf6bb4b60, 16);
+        MD5STEP_X8(MD5F3_X8, b, c, d, a, in[10], 0xbebfbc70, 23);
+        MD5STEP_X8(MD5F3_X8, a, b, c, d, in[13], 0x289b7ec6, 4);
+        MD5STEP_X8(MD5F3_X8, d, a, b, c, in[0], 0xeaa127fa, 11);
+        MD5STEP_X8(MD5F3_X8, c, d, a, b, in[3], 0xd4ef3085, 16);
+        MD5STEP_X8(MD5F3_X8, b, c, d, a, in[6], 0x04881d05, 23);
+        MD5STEP_X8(MD5F3_X8, a, b, c, d, in[9], 0xd9d4d039, 4);
+        MD5STEP_X8(MD5F3_X8, d, a, b, c, in[12], 0xe6db99e5, 11);
+        MD5STEP_X8(MD5F3_X8, c, d, a, b, in[15], 0x1fa27cf8, 16);
+        MD5STEP_X8(MD5F3_X8, b, c, d, a, in[2], 0xc4ac5665, 23);
+
+        MD5STEP_X8(MD5F4_X8, a, b, c, d, in[0], 0xf4292244, 6);
+        MD5STEP_X8(MD5F4_X8, d, a, b, c, in[7], 0x432aff97, 10);
+        MD5STEP_X8(MD5F4_X8, c, d, a, b, in[14], 0xab9423a7, 15);
+        MD5STEP_X8(MD5F4_X8, b, c, d, a, in[5], 0xfc93a039, 21);
+        MD5STEP_X8(MD5F4_X8, a, b, c, d, in[12], 0x655b59c3, 6);
+        MD5STEP_X8(MD5F4_X8, d, a, b, c, in[3], 0x8f0ccc92, 10);
+        MD5STEP_X8(MD5F4_X8, c, d, a, b, in[10], 0xffeff47d, 15);
+        MD5STEP_X8(MD5F4_X8, b, c, d, a, in[1], 0x85845dd1, 21);
+        MD5STEP_X8(MD5F4_X8, a, b, c, d, in[8], 0x6fa87e4f, 6);
+        MD5STEP_X8(MD5F4_X8, d, a, b, c, in[15], 0xfe2ce6e0, 10);
+        MD5STEP_X8(MD5F4_X8, c, d, a, b, in[6], 0xa3014314, 15);
+        MD5STEP_X8(MD5F4_X8, b, c, d, a, in[13], 0x4e0811a1, 21);
+        MD5STEP_X8(MD5F4_X8, a, b, c, d, in[4], 0xf7537e82, 6);
+        MD5STEP_X8(MD5F4_X8, d, a, b, c, in[11], 0xbd3af235, 10);
+        MD5STEP_X8(MD5F4_X8, c, d, a, b, in[2], 0x2ad7d2bb, 15);
+        MD5STEP_X8(MD5F4_X8, b, c, d, a, in[9], 0xeb86d391, 21);
+
+        _mm256_storeu_si256((__m256i*)md5[0], _mm256_add_epi32(a, a0));
+        _mm256_storeu_si256((__m256i*)md5[1], _mm256_add_epi32(b, b0));
+        _mm256_storeu_si256((__m256i*)md5[2], _mm256_add_epi32(c, c0));
+        _mm256_storeu_si256((__m256i*)md5[3], _mm256_add_epi32(d, d0));
+    }
+
+#    undef MD5STEP_X8
+#    undef MD5F1_X8
+#    undef MD5F2_X8
+#    undef MD5F3_X8
+#    undef MD5F4_X8
+#endif
+
+
     namespace nhash_private
     {
+        static_assert(sizeof(md5_ctx_t) <= sizeof(md5_t::m_ctxt), "md5_t context too small");
+
         void md5_t::reset(u64 seed)
         {
             md5_ctx_t* ctx = (md5_ctx_t*)&this->m_ctxt;
@@ -341,4 +473,51 @@ namespace ncore
             ctx->digest(out_hash);
         }
     } // namespace nhash_private
+
+    namespace nhash
+    {
+        md5 hash_md5(u8 const* data, u64 len)
+        {
+            u32       state[4] = {0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476};
+            u64 const length   = len;
+
+            // Whole blocks are transformed straight from the input
+            sBlocks(state, data, (uint_t)(len / 64));
+            data += len & ~(u64)63;
+            len &= 63;
+
+            // The tail, padding and message length take one or two blocks
+            u8 tail[128];
+            nmem::memclr(tail, sizeof(tail));
+            nmem::memcpy(tail, data, (u32)len);
+            tail[len]         = 0x80;
+            u32 const nblocks = (len < 56) ? 1 : 2;
+            sWrite32(tail + nblocks * 64 - 8, (u32)(length << 3));
+            sWrite32(tail + nblocks * 64 - 4, (u32)(length >> 29));
+            sBlocks(state, tail, nblocks);
+
+            md5 digest;
+            sDigest(state, digest.m_data);
+            return digest;
+        }
+
+        void hash_md5_multi(u8 const* const* data, u64 const* lens, md5* digests, u32 count)
+        {
+            static u32 const iv[4] = {0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476};
+
+            nhash_private::multi_algo_t algo;
+            algo.iv          = iv;
+            algo.state_words = 4;
+            algo.digest_size = sizeof(md5);
+            algo.length_be   = false;
+            algo.blocks      = sBlocks;
+            algo.lanes       = nullptr;
+            algo.digest      = sDigest;
+#if defined(CHASH_X64) && defined(D_LITTLE_ENDIAN)
+            if (nhash_cpu::has(nhash_cpu::AVX2))
+                algo.lanes = sTransformX8;
+#endif
+            nhash_private::multi_buffer_hash(algo, data, lens, (u8*)digests, count);
+        }
+    } // namespace nhash
 } // namespace ncore
@@ -0,0 +1,299 @@
+#include "ccore/c_target.h"
+#include "cbase/c_memory.h"
+
+#include "chash/c_hash.h"
+#include "chash/private/c_hash_load.h"
+#include "chash/private/c_hash_mix.h"
+#include "chash/private/c_internal_hash.h"
+
+namespace ncore
+{
+    // MurmurHash3 by Austin Appleby (public domain), see https://github.com/aappleby/smhasher
+    static constexpr u32 MURMUR3_32_C1  = 0xcc9e2d51U;
+    static constexpr u32 MURMUR3_32_C2  = 0x1b873593U;
+    static constexpr u64 MURMUR3_128_C1 = 0x87c37b91114253d5ULL;
+    static constexpr u64 MURMUR3_128_C2 = 0x4cf5ad432745937fULL;
+
+    static inline u32 murmur3_rotl32(u32 x, s32 r) { return (x << r) | (x >> (32 - r)); }
+    static inline u64 murmur3_rotl64(u64 x, s32 r) { return (x << r) | (x >> (64 - r)); }
+
+    // Little-endian value of the first <n> (0 to 8) bytes at <p>
+    static inline u64 murmur3_read_tail(u8 const* p, u32 n)
+    {
+        u64 v = 0;
+        for (u32 i = 0; i < n; ++i)
+            v |= (u64)p[i] << (8 * i);
+        return v;
+    }
+
+    static inline void murmur3_write32(u8* p, u32 v)
+    {
+        for (s32 i = 0; i < 4; ++i)
+            p[i] = (u8)(v >> (8 * i));
+    }
+
+    static inline void murmur3_write64(u8* p, u64 v)
+    {
+        for (s32 i = 0; i < 8; ++i)
+            p[i] = (u8)(v >> (8 * i));
+    }
+
+    // MurmurHash3_x86_32, 4 byte blocks, a partial block is kept in m_tail between updates
+    struct murmur3_32_ctxt_t
+    {
+        u32 m_h1;
+        u32 m_tail;
+        u32 m_tail_len;
+        u32 m_reserved;
+        u64 m_total_len;
+
+        void reset(u32 seed)
+        {
+            m_h1        = seed;
+            m_tail      = 0;
+            m_tail_len  = 0;
+            m_reserved  = 0;
+            m_total_len = 0;
+        }
+
+        static inline u32 mix_k1(u32 k1)
+        {
+            k1 *= MURMUR3_32_C1;
+            k1 = murmur3_rotl32(k1, 15);
+            k1 *= MURMUR3_32_C2;
+            return k1;
+        }
+
+        static inline u32 block(u32 h1, u32 k1)
+        {
+            h1 ^= mix_k1(k1);
+            h1 = murmur3_rotl32(h1, 13);
+            return h1 * 5 + 0xe6546b64;
+        }
+
+        static u32 body(u32 h1, u8 const* p, u64 nblocks)
+        {
+            for (u64 i = 0; i < nblocks; ++i, p += 4)
+                h1 = block(h1, nhash_private::load_le32(p));
+            return h1;
+        }
+
+        void update(u8 const* p, u64 len)
+        {
+            m_total_len += len;
+
+            // Complete a pending partial block first
+            if (m_tail_len != 0)
+            {
+                while (len > 0 && m_tail_len < 4)
+                {
+                    m_tail |= (u32)*p++ << (8 * m_tail_len++);
+                    len--;
+                }
+                if (m_tail_len < 4)
+                    return;
+                m_h1       = block(m_h1, m_tail);
+                m_tail     = 0;
+                m_tail_len = 0;
+            }
+
+            m_h1 = body(m_h1, p, len / 4);
+            p += len & ~(u64)3;
+
+            m_tail_len = (u32)(len & 3);
+            m_tail     = (u32)murmur3_read_tail(p, m_tail_len);
+        }
+
+        static u32 finalize(u32 h1, u32 tail, u32 tail_len, u64 total_len)
+        {
+            if (tail_len != 0)
+                h1 ^= mix_k1(tail);
+            h1 ^= (u32)total_len;
+            return nhash_private::fmix32(h1);
+        }
+
+        u32 digest() const { return finalize(m_h1, m_tail, m_tail_len, m_total_len); }
+
+        static u32 hash(u8 const* p, u64 len, u32 seed)
+        {
+            u32 const h1 = body(seed, p, len / 4);
+            return finalize(h1, (u32)murmur3_read_tail(p + (len & ~(u64)3), (u32)(len & 3)), (u32)(len & 3), len);
+        }
+    };
+
+    // MurmurHash3_x64_128, 16 byte blocks, a partial block is kept in m_buffer between updates
+    struct murmur3_128_ctxt_t
+    {
+        u64 m_h1;
+        u64 m_h2;
+        u8  m_buffer[16];
+        u64 m_total_len;
+        u32 m_buffered;
+
+        void reset(u32 seed)
+        {
+            m_h1        = seed;
+            m_h2        = seed;
+            m_total_len = 0;
+            m_buffered  = 0;
+        }
+
+        static inline void block(u64& h1, u64& h2, u64 k1, u64 k2)
+        {
+            k1 *= MURMUR3_128_C1;
+            k1 = murmur3_rotl64(k1, 31);
+            k1 *= MURMUR3_128_C2;
+            h1 ^= k1;
+
+            h1 = murmur3_rotl64(h1, 27);
+            h1 += h2;
+            h1 = h1 * 5 + 0x52dce729;
+
+            k2 *= MURMUR3_128_C2;
+            k2 = murmur3_rotl64(k2, 33);
+            k2 *= MURMUR3_128_C1;
+            h2 ^= k2;
+
+            h2 = murmur3_rotl64(h2, 31);
+            h2 += h1;
+            h2 = h2 * 5 + 0x38495ab5;
+        }
+
+        static void body(u64& ioH1, u64& ioH2, u8 const* p, u64 nblocks)
+        {
+            u64 h1 = ioH1;
+            u64 h2 = ioH2;
+            for (u64 i = 0; i < nblocks; ++i, p += 16)
+                block(h1, h2, nhash_private::load_le64(p), nhash_private::load_le64(p + 8));
+            ioH1 = h1;
+            ioH2 = h2;
+        }
+
+        void update(u8 const* p, u64 len)
+        {
+            m_total_len += len;
+
+            if (m_buffered != 0)
+            {
+                u32 const fill = (len < (u64)(16 - m_buffered)) ? (u32)len : (16 - m_buffered);
+                nmem::memcpy(m_buffer + m_buffered, p, fill);
+                m_buffered += fill;
+                p += fill;
+                len -= fill;
+                if (m_buffered < 16)
+                    return;
+                block(m_h1, m_h2, nhash_private::load_le64(m_buffer), nhash_private::load_le64(m_buffer + 8));
+                m_buffered = 0;
+            }
+
+            body(m_h1, m_h2, p, len / 16);
+            p += len & ~(u64)15;
+
+            m_buffered = (u32)(len & 15);
+            nmem::memcpy(m_buffer, p, m_buffered);
+        }
+
+        static void finalize(u64 h1, u64 h2, u8 const* tail, u32 tail_len, u64 total_len, u8* out)
+        {
+            if (tail_len > 8)
+            {
+                u64 k2 = murmur3_read_tail(tail + 8, tail_len - 8);
+                k2 *= MURMUR3_128_C2;
+                k2 = murmur3_rotl64(k2, 33);
+                k2 *= MURMUR3_128_C1;
+                h2 ^= k2;
+            }
+            if (tail_len > 0)
+            {
+                u64 k1 = murmur3_read_tail(tail, tail_len > 8 ? 8 : tail_len);
+                k1 *= MURMUR3_128_C1;
+                k1 = murmur3_rotl64(k1, 31);
+                k1 *= MURMUR3_128_C2;
+                h1 ^= k1;
+            }
+
+            h1 ^= total_len;
+            h2 ^= total_len;
+            h1 += h2;
+            h2 += h1;
+            h1 = nhash_private::fmix64(h1);
+            h2 = nhash_private::fmix64(h2);
+            h1 += h2;
+            h2 += h1;
+
+            murmur3_write64(out, h1);
+            murmur3_write64(out + 8, h2);
+        }
+
+        void digest(u8* out) const { finalize(m_h1, m_h2, m_buffer, m_buffered, m_total_len, out); }
+
+        static void hash(u8 const* p, u64 len, u32 seed, u8* out)
+        {
+            u64 h1 = seed;
+            u64 h2 = seed;
+            body(h1, h2, p, len / 16);
+            finalize(h1, h2, p + (len & ~(u64)15), (u32)(len & 15), len, out);
+        }
+    };
+
+    namespace nhash_private
+    {
+        static_assert(sizeof(murmur3_32_ctxt_t) <= sizeof(murmur3_32_t::m_ctxt), "murmur3_32_t context too small");
+        static_assert(sizeof(murmur3_128_ctxt_t) <= sizeof(murmur3_128_t::m_ctxt), "murmur3_128_t context too small");
+
+        void murmur3_32_t::reset(u64 seed)
+        {
+            murmur3_32_ctxt_t* ctx = (murmur3_32_ctxt_t*)&this->m_ctxt;
+            m_seed                 = seed;
+            ctx->reset((u32)m_seed);
+        }
+
+        void murmur3_32_t::hash(const u8* begin, const u8* end)
+        {
+            murmur3_32_ctxt_t* ctx = (murmur3_32_ctxt_t*)&this->m_ctxt;
+            ctx->update(begin, (u64)(end - begin));
+        }
+
+        void murmur3_32_t::end(u8* out_hash)
+        {
+            murmur3_32_ctxt_t* ctx = (murmur3_32_ctxt_t*)&this->m_ctxt;
+            murmur3_write32(out_hash, ctx->digest());
+        }
+
+        void murmur3_128_t::reset(u64 seed)
+        {
+            murmur3_128_ctxt_t* ctx = (murmur3_128_ctxt_t*)&this->m_ctxt;
+            m_seed                  = seed;
+            ctx->reset((u32)m_seed);
+        }
+
+        void murmur3_128_t::hash(const u8* begin, const u8* end)
+        {
+            murmur3_128_ctxt_t* ctx = (murmur3_128_ctxt_t*)&this->m_ctxt;
+            ctx->update(begin, (u64)(end - begin));
+        }
+
+        void murmur3_128_t::end(u8* out_hash)
+        {
+            murmur3_128_ctxt_t* ctx = (murmur3_128_ctxt_t*)&this->m_ctxt;
+            ctx->digest(out_hash);
+        }
+    } // namespace nhash_private
+
+    namespace nhash
+    {
+        murmur3_32 hash_murmur3_32(u8 const* data, u64 len, u32 seed)
+        {
+            murmur3_32 digest;
+            murmur3_write32(digest.m_data, murmur3_32_ctxt_t::hash(data, len, seed));
+            return digest;
+        }
+
+        murmur3_128 hash_murmur3_128(u8 const* data, u64 len, u32 seed)
+        {
+            murmur3_128 digest;
+            murmur3_128_ctxt_t::hash(data, len, seed, digest.m_data);
+            return digest;
+        }
+    } // namespace nhash
+} // namespace ncore
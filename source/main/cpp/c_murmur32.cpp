@@ -1,6 +1,8 @@
 #include "ccore/c_target.h"
 #include "ccore/c_endian.h"
 
+#include "chash/c_hash.h"
+#include "chash/private/c_hash_mix.h"
 #include "chash/private/c_internal_hash.h"
 
 namespace ncore
@@ -55,24 +57,126 @@ namespace ncore
         return h;
     }
 
+    // MurmurHash2A, the incremental variant of MurmurHash2 by Austin Appleby. MurmurHash2 seeds the
+    // state with the total length which a stream does not know up front, 2A mixes the length in at
+    // the end instead. A partial 4 byte block is kept in m_tail between updates.
+    using nhash_private::murmur2_final;
+    using nhash_private::murmur2_mix;
+
+    static inline u32 murmur2_read32(u8 const* p) { return (u32)p[0] | ((u32)p[1] << 8) | ((u32)p[2] << 16) | ((u32)p[3] << 24); }
+
+    struct murmur32_ctxt_t
+    {
+        u32 m_hash;
+        u32 m_tail;
+        u32 m_tail_len;
+        u32 m_reserved;
+        u64 m_total_len;
+
+        void reset(u32 seed)
+        {
+            m_hash      = seed;
+            m_tail      = 0;
+            m_tail_len  = 0;
+            m_reserved  = 0;
+            m_total_len = 0;
+        }
+
+        static u32 body(u32 h, u8 const* p, u64 nblocks)
+        {
+            for (u64 i = 0; i < nblocks; ++i, p += 4)
+                h = murmur2_mix(h, murmur2_read32(p));
+            return h;
+        }
+
+        void update(u8 const* p, u64 len)
+        {
+            m_total_len += len;
+
+            if (m_tail_len != 0)
+            {
+                while (len > 0 && m_tail_len < 4)
+                {
+                    m_tail |= (u32)*p++ << (8 * m_tail_len++);
+                    len--;
+                }
+                if (m_tail_len < 4)
+                    return;
+                m_hash     = murmur2_mix(m_hash, m_tail);
+                m_tail     = 0;
+                m_tail_len = 0;
+            }
+
+            m_hash = body(m_hash, p, len / 4);
+            p += len & ~(u64)3;
+
+            m_tail_len = (u32)(len & 3);
+            m_tail     = 0;
+            for (u32 i = 0; i < m_tail_len; ++i)
+                m_tail |= (u32)p[i] << (8 * i);
+        }
+
+        static u32 finalize(u32 h, u32 tail, u64 total_len)
+        {
+            h = murmur2_mix(h, tail);
+            h = murmur2_mix(h, (u32)total_len);
+            return murmur2_final(h);
+        }
+
+        u32 digest() const { return finalize(m_hash, m_tail, m_total_len); }
+
+        static u32 hash(u8 const* p, u64 len, u32 seed)
+        {
+            u32 const h = body(seed, p, len / 4);
+            p += len & ~(u64)3;
+            u32 tail = 0;
+            for (u32 i = 0; i < (u32)(len & 3); ++i)
+                tail |= (u32)p[i] << (8 * i);
+            return finalize(h, tail, len);
+        }
+    };
+
+    static void murmur32_write(u8* out, u32 h)
+    {
+        u32       p   = nendian_ne::read_u32((u8 const*)&h);
+        u8 const* src = (u8 const*)&p;
+        out[0]        = src[0];
+        out[1]        = src[1];
+        out[2]        = src[2];
+        out[3]        = src[3];
+    }
+
     namespace nhash_private
     {
+        static_assert(sizeof(murmur32_ctxt_t) <= sizeof(murmur32_t::m_ctxt), "murmur32_t context too small");
+
         void murmur32_t::reset(u64 seed)
         {
-            m_seed = (u32)seed;
-            m_hash = m_seed;
+            murmur32_ctxt_t* ctx = (murmur32_ctxt_t*)&this->m_ctxt;
+            m_seed               = seed;
+            ctx->reset((u32)m_seed);
         }
 
-        void murmur32_t::hash(const u8* _buffer, u8 const* _end) { m_hash = gGetMurmurHash32(_buffer, (u32)(_end - _buffer), m_hash); }
+        void murmur32_t::hash(const u8* _buffer, u8 const* _end)
+        {
+            murmur32_ctxt_t* ctx = (murmur32_ctxt_t*)&this->m_ctxt;
+            ctx->update(_buffer, (u64)(_end - _buffer));
+        }
 
         void murmur32_t::end(u8* _hash)
         {
-            u32       p   = nendian_ne::read_u32((u8 const*)&m_hash);
-            u8 const* src = (u8 const*)&p;
-            _hash[0]      = src[0];
-            _hash[1]      = src[1];
-            _hash[2]      = src[2];
-            _hash[3]      = src[3];
+            murmur32_ctxt_t* ctx = (murmur32_ctxt_t*)&this->m_ctxt;
+            murmur32_write(_hash, ctx->digest());
         }
     } // namespace nhash_private
+
+    namespace nhash
+    {
+        murmur32 hash_murmur32(u8 const* data, u64 len, u32 seed)
+        {
+            murmur32 digest;
+            murmur32_write(digest.m_data, murmur32_ctxt_t::hash(data, len, seed));
+            return digest;
+        }
+    } // namespace nhash
 } // namespace ncore
@@ -1,6 +1,8 @@
 #include "ccore/c_target.h"
 #include "ccore/c_endian.h"
 
+#include "chash/c_hash.h"
+#include "chash/private/c_hash_mix.h"
 #include "chash/private/c_internal_hash.h"
 
 namespace ncore
@@ -79,17 +81,162 @@ namespace ncore
         return h;
     }
 
+    // Incremental form of MurmurHash64B, the 4 byte words still alternate between h1 and h2 but the
+    // length is mixed in at the end (as in MurmurHash2A) instead of into the initial h1, so a stream
+    // does not need to know its length up front. A partial word is kept in m_tail between updates.
+    using nhash_private::MURMUR2_M;
+    using nhash_private::murmur2_mix;
+
+    static inline u32 murmur64_read32(u8 const* p) { return (u32)p[0] | ((u32)p[1] << 8) | ((u32)p[2] << 16) | ((u32)p[3] << 24); }
+
+    struct murmur64_ctxt_t
+    {
+        u32 m_h1;
+        u32 m_h2;
+        u32 m_tail;
+        u32 m_tail_len;
+        u64 m_total_len;
+
+        void reset(u64 seed)
+        {
+            m_h1        = (u32)seed;
+            m_h2        = (u32)(seed >> 32);
+            m_tail      = 0;
+            m_tail_len  = 0;
+            m_total_len = 0;
+        }
+
+        // Mix <nwords> words, even words of the stream go to h1 and odd words to h2
+        static void body(u32& ioH1, u32& ioH2, u8 const* p, u64 nwords, bool odd)
+        {
+            u32 h1 = ioH1;
+            u32 h2 = ioH2;
+            if (odd && nwords > 0)
+            {
+                h2 = murmur2_mix(h2, murmur64_read32(p));
+                p += 4;
+                nwords--;
+            }
+            for (; nwords >= 2; nwords -= 2, p += 8)
+            {
+                h1 = murmur2_mix(h1, murmur64_read32(p));
+                h2 = murmur2_mix(h2, murmur64_read32(p + 4));
+            }
+            if (nwords > 0)
+                h1 = murmur2_mix(h1, murmur64_read32(p));
+            ioH1 = h1;
+            ioH2 = h2;
+        }
+
+        void update(u8 const* p, u64 len)
+        {
+            u64 const pos = m_total_len - m_tail_len;  // stream offset of the current (partial) word
+            m_total_len += len;
+
+            u64 word = pos / 4;
+            if (m_tail_len != 0)
+            {
+                while (len > 0 && m_tail_len < 4)
+                {
+                    m_tail |= (u32)*p++ << (8 * m_tail_len++);
+                    len--;
+                }
+                if (m_tail_len < 4)
+                    return;
+                if (word & 1)
+                    m_h2 = murmur2_mix(m_h2, m_tail);
+                else
+                    m_h1 = murmur2_mix(m_h1, m_tail);
+                m_tail     = 0;
+                m_tail_len = 0;
+                word++;
+            }
+
+            body(m_h1, m_h2, p, len / 4, (word & 1) != 0);
+            p += len & ~(u64)3;
+
+            m_tail_len = (u32)(len & 3);
+            m_tail     = 0;
+            for (u32 i = 0; i < m_tail_len; ++i)
+                m_tail |= (u32)p[i] << (8 * i);
+        }
+
+        static u64 finalize(u32 h1, u32 h2, u32 tail, u32 tail_len, u64 total_len)
+        {
+            if (tail_len != 0)
+            {
+                h2 ^= tail;
+                h2 *= MURMUR2_M;
+            }
+            h1 = murmur2_mix(h1, (u32)total_len);
+            h2 = murmur2_mix(h2, (u32)(total_len >> 32));
+
+            h1 ^= h2 >> 18;
+            h1 *= MURMUR2_M;
+            h2 ^= h1 >> 22;
+            h2 *= MURMUR2_M;
+            h1 ^= h2 >> 17;
+            h1 *= MURMUR2_M;
+            h2 ^= h1 >> 19;
+            h2 *= MURMUR2_M;
+
+            return ((u64)h1 << 32) | h2;
+        }
+
+        u64 digest() const { return finalize(m_h1, m_h2, m_tail, m_tail_len, m_total_len); }
+
+        static u64 hash(u8 const* p, u64 len, u64 seed)
+        {
+            u32 h1 = (u32)seed;
+            u32 h2 = (u32)(seed >> 32);
+            body(h1, h2, p, len / 4, false);
+            p += len & ~(u64)3;
+            u32 tail = 0;
+            for (u32 i = 0; i < (u32)(len & 3); ++i)
+                tail |= (u32)p[i] << (8 * i);
+            return finalize(h1, h2, tail, (u32)(len & 3), len);
+        }
+    };
+
+    static void murmur64_write(u8* out, u64 h)
+    {
+        u64       p   = nendian_ne::read_u64((const u8*)&h);
+        u8 const* src = (u8 const*)&p;
+        for (int i = 0; i < 8; i++)
+            out[i] = *src++;
+    }
+
     namespace nhash_private
     {
-        void murmur64_t::reset(u64 seed) { m_hash = m_seed; }
-        void murmur64_t::hash(const u8* begin, const u8* end) { m_hash = gGetMurmurHash64(begin, (u32)(end - begin), m_hash); }
+        static_assert(sizeof(murmur64_ctxt_t) <= sizeof(murmur64_t::m_ctxt), "murmur64_t context too small");
+
+        void murmur64_t::reset(u64 seed)
+        {
+            murmur64_ctxt_t* ctx = (murmur64_ctxt_t*)&this->m_ctxt;
+            m_seed               = seed;
+            ctx->reset(m_seed);
+        }
+
+        void murmur64_t::hash(const u8* begin, const u8* end)
+        {
+            murmur64_ctxt_t* ctx = (murmur64_ctxt_t*)&this->m_ctxt;
+            ctx->update(begin, (u64)(end - begin));
+        }
 
         void murmur64_t::end(u8* _hash)
         {
-            u64       p   = nendian_ne::read_u64((const u8*)&m_hash);
-            u8 const* src = (u8 const*)&p;
-            for (int i = 0; i < 8; i++)
-                _hash[i] = *src++;
+            murmur64_ctxt_t* ctx = (murmur64_ctxt_t*)&this->m_ctxt;
+            murmur64_write(_hash, ctx->digest());
         }
     } // namespace nhash_private
+
+    namespace nhash
+    {
+        murmur64 hash_murmur64(u8 const* data, u64 len, u64 seed)
+        {
+            murmur64 digest;
+            murmur64_write(digest.m_data, murmur64_ctxt_t::hash(data, len, seed));
+            return digest;
+        }
+    } // namespace nhash
 } // namespace ncore
@@ -1,8 +1,15 @@
 #include "ccore/c_target.h"
 #include "cbase/c_memory.h"
 
+#include "chash/private/c_hash_cpu.h"
+#include "chash/private/c_hash_multi.h"
+#include "chash/c_hash.h"
 #include "chash/private/c_internal_hash.h"
 
+#if defined(CHASH_X64)
+#    include <immintrin.h>
+#endif
+
 namespace ncore
 {
     //
@@ -105,15 +112,18 @@ namespace ncore
         ctx->H[4] = 0xc3d2e1f0;
     }
 
-    void xsha1_ctx_block(xsha1_ctx* ctx, const u32* data)
+    // Block functions process <nblocks> consecutive 64 byte blocks into H[5]
+    typedef void (*xsha1_blocks_fn)(u32* H, u8 const* blocks, uint_t nblocks);
+
+    static void xsha1_block_scalar(u32* H, const u32* data)
     {
         u32 array[16];
 
-        u32 A = ctx->H[0];
-        u32 B = ctx->H[1];
-        u32 C = ctx->H[2];
-        u32 D = ctx->H[3];
-        u32 E = ctx->H[4];
+        u32 A = H[0];
+        u32 B = H[1];
+        u32 C = H[2];
+        u32 D = H[3];
+        u32 E = H[4];
 
         // Round 1 - iterations 0-16 take their input from 'data'
         T_0_15(0, A, B, C, D, E);
@@ -205,18 +215,281 @@ namespace ncore
         T_60_79(78, C, D, E, A, B);
         T_60_79(79, B, C, D, E, A);
 
-        ctx->H[0] += A;
-        ctx->H[1] += B;
-        ctx->H[2] += C;
-        ctx->H[3] += D;
-        ctx->H[4] += E;
+        H[0] += A;
+        H[1] += B;
+        H[2] += C;
+        H[3] += D;
+        H[4] += E;
+    }
+
+    static void xsha1_blocks_scalar(u32* H, u8 const* blocks, uint_t nblocks)
+    {
+        u32 block[16];
+        for (uint_t i = 0; i < nblocks; ++i, blocks += 64)
+        {
+            if (((uint_t)blocks & 3) == 0)
+            {
+                xsha1_block_scalar(H, (u32 const*)blocks);
+                continue;
+            }
+            nmem::memcpy(block, blocks, 64);
+            xsha1_block_scalar(H, block);
+        }
     }
 
-    void xsha1_ctx_update(xsha1_ctx* ctx, u8 const* buffer, u32 buffer_size)
+#if defined(CHASH_X64)
+    // The message schedule is computed 4 words at a time with SSE, W[t..t+3] from the previous 16
+    // words in w0..w3, then the rounds run scalar on W[t] + K. The last lane of a group depends on
+    // the first lane of the same group (W[t+3] uses W[t]) and is fixed up after the rotate.
+    CHASH_TARGET("ssse3")
+    static inline __m128i xsha1_schedule_ssse3(__m128i& w0, __m128i& w1, __m128i& w2, __m128i& w3)
+    {
+        __m128i x = _mm_xor_si128(_mm_xor_si128(w0, _mm_alignr_epi8(w1, w0, 8)), _mm_xor_si128(w2, _mm_srli_si128(w3, 4)));
+        x         = _mm_or_si128(_mm_slli_epi32(x, 1), _mm_srli_epi32(x, 31));
+        __m128i f = _mm_slli_si128(x, 12);
+        x         = _mm_xor_si128(x, _mm_or_si128(_mm_slli_epi32(f, 1), _mm_srli_epi32(f, 31)));
+        w0        = w1;
+        w1        = w2;
+        w2        = w3;
+        w3        = x;
+        return x;
+    }
+
+#    define XSHA1_SCHEDULE(g, k) _mm_storeu_si128((__m128i*)wk + g, _mm_add_epi32(xsha1_schedule_ssse3(w0, w1, w2, w3), k))
+#    define XSHA1_WK_ROUND(t, fn, A, B, C, D, E) \
+        do                                        \
+        {                                         \
+            E += wk[t] + SHA_ROL(A, 5) + (fn);    \
+            B = SHA_ROR(B, 2);                    \
+        } while (0)
+#    define XSHA1_CH(B, C, D)     (((C ^ D) & B) ^ D)
+#    define XSHA1_PARITY(B, C, D) (B ^ C ^ D)
+#    define XSHA1_MAJ(B, C, D)    ((B & C) + (D & (B ^ C)))
+
+    CHASH_TARGET("ssse3")
+    static void xsha1_blocks_ssse3(u32* H, u8 const* blocks, uint_t nblocks)
+    {
+        __m128i const bswap = _mm_set_epi8(12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
+        __m128i const k0    = _mm_set1_epi32(0x5a827999);
+        __m128i const k1    = _mm_set1_epi32(0x6ed9eba1);
+        __m128i const k2    = _mm_set1_epi32((int)0x8f1bbcdc);
+        __m128i const k3    = _mm_set1_epi32((int)0xca62c1d6);
+
+        u32 wk[80];
+        for (uint_t n = 0; n < nblocks; ++n, blocks += 64)
+        {
+            __m128i w0 = _mm_shuffle_epi8(_mm_loadu_si128((__m128i const*)blocks + 0), bswap);
+            __m128i w1 = _mm_shuffle_epi8(_mm_loadu_si128((__m128i const*)blocks + 1), bswap);
+            __m128i w2 = _mm_shuffle_epi8(_mm_loadu_si128((__m128i const*)blocks + 2), bswap);
+            __m128i w3 = _mm_shuffle_epi8(_mm_loadu_si128((__m128i const*)blocks + 3), bswap);
+            _mm_storeu_si128((__m128i*)wk + 0, _mm_add_epi32(w0, k0));
+            _mm_storeu_si128((__m128i*)wk + 1, _mm_add_epi32(w1, k0));
+            _mm_storeu_si128((__m128i*)wk + 2, _mm_add_epi32(w2, k0));
+            _mm_storeu_si128((__m128i*)wk + 3, _mm_add_epi32(w3, k0));
+
+            u32 A = H[0];
+            u32 B = H[1];
+            u32 C = H[2];
+            u32 D = H[3];
+            u32 E = H[4];
+
+            // The schedule runs 4 groups ahead of the rounds that consume it
+            XSHA1_SCHEDULE(4, k0);
+            XSHA1_WK_ROUND(0, XSHA1_CH(B, C, D), A, B, C, D, E);
+            XSHA1_WK_ROUND(1, XSHA1_CH(A, B, C), E, A, B, C, D);
+            XSHA1_WK_ROUND(2, XSHA1_CH(E, A, B), D, E, A, B, C);
+            XSHA1_WK_ROUND(3, XSHA1_CH(D, E, A), C, D, E, A, B);
+            XSHA1_SCHEDULE(5, k1);
+            XSHA1_WK_ROUND(4, XSHA1_CH(C, D, E), B, C, D, E, A);
+            XSHA1_WK_ROUND(5, XSHA1_CH(B, C, D), A, B, C, D, E);
+            XSHA1_WK_ROUND(6, XSHA1_CH(A, B, C), E, A, B, C, D);
+            XSHA1_WK_ROUND(7, XSHA1_CH(E, A, B), D, E, A, B, C);
+            XSHA1_SCHEDULE(6, k1);
+            XSHA1_WK_ROUND(8, XSHA1_CH(D, E, A), C, D, E, A, B);
+            XSHA1_WK_ROUND(9, XSHA1_CH(C, D, E), B, C, D, E, A);
+            XSHA1_WK_ROUND(10, XSHA1_CH(B, C, D), A, B, C, D, E);
+            XSHA1_WK_ROUND(11, XSHA1_CH(A, B, C), E, A, B, C, D);
+            XSHA1_SCHEDULE(7, k1);
+            XSHA1_WK_ROUND(12, XSHA1_CH(E, A, B), D, E, A, B, C);
+            XSHA1_WK_ROUND(13, XSHA1_CH(D, E, A), C, D, E, A, B);
+            XSHA1_WK_ROUND(14, XSHA1_CH(C, D, E), B, C, D, E, A);
+            XSHA1_WK_ROUND(15, XSHA1_CH(B, C, D), A, B, C, D, E);
+            XSHA1_SCHEDULE(8, k1);
+            XSHA1_WK_ROUND(16, XSHA1_CH(A, B, C), E, A, B, C, D);
+            XSHA1_WK_ROUND(17, XSHA1_CH(E, A, B), D, E, A, B, C);
+            XSHA1_WK_ROUND(18, XSHA1_CH(D, E, A), C, D, E, A, B);
+            XSHA1_WK_ROUND(19, XSHA1_CH(C, D, E), B, C, D, E, A);
+            XSHA1_SCHEDULE(9, k1);
+            XSHA1_WK_ROUND(20, XSHA1_PARITY(B, C, D), A, B, C, D, E);
+            XSHA1_WK_ROUND(21, XSHA1_PARITY(A, B, C), E, A, B, C, D);
+            XSHA1_WK_ROUND(22, XSHA1_PARITY(E, A, B), D, E, A, B, C);
+            XSHA1_WK_ROUND(23, XSHA1_PARITY(D, E, A), C, D, E, A, B);
+            XSHA1_SCHEDULE(10, k2);
+            XSHA1_WK_ROUND(24, XSHA1_PARITY(C, D, E), B, C, D, E, A);
+            XSHA1_WK_ROUND(25, XSHA1_PARITY(B, C, D), A, B, C, D, E);
+            XSHA1_WK_ROUND(26, XSHA1_PARITY(A, B, C), E, A, B, C, D);
+            XSHA1_WK_ROUND(27, XSHA1_PARITY(E, A, B), D, E, A, B, C);
+            XSHA1_SCHEDULE(11, k2);
+            XSHA1_WK_ROUND(28, XSHA1_PARITY(D, E, A), C, D, E, A, B);
+            XSHA1_WK_ROUND(29, XSHA1_PARITY(C, D, E), B, C, D, E, A);
+            XSHA1_WK_ROUND(30, XSHA1_PARITY(B, C, D), A, B, C, D, E);
+            XSHA1_WK_ROUND(31, XSHA1_PARITY(A, B, C), E, A, B, C, D);
+            XSHA1_SCHEDULE(12, k2);
+            XSHA1_WK_ROUND(32, XSHA1_PARITY(E, A, B), D, E, A, B, C);
+            XSHA1_WK_ROUND(33, XSHA1_PARITY(D, E, A), C, D, E, A, B);
+            XSHA1_WK_ROUND(34, XSHA1_PARITY(C, D, E), B, C, D, E, A);
+            XSHA1_WK_ROUND(35, XSHA1_PARITY(B, C, D), A, B, C, D, E);
+            XSHA1_SCHEDULE(13, k2);
+            XSHA1_WK_ROUND(36, XSHA1_PARITY(A, B, C), E, A, B, C, D);
+            XSHA1_WK_ROUND(37, XSHA1_PARITY(E, A, B), D, E, A, B, C);
+            XSHA1_WK_ROUND(38, XSHA1_PARITY(D, E, A), C, D, E, A, B);
+            XSHA1_WK_ROUND(39, XSHA1_PARITY(C, D, E), B, C, D, E, A);
+            XSHA1_SCHEDULE(14, k2);
+            XSHA1_WK_ROUND(40, XSHA1_MAJ(B, C, D), A, B, C, D, E);
+            XSHA1_WK_ROUND(41, XSHA1_MAJ(A, B, C), E, A, B, C, D);
+            XSHA1_WK_ROUND(42, XSHA1_MAJ(E, A, B), D, E, A, B, C);
+            XSHA1_WK_ROUND(43, XSHA1_MAJ(D, E, A), C, D, E, A, B);
+            XSHA1_SCHEDULE(15, k3);
+            XSHA1_WK_ROUND(44, XSHA1_MAJ(C, D, E), B, C, D, E, A);
+            XSHA1_WK_ROUND(45, XSHA1_MAJ(B, C, D), A, B, C, D, E);
+            XSHA1_WK_ROUND(46, XSHA1_MAJ(A, B, C), E, A, B, C, D);
+            XSHA1_WK_ROUND(47, XSHA1_MAJ(E, A, B), D, E, A, B, C);
+            XSHA1_SCHEDULE(16, k3);
+            XSHA1_WK_ROUND(48, XSHA1_MAJ(D, E, A), C, D, E, A, B);
+            XSHA1_WK_ROUND(49, XSHA1_MAJ(C, D, E), B, C, D, E, A);
+            XSHA1_WK_ROUND(50, XSHA1_MAJ(B, C, D), A, B, C, D, E);
+            XSHA1_WK_ROUND(51, XSHA1_MAJ(A, B, C), E, A, B, C, D);
+            XSHA1_SCHEDULE(17, k3);
+            XSHA1_WK_ROUND(52, XSHA1_MAJ(E, A, B), D, E, A, B, C);
+            XSHA1_WK_ROUND(53, XSHA1_MAJ(D, E, A), C, D, E, A, B);
+            XSHA1_WK_ROUND(54, XSHA1_MAJ(C, D, E), B, C, D, E, A);
+            XSHA1_WK_ROUND(55, XSHA1_MAJ(B, C, D), A, B, C, D, E);
+            XSHA1_SCHEDULE(18, k3);
+            XSHA1_WK_ROUND(56, XSHA1_MAJ(A, B, C), E, A, B, C, D);
+            XSHA1_WK_ROUND(57, XSHA1_MAJ(E, A, B), D, E, A, B, C);
+            XSHA1_WK_ROUND(58, XSHA1_MAJ(D, E, A), C, D, E, A, B);
+            XSHA1_WK_ROUND(59, XSHA1_MAJ(C, D, E), B, C, D, E, A);
+            XSHA1_SCHEDULE(19, k3);
+            XSHA1_WK_ROUND(60, XSHA1_PARITY(B, C, D), A, B, C, D, E);
+            XSHA1_WK_ROUND(61, XSHA1_PARITY(A, B, C), E, A, B, C, D);
+            XSHA1_WK_ROUND(62, XSHA1_PARITY(E, A, B), D, E, A, B, C);
+            XSHA1_WK_ROUND(63, XSHA1_PARITY(D, E, A), C, D, E, A, B);
+            XSHA1_WK_ROUND(64, XSHA1_PARITY(C, D, E), B, C, D, E, A);
+            XSHA1_WK_ROUND(65, XSHA1_PARITY(B, C, D), A, B, C, D, E);
+            XSHA1_WK_ROUND(66, XSHA1_PARITY(A, B, C), E, A, B, C, D);
+            XSHA1_WK_ROUND(67, XSHA1_PARITY(E, A, B), D, E, A, B, C);
+            XSHA1_WK_ROUND(68, XSHA1_PARITY(D, E, A), C, D, E, A, B);
+            XSHA1_WK_ROUND(69, XSHA1_PARITY(C, D, E), B, C, D, E, A);
+            XSHA1_WK_ROUND(70, XSHA1_PARITY(B, C, D), A, B, C, D, E);
+            XSHA1_WK_ROUND(71, XSHA1_PARITY(A, B, C), E, A, B, C, D);
+            XSHA1_WK_ROUND(72, XSHA1_PARITY(E, A, B), D, E, A, B, C);
+            XSHA1_WK_ROUND(73, XSHA1_PARITY(D, E, A), C, D, E, A, B);
+            XSHA1_WK_ROUND(74, XSHA1_PARITY(C, D, E), B, C, D, E, A);
+            XSHA1_WK_ROUND(75, XSHA1_PARITY(B, C, D), A, B, C, D, E);
+            XSHA1_WK_ROUND(76, XSHA1_PARITY(A, B, C), E, A, B, C, D);
+            XSHA1_WK_ROUND(77, XSHA1_PARITY(E, A, B), D, E, A, B, C);
+            XSHA1_WK_ROUND(78, XSHA1_PARITY(D, E, A), C, D, E, A, B);
+            XSHA1_WK_ROUND(79, XSHA1_PARITY(C, D, E), B, C, D, E, A);
+#    undef XSHA1_CH
+#    undef XSHA1_PARITY
+#    undef XSHA1_MAJ
+#    undef XSHA1_WK_ROUND
+#    undef XSHA1_SCHEDULE
+            H[0] += A;
+            H[1] += B;
+            H[2] += C;
+            H[3] += D;
+            H[4] += E;
+        }
+    }
+
+    // SHA extensions, 4 rounds per sha1rnds4. Group <I> covers rounds 4I..4I+3 with the message
+    // words in msg[I & 3], sha1msg1/sha1msg2 compute the schedule 3 groups ahead.
+    template <s32 I> CHASH_TARGET("sha,ssse3,sse4.1") static inline void xsha1_shani_group(__m128i& abcd, __m128i* e, __m128i* msg)
+    {
+        __m128i& e_cur  = e[I & 1];
+        __m128i& e_next = e[(I + 1) & 1];
+        e_cur           = _mm_sha1nexte_epu32(e_cur, msg[I & 3]);
+        e_next          = abcd;
+        if (I >= 3 && I <= 18)
+            msg[(I + 1) & 3] = _mm_sha1msg2_epu32(msg[(I + 1) & 3], msg[I & 3]);
+        abcd = _mm_sha1rnds4_epu32(abcd, e_cur, I / 5);
+        if (I >= 1 && I <= 16)
+            msg[(I - 1) & 3] = _mm_sha1msg1_epu32(msg[(I - 1) & 3], msg[I & 3]);
+        if (I >= 2 && I <= 17)
+            msg[(I - 2) & 3] = _mm_xor_si128(msg[(I - 2) & 3], msg[I & 3]);
+    }
+
+    CHASH_TARGET("sha,ssse3,sse4.1")
+    static void xsha1_blocks_shani(u32* H, u8 const* blocks, uint_t nblocks)
+    {
+        __m128i const bswap = _mm_set_epi64x(0x0001020304050607ULL, 0x08090a0b0c0d0e0fULL);
+
+        __m128i abcd = _mm_shuffle_epi32(_mm_loadu_si128((__m128i const*)H), 0x1B);
+        __m128i e0   = _mm_set_epi32((int)H[4], 0, 0, 0);
+        for (uint_t n = 0; n < nblocks; ++n, blocks += 64)
+        {
+            __m128i const abcd_save = abcd;
+            __m128i const e0_save   = e0;
+
+            __m128i msg[4];
+            __m128i e[2];
+            msg[0] = _mm_shuffle_epi8(_mm_loadu_si128((__m128i const*)blocks + 0), bswap);
+            msg[1] = _mm_shuffle_epi8(_mm_loadu_si128((__m128i const*)blocks + 1), bswap);
+            msg[2] = _mm_shuffle_epi8(_mm_loadu_si128((__m128i const*)blocks + 2), bswap);
+            msg[3] = _mm_shuffle_epi8(_mm_loadu_si128((__m128i const*)blocks + 3), bswap);
+
+            // Group 0 adds E directly, the other groups derive it with sha1nexte
+            e[0] = _mm_add_epi32(e0, msg[0]);
+            e[1] = abcd;
+            abcd = _mm_sha1rnds4_epu32(abcd, e[0], 0);
+
+            xsha1_shani_group<1>(abcd, e, msg);
+            xsha1_shani_group<2>(abcd, e, msg);
+            xsha1_shani_group<3>(abcd, e, msg);
+            xsha1_shani_group<4>(abcd, e, msg);
+            xsha1_shani_group<5>(abcd, e, msg);
+            xsha1_shani_group<6>(abcd, e, msg);
+            xsha1_shani_group<7>(abcd, e, msg);
+            xsha1_shani_group<8>(abcd, e, msg);
+            xsha1_shani_group<9>(abcd, e, msg);
+            xsha1_shani_group<10>(abcd, e, msg);
+            xsha1_shani_group<11>(abcd, e, msg);
+            xsha1_shani_group<12>(abcd, e, msg);
+            xsha1_shani_group<13>(abcd, e, msg);
+            xsha1_shani_group<14>(abcd, e, msg);
+            xsha1_shani_group<15>(abcd, e, msg);
+            xsha1_shani_group<16>(abcd, e, msg);
+            xsha1_shani_group<17>(abcd, e, msg);
+            xsha1_shani_group<18>(abcd, e, msg);
+            xsha1_shani_group<19>(abcd, e, msg);
+
+            e0   = _mm_sha1nexte_epu32(e[0], e0_save);
+            abcd = _mm_add_epi32(abcd, abcd_save);
+        }
+        _mm_storeu_si128((__m128i*)H, _mm_shuffle_epi32(abcd, 0x1B));
+        H[4] = (u32)_mm_extract_epi32(e0, 3);
+    }
+#endif
+
+    static xsha1_blocks_fn xsha1_kernel()
+    {
+#if defined(CHASH_X64)
+        if (nhash_cpu::has(nhash_cpu::SHA | nhash_cpu::SSSE3 | nhash_cpu::SSE41))
+            return xsha1_blocks_shani;
+        if (nhash_cpu::has(nhash_cpu::SSSE3))
+            return xsha1_blocks_ssse3;
+#endif
+        return xsha1_blocks_scalar;
+    }
+
+    void xsha1_ctx_block(xsha1_ctx* ctx, const u32* data) { xsha1_kernel()(ctx->H, (u8 const*)data, 1); }
+
+    void xsha1_ctx_update(xsha1_ctx* ctx, u8 const* buffer, u64 buffer_size)
     {
         u32 lenW = ctx->size & 63;
 
-        u32       len  = buffer_size;
+        u64       len  = buffer_size;
         u8 const* data = buffer;
         ctx->size += len;
 
@@ -225,7 +498,7 @@ namespace ncore
         {
             u32 left = 64 - lenW;
             if (len < left)
-                left = len;
+                left = (u32)len;
             nmem::memcpy(lenW + (char*)ctx->W, data, left);
             lenW = (lenW + left) & 63;
             len -= left;
@@ -234,11 +507,11 @@ namespace ncore
                 return;
             xsha1_ctx_block(ctx, ctx->W);
         }
-        while (len >= 64)
+        if (len >= 64)
         {
-            xsha1_ctx_block(ctx, (u32 const*)data);
-            data = ((const u8*)data + 64);
-            len -= 64;
+            xsha1_kernel()(ctx->H, data, len / 64);
+            data = ((const u8*)data + (len & ~63));
+            len &= 63;
         }
         if (len)
             nmem::memcpy(ctx->W, data, len);
@@ -258,6 +531,80 @@ namespace ncore
         xsha1_ctx_update(ctx, (u8 const*)padlen, 8);
     }
 
+    // The digest is H[0..4] as big-endian words
+    static void xsha1_digest(u32 const* H, u8* hash)
+    {
+        for (s32 i = 0; i < 5; ++i)
+        {
+            u32 const h      = H[i];
+            hash[4 * i + 0] = (u8)(h >> 24);
+            hash[4 * i + 1] = (u8)(h >> 16);
+            hash[4 * i + 2] = (u8)(h >> 8);
+            hash[4 * i + 3] = (u8)(h);
+        }
+    }
+
+    static void xsha1_ctx_digest(xsha1_ctx const* ctx, u8* hash) { xsha1_digest(ctx->H, hash); }
+
+#if defined(CHASH_X64)
+    // The block function on 8 messages at once, one per 32-bit lane
+    CHASH_TARGET("avx2")
+    static void xsha1_blocks_x8_avx2(u32 (*H)[8], u32 const (*words)[8])
+    {
+        __m256i const bswap = _mm256_set_epi8(12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3, 12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
+
+        __m256i w[16];
+        for (s32 i = 0; i < 16; ++i)
+            w[i] = _mm256_shuffle_epi8(_mm256_loadu_si256((__m256i const*)words[i]), bswap);
+
+        __m256i A = _mm256_loadu_si256((__m256i const*)H[0]);
+        __m256i B = _mm256_loadu_si256((__m256i const*)H[1]);
+        __m256i C = _mm256_loadu_si256((__m256i const*)H[2]);
+        __m256i D = _mm256_loadu_si256((__m256i const*)H[3]);
+        __m256i E = _mm256_loadu_si256((__m256i const*)H[4]);
+
+#    define XSHA1_ROL_X8(x, n) _mm256_or_si256(_mm256_slli_epi32(x, n), _mm256_srli_epi32(x, 32 - (n)))
+#    define XSHA1_ROUND_X8(t, fn, k)                                                                                                          \
+        {                                                                                                                                   \
+            if (t >= 16)                                                                                                                    \
+            {                                                                                                                               \
+                __m256i const x = _mm256_xor_si256(_mm256_xor_si256(w[(t + 13) & 15], w[(t + 8) & 15]), _mm256_xor_si256(w[(t + 2) & 15], w[t & 15])); \
+                w[t & 15]       = XSHA1_ROL_X8(x, 1);                                                                                      \
+            }                                                                                                                               \
+            __m256i const f    = fn;                                                                                                        \
+            __m256i const temp = _mm256_add_epi32(_mm256_add_epi32(XSHA1_ROL_X8(A, 5), f), _mm256_add_epi32(_mm256_add_epi32(E, k), w[t & 15])); \
+            E                  = D;                                                                                                         \
+            D                  = C;                                                                                                         \
+            C                  = XSHA1_ROL_X8(B, 30);                                                                                       \
+            B                  = A;                                                                                                         \
+            A                  = temp;                                                                                                      \
+        }
+
+        __m256i const k0 = _mm256_set1_epi32(0x5a827999);
+        __m256i const k1 = _mm256_set1_epi32(0x6ed9eba1);
+        __m256i const k2 = _mm256_set1_epi32((int)0x8f1bbcdc);
+        __m256i const k3 = _mm256_set1_epi32((int)0xca62c1d6);
+        for (s32 t = 0; t < 20; ++t)
+            XSHA1_ROUND_X8(t, _mm256_xor_si256(_mm256_and_si256(_mm256_xor_si256(C, D), B), D), k0);
+        for (s32 t = 20; t < 40; ++t)
+            XSHA1_ROUND_X8(t, _mm256_xor_si256(_mm256_xor_si256(B, C), D), k1);
+        for (s32 t = 40; t < 60; ++t)
+            XSHA1_ROUND_X8(t, _mm256_or_si256(_mm256_and_si256(B, C), _mm256_and_si256(D, _mm256_or_si256(B, C))), k2);
+        for (s32 t = 60; t < 80; ++t)
+            XSHA1_ROUND_X8(t, _mm256_xor_si256(_mm256_xor_si256(B, C), D), k3);
+#    undef XSHA1_ROUND_X8
+#    undef XSHA1_ROL_X8
+
+        _mm256_storeu_si256((__m256i*)H[0], _mm256_add_epi32(A, _mm256_loadu_si256((__m256i const*)H[0])));
+        _mm256_storeu_si256((__m256i*)H[1], _mm256_add_epi32(B, _mm256_loadu_si256((__m256i const*)H[1])));
+        _mm256_storeu_si256((__m256i*)H[2], _mm256_add_epi32(C, _mm256_loadu_si256((__m256i const*)H[2])));
+        _mm256_storeu_si256((__m256i*)H[3], _mm256_add_epi32(D, _mm256_loadu_si256((__m256i const*)H[3])));
+        _mm256_storeu_si256((__m256i*)H[4], _mm256_add_epi32(E, _mm256_loadu_si256((__m256i const*)H[4])));
+    }
+#endif
+
+    static void xsha1_blocks(u32* H, u8 const* blocks, uint_t nblocks) { xsha1_kernel()(H, blocks, nblocks); }
+
     namespace nhash_private
     {
         void sha1_t::reset(u64 seed)
@@ -269,7 +616,7 @@ namespace ncore
         void sha1_t::hash(const u8* begin, const u8* end)
         {
             xsha1_ctx* ctx = (xsha1_ctx*)&this->m_ctxt;
-            xsha1_ctx_update(ctx, begin, (u32)(end - begin));
+            xsha1_ctx_update(ctx, begin, (u64)(end - begin));
         }
 
         void sha1_t::end(u8* _hash)
@@ -280,23 +627,59 @@ namespace ncore
                 xsha1_ctx_close(ctx);
                 ctx->computed = 1;
             }
+            xsha1_ctx_digest(ctx, _hash);
+        }
+    } // namespace nhash_private
 
-            for (s32 i = 0; i < 5; ++i)
-            {
-                u32 const* h = &ctx->H[i];
-#if defined(NCORE_BIG_ENDIAN)
-                _hash[4 * i + 0] = h[0];
-                _hash[4 * i + 1] = h[1];
-                _hash[4 * i + 2] = h[2];
-                _hash[4 * i + 3] = h[3];
-#else
-                _hash[4 * i + 0] = h[3];
-                _hash[4 * i + 1] = h[2];
-                _hash[4 * i + 2] = h[1];
-                _hash[4 * i + 3] = h[0];
+    namespace nhash
+    {
+        sha1 hash_sha1(u8 const* data, u64 len)
+        {
+            xsha1_ctx ctx;
+            xsha1_ctx_init(&ctx);
+            u64 const length = len;
+
+            // Whole blocks are processed straight from the input
+            xsha1_kernel()(ctx.H, data, (uint_t)(len / 64));
+            data += len & ~(u64)63;
+            len &= 63;
+
+            // The tail, padding and message length take one or two blocks
+            u32 tail[32];
+            nmem::memclr(tail, sizeof(tail));
+            nmem::memcpy(tail, data, (u32)len);
+            ((u8*)tail)[len] = 0x80;
+            s32 const words  = (len < 56) ? 16 : 32;
+            put_be32(&tail[words - 2], (u32)(length >> 29));
+            put_be32(&tail[words - 1], (u32)(length << 3));
+            xsha1_ctx_block(&ctx, tail);
+            if (words == 32)
+                xsha1_ctx_block(&ctx, tail + 16);
+
+            sha1 digest;
+            xsha1_ctx_digest(&ctx, digest.m_data);
+            return digest;
+        }
+
+        void hash_sha1_multi(u8 const* const* data, u64 const* lens, sha1* digests, u32 count)
+        {
+            static u32 const iv[5] = {0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476, 0xc3d2e1f0};
+
+            nhash_private::multi_algo_t algo;
+            algo.iv          = iv;
+            algo.state_words = 5;
+            algo.digest_size = sizeof(sha1);
+            algo.length_be   = true;
+            algo.blocks      = xsha1_blocks;
+            algo.lanes       = nullptr;
+            algo.digest      = xsha1_digest;
+#if defined(CHASH_X64)
+            // One message at a time with the SHA extensions is as fast as 8 lanes of AVX2
+            if (nhash_cpu::has(nhash_cpu::AVX2) && !nhash_cpu::has(nhash_cpu::SHA))
+                algo.lanes = xsha1_blocks_x8_avx2;
 #endif
-            }
+            nhash_private::multi_buffer_hash(algo, data, lens, (u8*)digests, count);
         }
-    } // namespace nhash_private
+    } // namespace nhash
 
 } // namespace ncore
@@ -0,0 +1,609 @@
+#include "ccore/c_target.h"
+#include "cbase/c_memory.h"
+
+#include "chash/private/c_hash_cpu.h"
+#include "chash/c_hash.h"
+#include "chash/private/c_internal_hash.h"
+
+#if defined(CHASH_X64)
+#    include <immintrin.h>
+#endif
+
+namespace ncore
+{
+    //
+    //  SHA-256 and SHA-512 as defined in FIPS PUB 180-4.
+    //
+    //  Both process the message in blocks (64 bytes for SHA-256, 128 bytes for SHA-512) with a
+    //  16 word message schedule expanded to 64 or 80 words. The block functions are selected at
+    //  runtime, SHA-256 uses the SHA extensions when present, both have an AVX2 kernel that
+    //  expands the message schedule 4 words at a time and a portable scalar fallback.
+    //
+
+    static const u32 s_sha256_k[64] = {
+        0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+        0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+        0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+        0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+        0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+        0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+        0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+        0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+    };
+
+    static const u32 s_sha256_iv[8] = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+
+    static const u64 s_sha512_k[80] = {
+        0x428a2f98d728ae22ULL, 0x7137449123ef65cdULL, 0xb5c0fbcfec4d3b2fULL, 0xe9b5dba58189dbbcULL,
+        0x3956c25bf348b538ULL, 0x59f111f1b605d019ULL, 0x923f82a4af194f9bULL, 0xab1c5ed5da6d8118ULL,
+        0xd807aa98a3030242ULL, 0x12835b0145706fbeULL, 0x243185be4ee4b28cULL, 0x550c7dc3d5ffb4e2ULL,
+        0x72be5d74f27b896fULL, 0x80deb1fe3b1696b1ULL, 0x9bdc06a725c71235ULL, 0xc19bf174cf692694ULL,
+        0xe49b69c19ef14ad2ULL, 0xefbe4786384f25e3ULL, 0x0fc19dc68b8cd5b5ULL, 0x240ca1cc77ac9c65ULL,
+        0x2de92c6f592b0275ULL, 0x4a7484aa6ea6e483ULL, 0x5cb0a9dcbd41fbd4ULL, 0x76f988da831153b5ULL,
+        0x983e5152ee66dfabULL, 0xa831c66d2db43210ULL, 0xb00327c898fb213fULL, 0xbf597fc7beef0ee4ULL,
+        0xc6e00bf33da88fc2ULL, 0xd5a79147930aa725ULL, 0x06ca6351e003826fULL, 0x142929670a0e6e70ULL,
+        0x27b70a8546d22ffcULL, 0x2e1b21385c26c926ULL, 0x4d2c6dfc5ac42aedULL, 0x53380d139d95b3dfULL,
+        0x650a73548baf63deULL, 0x766a0abb3c77b2a8ULL, 0x81c2c92e47edaee6ULL, 0x92722c851482353bULL,
+        0xa2bfe8a14cf10364ULL, 0xa81a664bbc423001ULL, 0xc24b8b70d0f89791ULL, 0xc76c51a30654be30ULL,
+        0xd192e819d6ef5218ULL, 0xd69906245565a910ULL, 0xf40e35855771202aULL, 0x106aa07032bbd1b8ULL,
+        0x19a4c116b8d2d0c8ULL, 0x1e376c085141ab53ULL, 0x2748774cdf8eeb99ULL, 0x34b0bcb5e19b48a8ULL,
+        0x391c0cb3c5c95a63ULL, 0x4ed8aa4ae3418acbULL, 0x5b9cca4f7763e373ULL, 0x682e6ff3d6b2b8a3ULL,
+        0x748f82ee5defb2fcULL, 0x78a5636f43172f60ULL, 0x84c87814a1f0ab72ULL, 0x8cc702081a6439ecULL,
+        0x90befffa23631e28ULL, 0xa4506cebde82bde9ULL, 0xbef9a3f7b2c67915ULL, 0xc67178f2e372532bULL,
+        0xca273eceea26619cULL, 0xd186b8c721c0c207ULL, 0xeada7dd6cde0eb1eULL, 0xf57d4f7fee6ed178ULL,
+        0x06f067aa72176fbaULL, 0x0a637dc5a2c898a6ULL, 0x113f9804bef90daeULL, 0x1b710b35131c471bULL,
+        0x28db77f523047d84ULL, 0x32caab7b40c72493ULL, 0x3c9ebe0a15c9bebcULL, 0x431d67c49c100d4cULL,
+        0x4cc5d4becb3e42b6ULL, 0x597f299cfc657e2aULL, 0x5fcb6fab3ad6faecULL, 0x6c44198c4a475817ULL
+    };
+
+    static const u64 s_sha512_iv[8] = {
+        0x6a09e667f3bcc908ULL, 0xbb67ae8584caa73bULL, 0x3c6ef372fe94f82bULL, 0xa54ff53a5f1d36f1ULL,
+        0x510e527fade682d1ULL, 0x9b05688c2b3e6c1fULL, 0x1f83d9abfb41bd6bULL, 0x5be0cd19137e2179ULL
+    };
+
+    // Block functions process <nblocks> consecutive blocks into H[8]
+    typedef void (*sha256_blocks_fn)(u32* H, u8 const* blocks, uint_t nblocks);
+    typedef void (*sha512_blocks_fn)(u64* H, u8 const* blocks, uint_t nblocks);
+
+    static inline u32 sha256_ror(u32 x, s32 n) { return (x >> n) | (x << (32 - n)); }
+    static inline u64 sha512_ror(u64 x, s32 n) { return (x >> n) | (x << (64 - n)); }
+
+    static inline u32 sha256_read_be(u8 const* p) { return ((u32)p[0] << 24) | ((u32)p[1] << 16) | ((u32)p[2] << 8) | (u32)p[3]; }
+    static inline u64 sha512_read_be(u8 const* p) { return ((u64)sha256_read_be(p) << 32) | sha256_read_be(p + 4); }
+
+    // One round, <wk> is the message word plus the round constant. The callers rotate the names
+    // of the working variables instead of moving the values.
+#define SHA256_ROUND(a, b, c, d, e, f, g, h, wk)                                                                         \
+    do                                                                                                                   \
+    {                                                                                                                    \
+        u32 const t1 = h + (sha256_ror(e, 6) ^ sha256_ror(e, 11) ^ sha256_ror(e, 25)) + (((f ^ g) & e) ^ g) + (wk);      \
+        u32 const t2 = (sha256_ror(a, 2) ^ sha256_ror(a, 13) ^ sha256_ror(a, 22)) + ((a & b) | (c & (a | b)));           \
+        d += t1;                                                                                                         \
+        h = t1 + t2;                                                                                                     \
+    } while (0)
+
+#define SHA512_ROUND(a, b, c, d, e, f, g, h, wk)                                                                         \
+    do                                                                                                                   \
+    {                                                                                                                    \
+        u64 const t1 = h + (sha512_ror(e, 14) ^ sha512_ror(e, 18) ^ sha512_ror(e, 41)) + (((f ^ g) & e) ^ g) + (wk);     \
+        u64 const t2 = (sha512_ror(a, 28) ^ sha512_ror(a, 34) ^ sha512_ror(a, 39)) + ((a & b) | (c & (a | b)));          \
+        d += t1;                                                                                                         \
+        h = t1 + t2;                                                                                                     \
+    } while (0)
+
+    // 8 rounds on wk[0..7]
+#define SHA2_ROUNDS8(ROUND, wk)                   \
+    do                                            \
+    {                                             \
+        ROUND(A, B, C, D, E, F, G, H, (wk)[0]);   \
+        ROUND(H, A, B, C, D, E, F, G, (wk)[1]);   \
+        ROUND(G, H, A, B, C, D, E, F, (wk)[2]);   \
+        ROUND(F, G, H, A, B, C, D, E, (wk)[3]);   \
+        ROUND(E, F, G, H, A, B, C, D, (wk)[4]);   \
+        ROUND(D, E, F, G, H, A, B, C, (wk)[5]);   \
+        ROUND(C, D, E, F, G, H, A, B, (wk)[6]);   \
+        ROUND(B, C, D, E, F, G, H, A, (wk)[7]);   \
+    } while (0)
+
+    static void sha256_blocks_scalar(u32* state, u8 const* blocks, uint_t nblocks)
+    {
+        u32 wk[64];
+        for (uint_t n = 0; n < nblocks; ++n, blocks += 64)
+        {
+            u32 w[64];
+            for (s32 t = 0; t < 16; ++t)
+                w[t] = sha256_read_be(blocks + 4 * t);
+            for (s32 t = 16; t < 64; ++t)
+            {
+                u32 const s0 = sha256_ror(w[t - 15], 7) ^ sha256_ror(w[t - 15], 18) ^ (w[t - 15] >> 3);
+                u32 const s1 = sha256_ror(w[t - 2], 17) ^ sha256_ror(w[t - 2], 19) ^ (w[t - 2] >> 10);
+                w[t]         = w[t - 16] + s0 + w[t - 7] + s1;
+            }
+            for (s32 t = 0; t < 64; ++t)
+                wk[t] = w[t] + s_sha256_k[t];
+
+            u32 A = state[0], B = state[1], C = state[2], D = state[3];
+            u32 E = state[4], F = state[5], G = state[6], H = state[7];
+            for (s32 t = 0; t < 64; t += 8)
+                SHA2_ROUNDS8(SHA256_ROUND, wk + t);
+
+            state[0] += A;
+            state[1] += B;
+            state[2] += C;
+            state[3] += D;
+            state[4] += E;
+            state[5] += F;
+            state[6] += G;
+            state[7] += H;
+        }
+    }
+
+    static void sha512_blocks_scalar(u64* state, u8 const* blocks, uint_t nblocks)
+    {
+        u64 wk[80];
+        for (uint_t n = 0; n < nblocks; ++n, blocks += 128)
+        {
+            u64 w[80];
+            for (s32 t = 0; t < 16; ++t)
+                w[t] = sha512_read_be(blocks + 8 * t);
+            for (s32 t = 16; t < 80; ++t)
+            {
+                u64 const s0 = sha512_ror(w[t - 15], 1) ^ sha512_ror(w[t - 15], 8) ^ (w[t - 15] >> 7);
+                u64 const s1 = sha512_ror(w[t - 2], 19) ^ sha512_ror(w[t - 2], 61) ^ (w[t - 2] >> 6);
+                w[t]         = w[t - 16] + s0 + w[t - 7] + s1;
+            }
+            for (s32 t = 0; t < 80; ++t)
+                wk[t] = w[t] + s_sha512_k[t];
+
+            u64 A = state[0], B = state[1], C = state[2], D = state[3];
+            u64 E = state[4], F = state[5], G = state[6], H = state[7];
+            for (s32 t = 0; t < 80; t += 8)
+                SHA2_ROUNDS8(SHA512_ROUND, wk + t);
+
+            state[0] += A;
+            state[1] += B;
+            state[2] += C;
+            state[3] += D;
+            state[4] += E;
+            state[5] += F;
+            state[6] += G;
+            state[7] += H;
+        }
+    }
+
+#if defined(CHASH_X64)
+    // The message schedule is expanded 4 words at a time, W[t..t+3] from the previous 16 words in
+    // w0..w3. W[t+2] and W[t+3] depend on W[t] and W[t+1] of the same group, so sigma1 is applied
+    // to the low and then the high half. The rounds stay scalar and read W[t] + K[t] from memory.
+    //
+    // SHA-256 expands the schedule of two blocks at once, one per 128-bit lane.
+#    define SHA256_ROR_X8(x, n) _mm256_or_si256(_mm256_srli_epi32(x, n), _mm256_slli_epi32(x, 32 - (n)))
+#    define SHA512_ROR_X4(x, n) _mm256_or_si256(_mm256_srli_epi64(x, n), _mm256_slli_epi64(x, 64 - (n)))
+
+    CHASH_TARGET("avx2")
+    static inline __m256i sha256_schedule_avx2(__m256i& w0, __m256i& w1, __m256i& w2, __m256i& w3)
+    {
+        __m256i const zero = _mm256_setzero_si256();
+        __m256i const w15  = _mm256_alignr_epi8(w1, w0, 4);
+        __m256i const w7   = _mm256_alignr_epi8(w3, w2, 4);
+        __m256i const s0   = _mm256_xor_si256(_mm256_xor_si256(SHA256_ROR_X8(w15, 7), SHA256_ROR_X8(w15, 18)), _mm256_srli_epi32(w15, 3));
+        __m256i       x    = _mm256_add_epi32(_mm256_add_epi32(w0, s0), w7);
+
+        __m256i y  = _mm256_shuffle_epi32(w3, 0xFE);
+        __m256i s1 = _mm256_xor_si256(_mm256_xor_si256(SHA256_ROR_X8(y, 17), SHA256_ROR_X8(y, 19)), _mm256_srli_epi32(y, 10));
+        x          = _mm256_add_epi32(x, _mm256_blend_epi32(s1, zero, 0xCC));
+
+        y  = _mm256_shuffle_epi32(x, 0x40);
+        s1 = _mm256_xor_si256(_mm256_xor_si256(SHA256_ROR_X8(y, 17), SHA256_ROR_X8(y, 19)), _mm256_srli_epi32(y, 10));
+        x  = _mm256_add_epi32(x, _mm256_blend_epi32(s1, zero, 0x33));
+
+        w0 = w1;
+        w1 = w2;
+        w2 = w3;
+        w3 = x;
+        return x;
+    }
+
+    CHASH_TARGET("avx2")
+    static inline void sha256_store_wk_avx2(u32* wk0, u32* wk1, s32 g, __m256i w)
+    {
+        __m256i const k = _mm256_broadcastsi128_si256(_mm_loadu_si128((__m128i const*)(s_sha256_k + 4 * g)));
+        w               = _mm256_add_epi32(w, k);
+        _mm_storeu_si128((__m128i*)(wk0 + 4 * g), _mm256_castsi256_si128(w));
+        _mm_storeu_si128((__m128i*)(wk1 + 4 * g), _mm256_extracti128_si256(w, 1));
+    }
+
+    CHASH_TARGET("avx2")
+    static void sha256_blocks_avx2(u32* state, u8 const* blocks, uint_t nblocks)
+    {
+        __m256i const bswap = _mm256_set_epi8(12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3, 12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
+
+        u32 wk0[64];
+        u32 wk1[64];
+        for (uint_t n = 0; n < nblocks; n += 2, blocks += 128)
+        {
+            // With an odd number of blocks the last one is expanded twice and the second copy dropped
+            u8 const* b0 = blocks;
+            u8 const* b1 = (n + 1 < nblocks) ? blocks + 64 : blocks;
+
+            __m256i w[4];
+            for (s32 i = 0; i < 4; ++i)
+            {
+                __m256i const x = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((__m128i const*)b0 + i)), _mm_loadu_si128((__m128i const*)b1 + i), 1);
+                w[i]            = _mm256_shuffle_epi8(x, bswap);
+                sha256_store_wk_avx2(wk0, wk1, i, w[i]);
+            }
+
+            u32 A = state[0], B = state[1], C = state[2], D = state[3];
+            u32 E = state[4], F = state[5], G = state[6], H = state[7];
+
+            // The schedule runs 4 groups ahead of the rounds of the first block
+            for (s32 g = 0; g < 16; g += 2)
+            {
+                if (g + 4 < 16)
+                {
+                    sha256_store_wk_avx2(wk0, wk1, g + 4, sha256_schedule_avx2(w[0], w[1], w[2], w[3]));
+                    sha256_store_wk_avx2(wk0, wk1, g + 5, sha256_schedule_avx2(w[0], w[1], w[2], w[3]));
+                }
+                SHA2_ROUNDS8(SHA256_ROUND, wk0 + 4 * g);
+            }
+
+            state[0] += A;
+            state[1] += B;
+            state[2] += C;
+            state[3] += D;
+            state[4] += E;
+            state[5] += F;
+            state[6] += G;
+            state[7] += H;
+            if (n + 1 >= nblocks)
+                break;
+
+            A = state[0], B = state[1], C = state[2], D = state[3];
+            E = state[4], F = state[5], G = state[6], H = state[7];
+            for (s32 t = 0; t < 64; t += 8)
+                SHA2_ROUNDS8(SHA256_ROUND, wk1 + t);
+
+            state[0] += A;
+            state[1] += B;
+            state[2] += C;
+            state[3] += D;
+            state[4] += E;
+            state[5] += F;
+            state[6] += G;
+            state[7] += H;
+        }
+    }
+
+    CHASH_TARGET("avx2")
+    static inline __m256i sha512_schedule_avx2(__m256i& w0, __m256i& w1, __m256i& w2, __m256i& w3)
+    {
+        __m256i const zero = _mm256_setzero_si256();
+        __m256i const w15  = _mm256_alignr_epi8(_mm256_permute2x128_si256(w0, w1, 0x21), w0, 8);
+        __m256i const w7   = _mm256_alignr_epi8(_mm256_permute2x128_si256(w2, w3, 0x21), w2, 8);
+        __m256i const s0   = _mm256_xor_si256(_mm256_xor_si256(SHA512_ROR_X4(w15, 1), SHA512_ROR_X4(w15, 8)), _mm256_srli_epi64(w15, 7));
+        __m256i       x    = _mm256_add_epi64(_mm256_add_epi64(w0, s0), w7);
+
+        __m256i y  = _mm256_permute4x64_epi64(w3, 0xEE);
+        __m256i s1 = _mm256_xor_si256(_mm256_xor_si256(SHA512_ROR_X4(y, 19), SHA512_ROR_X4(y, 61)), _mm256_srli_epi64(y, 6));
+        x          = _mm256_add_epi64(x, _mm256_blend_epi32(s1, zero, 0xF0));
+
+        y  = _mm256_permute4x64_epi64(x, 0x44);
+        s1 = _mm256_xor_si256(_mm256_xor_si256(SHA512_ROR_X4(y, 19), SHA512_ROR_X4(y, 61)), _mm256_srli_epi64(y, 6));
+        x  = _mm256_add_epi64(x, _mm256_blend_epi32(s1, zero, 0x0F));
+
+        w0 = w1;
+        w1 = w2;
+        w2 = w3;
+        w3 = x;
+        return x;
+    }
+
+    CHASH_TARGET("avx2")
+    static inline void sha512_store_wk_avx2(u64* wk, s32 g, __m256i w)
+    {
+        __m256i const k = _mm256_loadu_si256((__m256i const*)(s_sha512_k + 4 * g));
+        _mm256_storeu_si256((__m256i*)(wk + 4 * g), _mm256_add_epi64(w, k));
+    }
+
+    CHASH_TARGET("avx2")
+    static void sha512_blocks_avx2(u64* state, u8 const* blocks, uint_t nblocks)
+    {
+        __m256i const bswap = _mm256_set_epi8(8, 9, 10, 11, 12, 13, 14, 15, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 0, 1, 2, 3, 4, 5, 6, 7);
+
+        u64 wk[80];
+        for (uint_t n = 0; n < nblocks; ++n, blocks += 128)
+        {
+            __m256i w[4];
+            for (s32 i = 0; i < 4; ++i)
+            {
+                w[i] = _mm256_shuffle_epi8(_mm256_loadu_si256((__m256i const*)blocks + i), bswap);
+                sha512_store_wk_avx2(wk, i, w[i]);
+            }
+
+            u64 A = state[0], B = state[1], C = state[2], D = state[3];
+            u64 E = state[4], F = state[5], G = state[6], H = state[7];
+
+            // The schedule runs 4 groups ahead of the rounds
+            for (s32 g = 0; g < 20; g += 2)
+            {
+                if (g + 4 < 20)
+                {
+                    sha512_store_wk_avx2(wk, g + 4, sha512_schedule_avx2(w[0], w[1], w[2], w[3]));
+                    sha512_store_wk_avx2(wk, g + 5, sha512_schedule_avx2(w[0], w[1], w[2], w[3]));
+                }
+                SHA2_ROUNDS8(SHA512_ROUND, wk + 4 * g);
+            }
+
+            state[0] += A;
+            state[1] += B;
+            state[2] += C;
+            state[3] += D;
+            state[4] += E;
+            state[5] += F;
+            state[6] += G;
+            state[7] += H;
+        }
+    }
+
+#    undef SHA256_ROR_X8
+#    undef SHA512_ROR_X4
+
+    // SHA extensions, each sha256rnds2 does 2 rounds with the state split over ABEF and CDGH.
+    // Group <I> covers rounds 4I..4I+3 with the message words in msg[I & 3], sha256msg1 and
+    // sha256msg2 compute the schedule 3 groups ahead.
+    template <s32 I> CHASH_TARGET("sha,ssse3,sse4.1") static inline void sha256_shani_group(__m128i& abef, __m128i& cdgh, __m128i* msg)
+    {
+        __m128i wk = _mm_add_epi32(msg[I & 3], _mm_loadu_si128((__m128i const*)(s_sha256_k + 4 * I)));
+        cdgh       = _mm_sha256rnds2_epu32(cdgh, abef, wk);
+        if (I >= 3 && I <= 14)
+        {
+            __m128i const t  = _mm_alignr_epi8(msg[I & 3], msg[(I - 1) & 3], 4);
+            msg[(I + 1) & 3] = _mm_sha256msg2_epu32(_mm_add_epi32(msg[(I + 1) & 3], t), msg[I & 3]);
+        }
+        wk   = _mm_shuffle_epi32(wk, 0x0E);
+        abef = _mm_sha256rnds2_epu32(abef, cdgh, wk);
+        if (I >= 1 && I <= 12)
+            msg[(I - 1) & 3] = _mm_sha256msg1_epu32(msg[(I - 1) & 3], msg[I & 3]);
+    }
+
+    CHASH_TARGET("sha,ssse3,sse4.1")
+    static void sha256_blocks_shani(u32* state, u8 const* blocks, uint_t nblocks)
+    {
+        __m128i const bswap = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+
+        __m128i const dcba = _mm_shuffle_epi32(_mm_loadu_si128((__m128i const*)state), 0xB1);
+        __m128i const hgfe = _mm_shuffle_epi32(_mm_loadu_si128((__m128i const*)(state + 4)), 0x1B);
+        __m128i       abef = _mm_alignr_epi8(dcba, hgfe, 8);
+        __m128i       cdgh = _mm_blend_epi16(hgfe, dcba, 0xF0);
+        for (uint_t n = 0; n < nblocks; ++n, blocks += 64)
+        {
+            __m128i const abef_save = abef;
+            __m128i const cdgh_save = cdgh;
+
+            __m128i msg[4];
+            msg[0] = _mm_shuffle_epi8(_mm_loadu_si128((__m128i const*)blocks + 0), bswap);
+            msg[1] = _mm_shuffle_epi8(_mm_loadu_si128((__m128i const*)blocks + 1), bswap);
+            msg[2] = _mm_shuffle_epi8(_mm_loadu_si128((__m128i const*)blocks + 2), bswap);
+            msg[3] = _mm_shuffle_epi8(_mm_loadu_si128((__m128i const*)blocks + 3), bswap);
+
+            sha256_shani_group<0>(abef, cdgh, msg);
+            sha256_shani_group<1>(abef, cdgh, msg);
+            sha256_shani_group<2>(abef, cdgh, msg);
+            sha256_shani_group<3>(abef, cdgh, msg);
+            sha256_shani_group<4>(abef, cdgh, msg);
+            sha256_shani_group<5>(abef, cdgh, msg);
+            sha256_shani_group<6>(abef, cdgh, msg);
+            sha256_shani_group<7>(abef, cdgh, msg);
+            sha256_shani_group<8>(abef, cdgh, msg);
+            sha256_shani_group<9>(abef, cdgh, msg);
+            sha256_shani_group<10>(abef, cdgh, msg);
+            sha256_shani_group<11>(abef, cdgh, msg);
+            sha256_shani_group<12>(abef, cdgh, msg);
+            sha256_shani_group<13>(abef, cdgh, msg);
+            sha256_shani_group<14>(abef, cdgh, msg);
+            sha256_shani_group<15>(abef, cdgh, msg);
+
+            abef = _mm_add_epi32(abef, abef_save);
+            cdgh = _mm_add_epi32(cdgh, cdgh_save);
+        }
+
+        __m128i const feba = _mm_shuffle_epi32(abef, 0x1B);
+        __m128i const dchg = _mm_shuffle_epi32(cdgh, 0xB1);
+        _mm_storeu_si128((__m128i*)state, _mm_blend_epi16(feba, dchg, 0xF0));
+        _mm_storeu_si128((__m128i*)(state + 4), _mm_alignr_epi8(dchg, feba, 8));
+    }
+#endif
+
+#undef SHA2_ROUNDS8
+#undef SHA256_ROUND
+#undef SHA512_ROUND
+
+    static sha256_blocks_fn sha256_kernel()
+    {
+#if defined(CHASH_X64)
+        if (nhash_cpu::has(nhash_cpu::SHA | nhash_cpu::SSSE3 | nhash_cpu::SSE41))
+            return sha256_blocks_shani;
+        if (nhash_cpu::has(nhash_cpu::AVX2))
+            return sha256_blocks_avx2;
+#endif
+        return sha256_blocks_scalar;
+    }
+
+    static sha512_blocks_fn sha512_kernel()
+    {
+#if defined(CHASH_X64)
+        if (nhash_cpu::has(nhash_cpu::AVX2))
+            return sha512_blocks_avx2;
+#endif
+        return sha512_blocks_scalar;
+    }
+
+    static void sha2_blocks(u32* state, u8 const* blocks, uint_t nblocks) { sha256_kernel()(state, blocks, nblocks); }
+    static void sha2_blocks(u64* state, u8 const* blocks, uint_t nblocks) { sha512_kernel()(state, blocks, nblocks); }
+
+    // The streaming context of both, T is the word size (u32 for SHA-256, u64 for SHA-512). Whole
+    // blocks are processed straight from the input, only a partial block is kept in m_buffer.
+    template <typename T> struct sha2_ctxt_t
+    {
+        enum
+        {
+            BLOCK_SIZE  = 16 * sizeof(T),
+            LENGTH_SIZE = 2 * sizeof(T), // The message length in bits is stored in the last 8 or 16 bytes
+        };
+
+        u64 m_total_len;
+        T   m_state[8];
+        u8  m_buffer[BLOCK_SIZE];
+
+        void reset(T const* iv)
+        {
+            m_total_len = 0;
+            for (s32 i = 0; i < 8; ++i)
+                m_state[i] = iv[i];
+        }
+
+        void update(u8 const* p, u64 len)
+        {
+            u32 const used = (u32)(m_total_len & (BLOCK_SIZE - 1));
+            m_total_len += len;
+
+            if (used != 0)
+            {
+                u32 const fill = (len < (u64)(BLOCK_SIZE - used)) ? (u32)len : (u32)(BLOCK_SIZE - used);
+                nmem::memcpy(m_buffer + used, p, fill);
+                if (used + fill < BLOCK_SIZE)
+                    return;
+                sha2_blocks(m_state, m_buffer, 1);
+                p += fill;
+                len -= fill;
+            }
+
+            if (len >= BLOCK_SIZE)
+            {
+                sha2_blocks(m_state, p, (uint_t)(len / BLOCK_SIZE));
+                p += len & ~(u64)(BLOCK_SIZE - 1);
+                len &= BLOCK_SIZE - 1;
+            }
+            if (len != 0)
+                nmem::memcpy(m_buffer, p, (u32)len);
+        }
+
+        // Pad with 0x80, zeroes and the length, the state is final after this
+        void close()
+        {
+            u32 used        = (u32)(m_total_len & (BLOCK_SIZE - 1));
+            m_buffer[used++] = 0x80;
+            if (used > BLOCK_SIZE - LENGTH_SIZE)
+            {
+                nmem::memclr(m_buffer + used, BLOCK_SIZE - used);
+                sha2_blocks(m_state, m_buffer, 1);
+                used = 0;
+            }
+            nmem::memclr(m_buffer + used, BLOCK_SIZE - used);
+
+            u64 const bits_lo = m_total_len << 3;
+            u64 const bits_hi = m_total_len >> 61;
+            for (s32 i = 0; i < 8; ++i)
+            {
+                m_buffer[BLOCK_SIZE - 1 - i] = (u8)(bits_lo >> (8 * i));
+                if (LENGTH_SIZE > 8)
+                    m_buffer[BLOCK_SIZE - 9 - i] = (u8)(bits_hi >> (8 * i));
+            }
+            sha2_blocks(m_state, m_buffer, 1);
+        }
+
+        // The digest is the state as big-endian words
+        void digest(u8* out) const
+        {
+            for (s32 i = 0; i < 8; ++i)
+                for (s32 b = 0; b < (s32)sizeof(T); ++b)
+                    out[i * sizeof(T) + b] = (u8)(m_state[i] >> (8 * (sizeof(T) - 1 - b)));
+        }
+    };
+
+    typedef sha2_ctxt_t<u32> sha256_ctxt_t;
+    typedef sha2_ctxt_t<u64> sha512_ctxt_t;
+
+    namespace nhash_private
+    {
+        static_assert(sizeof(sha256_ctxt_t) <= sizeof(sha256_t::m_ctxt), "sha256_t context too small");
+        static_assert(sizeof(sha512_ctxt_t) <= sizeof(sha512_t::m_ctxt), "sha512_t context too small");
+
+        void sha256_t::reset(u64 seed)
+        {
+            sha256_ctxt_t* ctx = (sha256_ctxt_t*)&this->m_ctxt;
+            ctx->reset(s_sha256_iv);
+            m_computed = 0;
+        }
+
+        void sha256_t::hash(const u8* begin, const u8* end)
+        {
+            sha256_ctxt_t* ctx = (sha256_ctxt_t*)&this->m_ctxt;
+            ctx->update(begin, (u64)(end - begin));
+        }
+
+        void sha256_t::end(u8* _hash)
+        {
+            sha256_ctxt_t* ctx = (sha256_ctxt_t*)&this->m_ctxt;
+            if (m_computed == 0)
+            {
+                ctx->close();
+                m_computed = 1;
+            }
+            ctx->digest(_hash);
+        }
+
+        void sha512_t::reset(u64 seed)
+        {
+            sha512_ctxt_t* ctx = (sha512_ctxt_t*)&this->m_ctxt;
+            ctx->reset(s_sha512_iv);
+            m_computed = 0;
+        }
+
+        void sha512_t::hash(const u8* begin, const u8* end)
+        {
+            sha512_ctxt_t* ctx = (sha512_ctxt_t*)&this->m_ctxt;
+            ctx->update(begin, (u64)(end - begin));
+        }
+
+        void sha512_t::end(u8* _hash)
+        {
+            sha512_ctxt_t* ctx = (sha512_ctxt_t*)&this->m_ctxt;
+            if (m_computed == 0)
+            {
+                ctx->close();
+                m_computed = 1;
+            }
+            ctx->digest(_hash);
+        }
+    } // namespace nhash_private
+
+    namespace nhash
+    {
+        sha256 hash_sha256(u8 const* data, u64 len)
+        {
+            sha256_ctxt_t ctx;
+            ctx.reset(s_sha256_iv);
+            ctx.update(data, len);
+            ctx.close();
+
+            sha256 digest;
+            ctx.digest(digest.m_data);
+            return digest;
+        }
+
+        sha512 hash_sha512(u8 const* data, u64 len)
+        {
+            sha512_ctxt_t ctx;
+            ctx.reset(s_sha512_iv);
+            ctx.update(data, len);
+            ctx.close();
+
+            sha512 digest;
+            ctx.digest(digest.m_data);
+            return digest;
+        }
+    } // namespace nhash
+
+} // namespace ncore
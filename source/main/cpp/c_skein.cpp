@@ -1,7 +1,14 @@
 #include "ccore/c_target.h"
 #include "cbase/c_memory.h"
+#include "chash/c_hash.h"
+#include "chash/c_hash_jobs.h"
+#include "chash/private/c_hash_cpu.h"
 #include "chash/private/c_internal_hash.h"
 
+#if defined(CHASH_X64)
+#    include <immintrin.h>
+#endif
+
 namespace ncore
 {
     namespace skein
@@ -159,9 +166,9 @@ namespace ncore
         s32 Skein_512_Init(Skein_512_Ctxt_t* ctx, u32 hashBitLen);
         s32 Skein1024_Init(Skein1024_Ctxt_t* ctx, u32 hashBitLen);
 
-        s32 Skein_256_Update(Skein_256_Ctxt_t* ctx, const u8* msg, u32 msgByteCnt);
-        s32 Skein_512_Update(Skein_512_Ctxt_t* ctx, const u8* msg, u32 msgByteCnt);
-        s32 Skein1024_Update(Skein1024_Ctxt_t* ctx, const u8* msg, u32 msgByteCnt);
+        s32 Skein_256_Update(Skein_256_Ctxt_t* ctx, const u8* msg, u64 msgByteCnt);
+        s32 Skein_512_Update(Skein_512_Ctxt_t* ctx, const u8* msg, u64 msgByteCnt);
+        s32 Skein1024_Update(Skein1024_Ctxt_t* ctx, const u8* msg, u64 msgByteCnt);
 
         s32 Skein_256_Final(Skein_256_Ctxt_t* ctx, u8* hashVal);
         s32 Skein_512_Final(Skein_512_Ctxt_t* ctx, u8* hashVal);
@@ -181,6 +188,23 @@ namespace ncore
         **              to precompute the MAC IV, then a copy of the context saved and
         **              reused for each new MAC computation.
         **/
+        s32 Skein_256_InitExt(Skein_256_Ctxt_t* ctx, u32 hashBitLen, u64 treeInfo, const u8* key, u64 keyBytes);
+        s32 Skein_512_InitExt(Skein_512_Ctxt_t* ctx, u32 hashBitLen, u64 treeInfo, const u8* key, u64 keyBytes);
+        s32 Skein1024_InitExt(Skein1024_Ctxt_t* ctx, u32 hashBitLen, u64 treeInfo, const u8* key, u64 keyBytes);
+
+        /*
+        **   Skein APIs for tree hash:
+        **      Final_Pad: pad, do final block, but no OUTPUT type
+        **      Output:    do just the output stage
+        */
+        s32 Skein_256_Final_Pad(Skein_256_Ctxt_t* ctx, u8* hashVal);
+        s32 Skein_512_Final_Pad(Skein_512_Ctxt_t* ctx, u8* hashVal);
+        s32 Skein1024_Final_Pad(Skein1024_Ctxt_t* ctx, u8* hashVal);
+
+        s32 Skein_256_Output(Skein_256_Ctxt_t* ctx, u8* hashVal);
+        s32 Skein_512_Output(Skein_512_Ctxt_t* ctx, u8* hashVal);
+        s32 Skein1024_Output(Skein1024_Ctxt_t* ctx, u8* hashVal);
+
 
 /* tweak word T[1]: bit field starting positions */
 #define SKEIN_T1_BIT(BIT) ((BIT) - 64) /* offset 64 because it's the second word  */
@@ -500,7 +524,7 @@ namespace ncore
 #endif
 
         /*****************************  Skein_256 ******************************/
-        void Skein_256_Process_Block(Skein_256_Ctxt_t* ctx, const u8* blkPtr, u32 blkCnt, u32 byteCntAdd)
+        void Skein_256_Process_Block(Skein_256_Ctxt_t* ctx, const u8* blkPtr, u64 blkCnt, u32 byteCntAdd)
         { /* do it in C */
             enum
             {
@@ -675,7 +699,7 @@ namespace ncore
 
 /*****************************  Skein_512 ******************************/
 #if 1
-        void Skein_512_Process_Block(Skein_512_Ctxt_t* ctx, const u8* blkPtr, u32 blkCnt, u32 byteCntAdd)
+        void Skein_512_Process_Block(Skein_512_Ctxt_t* ctx, const u8* blkPtr, u64 blkCnt, u32 byteCntAdd)
         { /* do it in C */
             enum
             {
@@ -881,7 +905,7 @@ namespace ncore
 
 /*****************************  Skein1024 ******************************/
 #if 1
-        void Skein1024_Process_Block(Skein1024_Ctxt_t* ctx, const u8* blkPtr, u32 blkCnt, u32 byteCntAdd)
+        void Skein1024_Process_Block(Skein1024_Ctxt_t* ctx, const u8* blkPtr, u64 blkCnt, u32 byteCntAdd)
         { /* do it in C, always looping (unrolled is bigger AND slower!) */
             enum
             {
@@ -1147,11 +1171,342 @@ namespace ncore
 
 #endif
 
+#if defined(CHASH_X64) && !defined(SKEIN_ROUNDS)
+        /*****************************************************************/
+        /*     AVX2, 4 independent blocks                                */
+        /*****************************************************************/
+
+        // Threefish needs 64-bit rotates which AVX2 does not have, a rotate takes 3 instructions and a
+        // single block spread over the lanes also needs a permute every round, so one block at a time is
+        // slower than the scalar code. Four contexts (the leaves of a tree) are instead processed side by
+        // side, lane l of every vector holds word i of context l, the rounds then match the scalar code
+        // word for word and the word permutation costs nothing. The contexts see the same byteCntAdd.
+
+#    define Skein_X4_RotL(x, N) _mm256_or_si256(_mm256_slli_epi64(x, N), _mm256_srli_epi64(x, 64 - (N)))
+
+#    define Skein_X4_Mix(p0, p1, ROT)           \
+        X##p0 = _mm256_add_epi64(X##p0, X##p1); \
+        X##p1 = _mm256_xor_si256(Skein_X4_RotL(X##p1, ROT), X##p0);
+
+        // 4x4 transpose of 64-bit words, rows to columns and back
+        CHASH_TARGET("avx2")
+        static inline void Skein_X4_Transpose(__m256i& v0, __m256i& v1, __m256i& v2, __m256i& v3)
+        {
+            __m256i const t0 = _mm256_unpacklo_epi64(v0, v1);
+            __m256i const t1 = _mm256_unpackhi_epi64(v0, v1);
+            __m256i const t2 = _mm256_unpacklo_epi64(v2, v3);
+            __m256i const t3 = _mm256_unpackhi_epi64(v2, v3);
+            v0               = _mm256_permute2x128_si256(t0, t2, 0x20);
+            v1               = _mm256_permute2x128_si256(t1, t3, 0x20);
+            v2               = _mm256_permute2x128_si256(t0, t2, 0x31);
+            v3               = _mm256_permute2x128_si256(t1, t3, 0x31);
+        }
+
+        // Words [i, i+4) of the 4 rows
+        CHASH_TARGET("avx2")
+        static inline void Skein_X4_Load(__m256i* v, const void* const* rows, u32 i)
+        {
+            v[0] = _mm256_loadu_si256((__m256i const*)((const u64*)rows[0] + i));
+            v[1] = _mm256_loadu_si256((__m256i const*)((const u64*)rows[1] + i));
+            v[2] = _mm256_loadu_si256((__m256i const*)((const u64*)rows[2] + i));
+            v[3] = _mm256_loadu_si256((__m256i const*)((const u64*)rows[3] + i));
+            Skein_X4_Transpose(v[0], v[1], v[2], v[3]);
+        }
+
+        CHASH_TARGET("avx2")
+        static inline void Skein_X4_Store(void* const* rows, u32 i, __m256i v0, __m256i v1, __m256i v2, __m256i v3)
+        {
+            Skein_X4_Transpose(v0, v1, v2, v3);
+            _mm256_storeu_si256((__m256i*)((u64*)rows[0] + i), v0);
+            _mm256_storeu_si256((__m256i*)((u64*)rows[1] + i), v1);
+            _mm256_storeu_si256((__m256i*)((u64*)rows[2] + i), v2);
+            _mm256_storeu_si256((__m256i*)((u64*)rows[3] + i), v3);
+        }
+
+        template <typename C> CHASH_TARGET("avx2") static inline void Skein_X4_Load_Tweak(const C* ctx, __m256i& t0, __m256i& t1)
+        {
+            t0 = _mm256_setr_epi64x((s64)ctx[0].h.T[0], (s64)ctx[1].h.T[0], (s64)ctx[2].h.T[0], (s64)ctx[3].h.T[0]);
+            t1 = _mm256_setr_epi64x((s64)ctx[0].h.T[1], (s64)ctx[1].h.T[1], (s64)ctx[2].h.T[1], (s64)ctx[3].h.T[1]);
+        }
+
+        template <typename C> CHASH_TARGET("avx2") static inline void Skein_X4_Store_Tweak(C* ctx, __m256i t0, __m256i t1)
+        {
+            u64 T0[4], T1[4];
+            _mm256_storeu_si256((__m256i*)T0, t0);
+            _mm256_storeu_si256((__m256i*)T1, t1);
+            for (u32 l = 0; l < 4; ++l)
+            {
+                ctx[l].h.T[0] = T0[l];
+                ctx[l].h.T[1] = T1[l];
+            }
+        }
+
+        CHASH_TARGET("avx2")
+        static void Skein_512_Process_Block_X4_AVX2(Skein_512_Ctxt_t* ctx, const u8* const* blkPtr, u64 blkCnt, u32 byteCntAdd)
+        {
+            __m256i     kv[9], tv[3], w[8];
+            __m256i     X0, X1, X2, X3, X4, X5, X6, X7;
+            const void* blk[4]  = {blkPtr[0], blkPtr[1], blkPtr[2], blkPtr[3]};
+            void* const cvs[4]  = {ctx[0].X, ctx[1].X, ctx[2].X, ctx[3].X};
+            __m256i const first = _mm256_set1_epi64x((s64)SKEIN_T1_FLAG_FIRST);
+
+            Skein_assert(blkCnt != 0); /* never call with blkCnt == 0! */
+            Skein_X4_Load(kv + 0, (const void* const*)cvs, 0);
+            Skein_X4_Load(kv + 4, (const void* const*)cvs, 4);
+            Skein_X4_Load_Tweak(ctx, tv[0], tv[1]);
+            do
+            {
+                tv[0] = _mm256_add_epi64(tv[0], _mm256_set1_epi64x(byteCntAdd));
+                tv[2] = _mm256_xor_si256(tv[0], tv[1]);
+                kv[8] = _mm256_set1_epi64x((s64)SKEIN_KS_PARITY);
+                for (u32 i = 0; i < 8; ++i)
+                    kv[8] = _mm256_xor_si256(kv[8], kv[i]);
+
+                Skein_X4_Load(w + 0, blk, 0);
+                Skein_X4_Load(w + 4, blk, 4);
+
+                X0 = _mm256_add_epi64(w[0], kv[0]);
+                X1 = _mm256_add_epi64(w[1], kv[1]);
+                X2 = _mm256_add_epi64(w[2], kv[2]);
+                X3 = _mm256_add_epi64(w[3], kv[3]);
+                X4 = _mm256_add_epi64(w[4], kv[4]);
+                X5 = _mm256_add_epi64(_mm256_add_epi64(w[5], kv[5]), tv[0]);
+                X6 = _mm256_add_epi64(_mm256_add_epi64(w[6], kv[6]), tv[1]);
+                X7 = _mm256_add_epi64(w[7], kv[7]);
+
+#    define R512_X4(p0, p1, p2, p3, p4, p5, p6, p7, ROT) \
+        Skein_X4_Mix(p0, p1, ROT##_0);                   \
+        Skein_X4_Mix(p2, p3, ROT##_1);                   \
+        Skein_X4_Mix(p4, p5, ROT##_2);                   \
+        Skein_X4_Mix(p6, p7, ROT##_3);
+
+#    define I512_X4(R)                                                                     \
+        X0 = _mm256_add_epi64(X0, kv[((R) + 1) % 9]);                                      \
+        X1 = _mm256_add_epi64(X1, kv[((R) + 2) % 9]);                                      \
+        X2 = _mm256_add_epi64(X2, kv[((R) + 3) % 9]);                                      \
+        X3 = _mm256_add_epi64(X3, kv[((R) + 4) % 9]);                                      \
+        X4 = _mm256_add_epi64(X4, kv[((R) + 5) % 9]);                                      \
+        X5 = _mm256_add_epi64(X5, _mm256_add_epi64(kv[((R) + 6) % 9], tv[((R) + 1) % 3])); \
+        X6 = _mm256_add_epi64(X6, _mm256_add_epi64(kv[((R) + 7) % 9], tv[((R) + 2) % 3])); \
+        X7 = _mm256_add_epi64(X7, _mm256_add_epi64(kv[((R) + 8) % 9], _mm256_set1_epi64x((R) + 1)));
+
+#    define R512_X4_8_rounds(R)                   \
+        R512_X4(0, 1, 2, 3, 4, 5, 6, 7, R_512_0); \
+        R512_X4(2, 1, 4, 7, 6, 5, 0, 3, R_512_1); \
+        R512_X4(4, 1, 6, 3, 0, 5, 2, 7, R_512_2); \
+        R512_X4(6, 1, 0, 7, 2, 5, 4, 3, R_512_3); \
+        I512_X4(2 * (R));                         \
+        R512_X4(0, 1, 2, 3, 4, 5, 6, 7, R_512_4); \
+        R512_X4(2, 1, 4, 7, 6, 5, 0, 3, R_512_5); \
+        R512_X4(4, 1, 6, 3, 0, 5, 2, 7, R_512_6); \
+        R512_X4(6, 1, 0, 7, 2, 5, 4, 3, R_512_7); \
+        I512_X4(2 * (R) + 1);
+
+                R512_X4_8_rounds(0);
+                R512_X4_8_rounds(1);
+                R512_X4_8_rounds(2);
+                R512_X4_8_rounds(3);
+                R512_X4_8_rounds(4);
+                R512_X4_8_rounds(5);
+                R512_X4_8_rounds(6);
+                R512_X4_8_rounds(7);
+                R512_X4_8_rounds(8);
+
+                /* do the final "feedforward" xor, the result is the key of the next block */
+                kv[0] = _mm256_xor_si256(X0, w[0]);
+                kv[1] = _mm256_xor_si256(X1, w[1]);
+                kv[2] = _mm256_xor_si256(X2, w[2]);
+                kv[3] = _mm256_xor_si256(X3, w[3]);
+                kv[4] = _mm256_xor_si256(X4, w[4]);
+                kv[5] = _mm256_xor_si256(X5, w[5]);
+                kv[6] = _mm256_xor_si256(X6, w[6]);
+                kv[7] = _mm256_xor_si256(X7, w[7]);
+
+                tv[1] = _mm256_andnot_si256(first, tv[1]);
+                for (u32 l = 0; l < 4; ++l)
+                    blk[l] = (const u8*)blk[l] + SKEIN_512_BLOCK_BYTES;
+            } while (--blkCnt);
+
+            Skein_X4_Store(cvs, 0, kv[0], kv[1], kv[2], kv[3]);
+            Skein_X4_Store(cvs, 4, kv[4], kv[5], kv[6], kv[7]);
+            Skein_X4_Store_Tweak(ctx, tv[0], tv[1]);
+        }
+
+        CHASH_TARGET("avx2")
+        static void Skein1024_Process_Block_X4_AVX2(Skein1024_Ctxt_t* ctx, const u8* const* blkPtr, u64 blkCnt, u32 byteCntAdd)
+        {
+            __m256i     kv[17], tv[3], w[16];
+            __m256i     X00, X01, X02, X03, X04, X05, X06, X07, X08, X09, X10, X11, X12, X13, X14, X15;
+            const void* blk[4]  = {blkPtr[0], blkPtr[1], blkPtr[2], blkPtr[3]};
+            void* const cvs[4]  = {ctx[0].X, ctx[1].X, ctx[2].X, ctx[3].X};
+            __m256i const first = _mm256_set1_epi64x((s64)SKEIN_T1_FLAG_FIRST);
+
+            Skein_assert(blkCnt != 0); /* never call with blkCnt == 0! */
+            Skein_X4_Load(kv + 0, (const void* const*)cvs, 0);
+            Skein_X4_Load(kv + 4, (const void* const*)cvs, 4);
+            Skein_X4_Load(kv + 8, (const void* const*)cvs, 8);
+            Skein_X4_Load(kv + 12, (const void* const*)cvs, 12);
+            Skein_X4_Load_Tweak(ctx, tv[0], tv[1]);
+            do
+            {
+                tv[0]  = _mm256_add_epi64(tv[0], _mm256_set1_epi64x(byteCntAdd));
+                tv[2]  = _mm256_xor_si256(tv[0], tv[1]);
+                kv[16] = _mm256_set1_epi64x((s64)SKEIN_KS_PARITY);
+                for (u32 i = 0; i < 16; ++i)
+                    kv[16] = _mm256_xor_si256(kv[16], kv[i]);
+
+                Skein_X4_Load(w + 0, blk, 0);
+                Skein_X4_Load(w + 4, blk, 4);
+                Skein_X4_Load(w + 8, blk, 8);
+                Skein_X4_Load(w + 12, blk, 12);
+
+                X00 = _mm256_add_epi64(w[0], kv[0]);
+                X01 = _mm256_add_epi64(w[1], kv[1]);
+                X02 = _mm256_add_epi64(w[2], kv[2]);
+                X03 = _mm256_add_epi64(w[3], kv[3]);
+                X04 = _mm256_add_epi64(w[4], kv[4]);
+                X05 = _mm256_add_epi64(w[5], kv[5]);
+                X06 = _mm256_add_epi64(w[6], kv[6]);
+                X07 = _mm256_add_epi64(w[7], kv[7]);
+                X08 = _mm256_add_epi64(w[8], kv[8]);
+                X09 = _mm256_add_epi64(w[9], kv[9]);
+                X10 = _mm256_add_epi64(w[10], kv[10]);
+                X11 = _mm256_add_epi64(w[11], kv[11]);
+                X12 = _mm256_add_epi64(w[12], kv[12]);
+                X13 = _mm256_add_epi64(_mm256_add_epi64(w[13], kv[13]), tv[0]);
+                X14 = _mm256_add_epi64(_mm256_add_epi64(w[14], kv[14]), tv[1]);
+                X15 = _mm256_add_epi64(w[15], kv[15]);
+
+#    define R1024_X4(p0, p1, p2, p3, p4, p5, p6, p7, p8, p9, pA, pB, pC, pD, pE, pF, ROT) \
+        Skein_X4_Mix(p0, p1, ROT##_0);                                                    \
+        Skein_X4_Mix(p2, p3, ROT##_1);                                                    \
+        Skein_X4_Mix(p4, p5, ROT##_2);                                                    \
+        Skein_X4_Mix(p6, p7, ROT##_3);                                                    \
+        Skein_X4_Mix(p8, p9, ROT##_4);                                                    \
+        Skein_X4_Mix(pA, pB, ROT##_5);                                                    \
+        Skein_X4_Mix(pC, pD, ROT##_6);                                                    \
+        Skein_X4_Mix(pE, pF, ROT##_7);
+
+#    define I1024_X4(R)                                                                        \
+        X00 = _mm256_add_epi64(X00, kv[((R) + 1) % 17]);                                       \
+        X01 = _mm256_add_epi64(X01, kv[((R) + 2) % 17]);                                       \
+        X02 = _mm256_add_epi64(X02, kv[((R) + 3) % 17]);                                       \
+        X03 = _mm256_add_epi64(X03, kv[((R) + 4) % 17]);                                       \
+        X04 = _mm256_add_epi64(X04, kv[((R) + 5) % 17]);                                       \
+        X05 = _mm256_add_epi64(X05, kv[((R) + 6) % 17]);                                       \
+        X06 = _mm256_add_epi64(X06, kv[((R) + 7) % 17]);                                       \
+        X07 = _mm256_add_epi64(X07, kv[((R) + 8) % 17]);                                       \
+        X08 = _mm256_add_epi64(X08, kv[((R) + 9) % 17]);                                       \
+        X09 = _mm256_add_epi64(X09, kv[((R) + 10) % 17]);                                      \
+        X10 = _mm256_add_epi64(X10, kv[((R) + 11) % 17]);                                      \
+        X11 = _mm256_add_epi64(X11, kv[((R) + 12) % 17]);                                      \
+        X12 = _mm256_add_epi64(X12, kv[((R) + 13) % 17]);                                      \
+        X13 = _mm256_add_epi64(X13, _mm256_add_epi64(kv[((R) + 14) % 17], tv[((R) + 1) % 3])); \
+        X14 = _mm256_add_epi64(X14, _mm256_add_epi64(kv[((R) + 15) % 17], tv[((R) + 2) % 3])); \
+        X15 = _mm256_add_epi64(X15, _mm256_add_epi64(kv[((R) + 16) % 17], _mm256_set1_epi64x((R) + 1)));
+
+#    define R1024_X4_8_rounds(R)                                                           \
+        R1024_X4(00, 01, 02, 03, 04, 05, 06, 07, 08, 09, 10, 11, 12, 13, 14, 15, R1024_0); \
+        R1024_X4(00, 09, 02, 13, 06, 11, 04, 15, 10, 07, 12, 03, 14, 05, 08, 01, R1024_1); \
+        R1024_X4(00, 07, 02, 05, 04, 03, 06, 01, 12, 15, 14, 13, 08, 11, 10, 09, R1024_2); \
+        R1024_X4(00, 15, 02, 11, 06, 13, 04, 09, 14, 01, 08, 05, 10, 03, 12, 07, R1024_3); \
+        I1024_X4(2 * (R));                                                                 \
+        R1024_X4(00, 01, 02, 03, 04, 05, 06, 07, 08, 09, 10, 11, 12, 13, 14, 15, R1024_4); \
+        R1024_X4(00, 09, 02, 13, 06, 11, 04, 15, 10, 07, 12, 03, 14, 05, 08, 01, R1024_5); \
+        R1024_X4(00, 07, 02, 05, 04, 03, 06, 01, 12, 15, 14, 13, 08, 11, 10, 09, R1024_6); \
+        R1024_X4(00, 15, 02, 11, 06, 13, 04, 09, 14, 01, 08, 05, 10, 03, 12, 07, R1024_7); \
+        I1024_X4(2 * (R) + 1);
+
+                R1024_X4_8_rounds(0);
+                R1024_X4_8_rounds(1);
+                R1024_X4_8_rounds(2);
+                R1024_X4_8_rounds(3);
+                R1024_X4_8_rounds(4);
+                R1024_X4_8_rounds(5);
+                R1024_X4_8_rounds(6);
+                R1024_X4_8_rounds(7);
+                R1024_X4_8_rounds(8);
+                R1024_X4_8_rounds(9);
+
+                /* do the final "feedforward" xor, the result is the key of the next block */
+                kv[0]  = _mm256_xor_si256(X00, w[0]);
+                kv[1]  = _mm256_xor_si256(X01, w[1]);
+                kv[2]  = _mm256_xor_si256(X02, w[2]);
+                kv[3]  = _mm256_xor_si256(X03, w[3]);
+                kv[4]  = _mm256_xor_si256(X04, w[4]);
+                kv[5]  = _mm256_xor_si256(X05, w[5]);
+                kv[6]  = _mm256_xor_si256(X06, w[6]);
+                kv[7]  = _mm256_xor_si256(X07, w[7]);
+                kv[8]  = _mm256_xor_si256(X08, w[8]);
+                kv[9]  = _mm256_xor_si256(X09, w[9]);
+                kv[10] = _mm256_xor_si256(X10, w[10]);
+                kv[11] = _mm256_xor_si256(X11, w[11]);
+                kv[12] = _mm256_xor_si256(X12, w[12]);
+                kv[13] = _mm256_xor_si256(X13, w[13]);
+                kv[14] = _mm256_xor_si256(X14, w[14]);
+                kv[15] = _mm256_xor_si256(X15, w[15]);
+
+                tv[1] = _mm256_andnot_si256(first, tv[1]);
+                for (u32 l = 0; l < 4; ++l)
+                    blk[l] = (const u8*)blk[l] + SKEIN1024_BLOCK_BYTES;
+            } while (--blkCnt);
+
+            Skein_X4_Store(cvs, 0, kv[0], kv[1], kv[2], kv[3]);
+            Skein_X4_Store(cvs, 4, kv[4], kv[5], kv[6], kv[7]);
+            Skein_X4_Store(cvs, 8, kv[8], kv[9], kv[10], kv[11]);
+            Skein_X4_Store(cvs, 12, kv[12], kv[13], kv[14], kv[15]);
+            Skein_X4_Store_Tweak(ctx, tv[0], tv[1]);
+        }
+
+#    undef R512_X4
+#    undef I512_X4
+#    undef R512_X4_8_rounds
+#    undef R1024_X4
+#    undef I1024_X4
+#    undef R1024_X4_8_rounds
+#    undef Skein_X4_Mix
+#    undef Skein_X4_RotL
+#endif
+
+        // Process <blkCnt> blocks of each of the 4 contexts <ctx>, context l reads its blocks from blkPtr[l]
+        typedef void (*Skein_512_Process_Block_X4_fn)(Skein_512_Ctxt_t* ctx, const u8* const* blkPtr, u64 blkCnt, u32 byteCntAdd);
+        typedef void (*Skein1024_Process_Block_X4_fn)(Skein1024_Ctxt_t* ctx, const u8* const* blkPtr, u64 blkCnt, u32 byteCntAdd);
+
+        static void Skein_512_Process_Block_X4_Portable(Skein_512_Ctxt_t* ctx, const u8* const* blkPtr, u64 blkCnt, u32 byteCntAdd)
+        {
+            for (u32 l = 0; l < 4; ++l)
+                Skein_512_Process_Block(&ctx[l], blkPtr[l], blkCnt, byteCntAdd);
+        }
+
+        static void Skein1024_Process_Block_X4_Portable(Skein1024_Ctxt_t* ctx, const u8* const* blkPtr, u64 blkCnt, u32 byteCntAdd)
+        {
+            for (u32 l = 0; l < 4; ++l)
+                Skein1024_Process_Block(&ctx[l], blkPtr[l], blkCnt, byteCntAdd);
+        }
+
+        static Skein_512_Process_Block_X4_fn Skein_512_X4_Kernel()
+        {
+#if defined(CHASH_X64) && !defined(SKEIN_ROUNDS)
+            if (nhash_cpu::has(nhash_cpu::AVX2))
+                return Skein_512_Process_Block_X4_AVX2;
+#endif
+            return Skein_512_Process_Block_X4_Portable;
+        }
+
+        static Skein1024_Process_Block_X4_fn Skein1024_X4_Kernel()
+        {
+#if defined(CHASH_X64) && !defined(SKEIN_ROUNDS)
+            if (nhash_cpu::has(nhash_cpu::AVX2))
+                return Skein1024_Process_Block_X4_AVX2;
+#endif
+            return Skein1024_Process_Block_X4_Portable;
+        }
+
         /*****************************************************************/
         /* External function to process blkCnt (nonzero) full block(s) of data. */
-        void Skein_256_Process_Block(Skein_256_Ctxt_t* ctx, const u8* blkPtr, u32 blkCnt, u32 byteCntAdd);
-        void Skein_512_Process_Block(Skein_512_Ctxt_t* ctx, const u8* blkPtr, u32 blkCnt, u32 byteCntAdd);
-        void Skein1024_Process_Block(Skein1024_Ctxt_t* ctx, const u8* blkPtr, u32 blkCnt, u32 byteCntAdd);
+        void Skein_256_Process_Block(Skein_256_Ctxt_t* ctx, const u8* blkPtr, u64 blkCnt, u32 byteCntAdd);
+        void Skein_512_Process_Block(Skein_512_Ctxt_t* ctx, const u8* blkPtr, u64 blkCnt, u32 byteCntAdd);
+        void Skein1024_Process_Block(Skein1024_Ctxt_t* ctx, const u8* blkPtr, u64 blkCnt, u32 byteCntAdd);
 
         /*++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
         /* init the context for a straight hashing operation  */
@@ -1196,9 +1551,9 @@ namespace ncore
 
         /*++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
         /* process the input bytes */
-        s32 Skein_256_Update(Skein_256_Ctxt_t* ctx, const u8* msg, u32 msgByteCnt)
+        s32 Skein_256_Update(Skein_256_Ctxt_t* ctx, const u8* msg, u64 msgByteCnt)
         {
-            u32 n;
+            u64 n;
 
             Skein_Assert(ctx->h.bCnt <= SKEIN_256_BLOCK_BYTES, SKEIN_FAIL); /* catch uninitialized context */
 
@@ -1214,7 +1569,7 @@ namespace ncore
                         memcpy(&ctx->b[ctx->h.bCnt], msg, n);
                         msgByteCnt -= n;
                         msg += n;
-                        ctx->h.bCnt += n;
+                        ctx->h.bCnt += (u32)n;
                     }
                     Skein_assert(ctx->h.bCnt == SKEIN_256_BLOCK_BYTES);
                     Skein_256_Process_Block(ctx, ctx->b, 1, SKEIN_256_BLOCK_BYTES);
@@ -1236,7 +1591,7 @@ namespace ncore
             {
                 Skein_assert(msgByteCnt + ctx->h.bCnt <= SKEIN_256_BLOCK_BYTES);
                 memcpy(&ctx->b[ctx->h.bCnt], msg, msgByteCnt);
-                ctx->h.bCnt += msgByteCnt;
+                ctx->h.bCnt += (u32)msgByteCnt;
             }
 
             return SKEIN_SUCCESS;
@@ -1277,6 +1632,108 @@ namespace ncore
             return SKEIN_SUCCESS;
         }
 
+        /*++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+        /* init the context for a MAC and/or tree hash operation */
+        /* [identical to Skein_256_Init() when keyBytes == 0 && treeInfo == SKEIN_CFG_TREE_INFO_SEQUENTIAL] */
+        s32 Skein_256_InitExt(Skein_256_Ctxt_t* ctx, u32 hashBitLen, u64 treeInfo, const u8* key, u64 keyBytes)
+        {
+            union
+            {
+                u8  b[SKEIN_256_STATE_BYTES];
+                u64 w[SKEIN_256_STATE_WORDS];
+            } cfg; /* config block */
+
+            Skein_Assert(hashBitLen > 0, SKEIN_BAD_HASHLEN);
+            Skein_Assert(keyBytes == 0 || key != nullptr, SKEIN_FAIL);
+
+            /* compute the initial chaining values ctx->X[], based on key */
+            if (keyBytes == 0) /* is there a key? */
+            {
+                memset(ctx->X, 0, sizeof(ctx->X)); /* no key: use all zeroes as key for config block */
+            }
+            else /* here to pre-process a key */
+            {
+                Skein_assert(sizeof(cfg.b) >= sizeof(ctx->X));
+                /* do a mini-Init right here */
+                ctx->h.hashBitLen = 8 * sizeof(ctx->X); /* set output hash bit count = state size */
+                Skein_Start_New_Type(ctx, KEY);         /* set tweaks: T0 = 0; T1 = KEY type */
+                memset(ctx->X, 0, sizeof(ctx->X));      /* zero the initial chaining variables */
+                Skein_256_Update(ctx, key, keyBytes);    /* hash the key */
+                Skein_256_Final_Pad(ctx, cfg.b);         /* put result into cfg.b[] */
+                memcpy(ctx->X, cfg.b, sizeof(cfg.b));   /* copy over into ctx->X[] */
+#if SKEIN_NEED_SWAP
+                {
+                    u32 i;
+                    for (i = 0; i < SKEIN_256_STATE_WORDS; i++) /* convert key bytes to context words */
+                        ctx->X[i] = Skein_Swap64(ctx->X[i]);
+                }
+#endif
+            }
+            /* build/process the config block, type == CONFIG (could be precomputed for each key) */
+            ctx->h.hashBitLen = hashBitLen; /* output hash bit count */
+            Skein_Start_New_Type(ctx, CFG_FINAL);
+
+            memset(&cfg.w, 0, sizeof(cfg.w)); /* pre-pad cfg.w[] with zeroes */
+            cfg.w[0] = Skein_Swap64(SKEIN_SCHEMA_VER);
+            cfg.w[1] = Skein_Swap64(hashBitLen); /* hash result length in bits */
+            cfg.w[2] = Skein_Swap64(treeInfo);   /* tree hash config info (or SKEIN_CFG_TREE_INFO_SEQUENTIAL) */
+
+            Skein_Show_Key(256, &ctx->h, key, keyBytes);
+
+            /* compute the initial chaining values from config block */
+            Skein_256_Process_Block(ctx, cfg.b, 1, SKEIN_CFG_STR_LEN);
+
+            /* The chaining vars ctx->X are now initialized */
+            /* Set up to process the data message portion of the hash (default) */
+            Skein_Start_New_Type(ctx, MSG);
+
+            return SKEIN_SUCCESS;
+        }
+
+        /*++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+        /* finalize the hash computation and output the block, no OUTPUT stage */
+        s32 Skein_256_Final_Pad(Skein_256_Ctxt_t* ctx, u8* hashVal)
+        {
+            Skein_Assert(ctx->h.bCnt <= SKEIN_256_BLOCK_BYTES, SKEIN_FAIL); /* catch uninitialized context */
+
+            ctx->h.T[1] |= SKEIN_T1_FLAG_FINAL;      /* tag as the final block */
+            if (ctx->h.bCnt < SKEIN_256_BLOCK_BYTES) /* zero pad b[] if necessary */
+                memset(&ctx->b[ctx->h.bCnt], 0, SKEIN_256_BLOCK_BYTES - ctx->h.bCnt);
+            Skein_256_Process_Block(ctx, ctx->b, 1, ctx->h.bCnt); /* process the final block */
+
+            Skein_Put64_LSB_First(hashVal, ctx->X, SKEIN_256_BLOCK_BYTES); /* "output" the state bytes */
+
+            return SKEIN_SUCCESS;
+        }
+
+        /*++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+        /* just do the OUTPUT stage, with the chaining value in ctx->X */
+        s32 Skein_256_Output(Skein_256_Ctxt_t* ctx, u8* hashVal)
+        {
+            u32 i, n, byteCnt;
+            u64 X[SKEIN_256_STATE_WORDS];
+
+            /* now output the result */
+            byteCnt = (ctx->h.hashBitLen + 7) >> 3; /* total number of output bytes */
+
+            /* run Threefish in "counter mode" to generate output */
+            memset(ctx->b, 0, sizeof(ctx->b)); /* zero out b[], so it can hold the counter */
+            memcpy(X, ctx->X, sizeof(X));      /* keep a local copy of counter mode "key" */
+            for (i = 0; i * SKEIN_256_BLOCK_BYTES < byteCnt; i++)
+            {
+                ((u64*)ctx->b)[0] = Skein_Swap64((u64)i); /* build the counter block */
+                Skein_Start_New_Type(ctx, OUT_FINAL);
+                Skein_256_Process_Block(ctx, ctx->b, 1, sizeof(u64)); /* run "counter mode" */
+                n = byteCnt - i * SKEIN_256_BLOCK_BYTES;              /* number of output bytes left to go */
+                if (n >= SKEIN_256_BLOCK_BYTES)
+                    n = SKEIN_256_BLOCK_BYTES;
+                Skein_Put64_LSB_First(hashVal + i * SKEIN_256_BLOCK_BYTES, ctx->X, n); /* "output" the ctr mode bytes */
+                Skein_Show_Final(256, &ctx->h, n, hashVal + i * SKEIN_256_BLOCK_BYTES);
+                memcpy(ctx->X, X, sizeof(X)); /* restore the counter mode key for next time */
+            }
+            return SKEIN_SUCCESS;
+        }
+
         /*****************************************************************/
         /*     512-bit Skein                                             */
         /*****************************************************************/
@@ -1326,9 +1783,9 @@ namespace ncore
 
         /*++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
         /* process the input bytes */
-        s32 Skein_512_Update(Skein_512_Ctxt_t* ctx, const u8* msg, u32 msgByteCnt)
+        s32 Skein_512_Update(Skein_512_Ctxt_t* ctx, const u8* msg, u64 msgByteCnt)
         {
-            u32 n;
+            u64 n;
 
             Skein_Assert(ctx->h.bCnt <= SKEIN_512_BLOCK_BYTES, SKEIN_FAIL); /* catch uninitialized context */
 
@@ -1344,7 +1801,7 @@ namespace ncore
                         memcpy(&ctx->b[ctx->h.bCnt], msg, n);
                         msgByteCnt -= n;
                         msg += n;
-                        ctx->h.bCnt += n;
+                        ctx->h.bCnt += (u32)n;
                     }
                     Skein_assert(ctx->h.bCnt == SKEIN_512_BLOCK_BYTES);
                     Skein_512_Process_Block(ctx, ctx->b, 1, SKEIN_512_BLOCK_BYTES);
@@ -1366,7 +1823,7 @@ namespace ncore
             {
                 Skein_assert(msgByteCnt + ctx->h.bCnt <= SKEIN_512_BLOCK_BYTES);
                 memcpy(&ctx->b[ctx->h.bCnt], msg, msgByteCnt);
-                ctx->h.bCnt += msgByteCnt;
+                ctx->h.bCnt += (u32)msgByteCnt;
             }
 
             return SKEIN_SUCCESS;
@@ -1407,6 +1864,108 @@ namespace ncore
             return SKEIN_SUCCESS;
         }
 
+        /*++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+        /* init the context for a MAC and/or tree hash operation */
+        /* [identical to Skein_512_Init() when keyBytes == 0 && treeInfo == SKEIN_CFG_TREE_INFO_SEQUENTIAL] */
+        s32 Skein_512_InitExt(Skein_512_Ctxt_t* ctx, u32 hashBitLen, u64 treeInfo, const u8* key, u64 keyBytes)
+        {
+            union
+            {
+                u8  b[SKEIN_512_STATE_BYTES];
+                u64 w[SKEIN_512_STATE_WORDS];
+            } cfg; /* config block */
+
+            Skein_Assert(hashBitLen > 0, SKEIN_BAD_HASHLEN);
+            Skein_Assert(keyBytes == 0 || key != nullptr, SKEIN_FAIL);
+
+            /* compute the initial chaining values ctx->X[], based on key */
+            if (keyBytes == 0) /* is there a key? */
+            {
+                memset(ctx->X, 0, sizeof(ctx->X)); /* no key: use all zeroes as key for config block */
+            }
+            else /* here to pre-process a key */
+            {
+                Skein_assert(sizeof(cfg.b) >= sizeof(ctx->X));
+                /* do a mini-Init right here */
+                ctx->h.hashBitLen = 8 * sizeof(ctx->X); /* set output hash bit count = state size */
+                Skein_Start_New_Type(ctx, KEY);         /* set tweaks: T0 = 0; T1 = KEY type */
+                memset(ctx->X, 0, sizeof(ctx->X));      /* zero the initial chaining variables */
+                Skein_512_Update(ctx, key, keyBytes);    /* hash the key */
+                Skein_512_Final_Pad(ctx, cfg.b);         /* put result into cfg.b[] */
+                memcpy(ctx->X, cfg.b, sizeof(cfg.b));   /* copy over into ctx->X[] */
+#if SKEIN_NEED_SWAP
+                {
+                    u32 i;
+                    for (i = 0; i < SKEIN_512_STATE_WORDS; i++) /* convert key bytes to context words */
+                        ctx->X[i] = Skein_Swap64(ctx->X[i]);
+                }
+#endif
+            }
+            /* build/process the config block, type == CONFIG (could be precomputed for each key) */
+            ctx->h.hashBitLen = hashBitLen; /* output hash bit count */
+            Skein_Start_New_Type(ctx, CFG_FINAL);
+
+            memset(&cfg.w, 0, sizeof(cfg.w)); /* pre-pad cfg.w[] with zeroes */
+            cfg.w[0] = Skein_Swap64(SKEIN_SCHEMA_VER);
+            cfg.w[1] = Skein_Swap64(hashBitLen); /* hash result length in bits */
+            cfg.w[2] = Skein_Swap64(treeInfo);   /* tree hash config info (or SKEIN_CFG_TREE_INFO_SEQUENTIAL) */
+
+            Skein_Show_Key(512, &ctx->h, key, keyBytes);
+
+            /* compute the initial chaining values from config block */
+            Skein_512_Process_Block(ctx, cfg.b, 1, SKEIN_CFG_STR_LEN);
+
+            /* The chaining vars ctx->X are now initialized */
+            /* Set up to process the data message portion of the hash (default) */
+            Skein_Start_New_Type(ctx, MSG);
+
+            return SKEIN_SUCCESS;
+        }
+
+        /*++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+        /* finalize the hash computation and output the block, no OUTPUT stage */
+        s32 Skein_512_Final_Pad(Skein_512_Ctxt_t* ctx, u8* hashVal)
+        {
+            Skein_Assert(ctx->h.bCnt <= SKEIN_512_BLOCK_BYTES, SKEIN_FAIL); /* catch uninitialized context */
+
+            ctx->h.T[1] |= SKEIN_T1_FLAG_FINAL;      /* tag as the final block */
+            if (ctx->h.bCnt < SKEIN_512_BLOCK_BYTES) /* zero pad b[] if necessary */
+                memset(&ctx->b[ctx->h.bCnt], 0, SKEIN_512_BLOCK_BYTES - ctx->h.bCnt);
+            Skein_512_Process_Block(ctx, ctx->b, 1, ctx->h.bCnt); /* process the final block */
+
+            Skein_Put64_LSB_First(hashVal, ctx->X, SKEIN_512_BLOCK_BYTES); /* "output" the state bytes */
+
+            return SKEIN_SUCCESS;
+        }
+
+        /*++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+        /* just do the OUTPUT stage, with the chaining value in ctx->X */
+        s32 Skein_512_Output(Skein_512_Ctxt_t* ctx, u8* hashVal)
+        {
+            u32 i, n, byteCnt;
+            u64 X[SKEIN_512_STATE_WORDS];
+
+            /* now output the result */
+            byteCnt = (ctx->h.hashBitLen + 7) >> 3; /* total number of output bytes */
+
+            /* run Threefish in "counter mode" to generate output */
+            memset(ctx->b, 0, sizeof(ctx->b)); /* zero out b[], so it can hold the counter */
+            memcpy(X, ctx->X, sizeof(X));      /* keep a local copy of counter mode "key" */
+            for (i = 0; i * SKEIN_512_BLOCK_BYTES < byteCnt; i++)
+            {
+                ((u64*)ctx->b)[0] = Skein_Swap64((u64)i); /* build the counter block */
+                Skein_Start_New_Type(ctx, OUT_FINAL);
+                Skein_512_Process_Block(ctx, ctx->b, 1, sizeof(u64)); /* run "counter mode" */
+                n = byteCnt - i * SKEIN_512_BLOCK_BYTES;              /* number of output bytes left to go */
+                if (n >= SKEIN_512_BLOCK_BYTES)
+                    n = SKEIN_512_BLOCK_BYTES;
+                Skein_Put64_LSB_First(hashVal + i * SKEIN_512_BLOCK_BYTES, ctx->X, n); /* "output" the ctr mode bytes */
+                Skein_Show_Final(512, &ctx->h, n, hashVal + i * SKEIN_512_BLOCK_BYTES);
+                memcpy(ctx->X, X, sizeof(X)); /* restore the counter mode key for next time */
+            }
+            return SKEIN_SUCCESS;
+        }
+
         /*****************************************************************/
         /*    1024-bit Skein                                             */
         /*****************************************************************/
@@ -1454,9 +2013,9 @@ namespace ncore
 
         /*++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
         /* process the input bytes */
-        s32 Skein1024_Update(Skein1024_Ctxt_t* ctx, const u8* msg, u32 msgByteCnt)
+        s32 Skein1024_Update(Skein1024_Ctxt_t* ctx, const u8* msg, u64 msgByteCnt)
         {
-            u32 n;
+            u64 n;
 
             Skein_Assert(ctx->h.bCnt <= SKEIN1024_BLOCK_BYTES, SKEIN_FAIL); /* catch uninitialized context */
 
@@ -1472,7 +2031,7 @@ namespace ncore
                         memcpy(&ctx->b[ctx->h.bCnt], msg, n);
                         msgByteCnt -= n;
                         msg += n;
-                        ctx->h.bCnt += n;
+                        ctx->h.bCnt += (u32)n;
                     }
                     Skein_assert(ctx->h.bCnt == SKEIN1024_BLOCK_BYTES);
                     Skein1024_Process_Block(ctx, ctx->b, 1, SKEIN1024_BLOCK_BYTES);
@@ -1494,7 +2053,7 @@ namespace ncore
             {
                 Skein_assert(msgByteCnt + ctx->h.bCnt <= SKEIN1024_BLOCK_BYTES);
                 memcpy(&ctx->b[ctx->h.bCnt], msg, msgByteCnt);
-                ctx->h.bCnt += msgByteCnt;
+                ctx->h.bCnt += (u32)msgByteCnt;
             }
 
             return SKEIN_SUCCESS;
@@ -1535,6 +2094,327 @@ namespace ncore
 
             return SKEIN_SUCCESS;
         }
+
+        /*++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+        /* init the context for a MAC and/or tree hash operation */
+        /* [identical to Skein1024_Init() when keyBytes == 0 && treeInfo == SKEIN_CFG_TREE_INFO_SEQUENTIAL] */
+        s32 Skein1024_InitExt(Skein1024_Ctxt_t* ctx, u32 hashBitLen, u64 treeInfo, const u8* key, u64 keyBytes)
+        {
+            union
+            {
+                u8  b[SKEIN1024_STATE_BYTES];
+                u64 w[SKEIN1024_STATE_WORDS];
+            } cfg; /* config block */
+
+            Skein_Assert(hashBitLen > 0, SKEIN_BAD_HASHLEN);
+            Skein_Assert(keyBytes == 0 || key != nullptr, SKEIN_FAIL);
+
+            /* compute the initial chaining values ctx->X[], based on key */
+            if (keyBytes == 0) /* is there a key? */
+            {
+                memset(ctx->X, 0, sizeof(ctx->X)); /* no key: use all zeroes as key for config block */
+            }
+            else /* here to pre-process a key */
+            {
+                Skein_assert(sizeof(cfg.b) >= sizeof(ctx->X));
+                /* do a mini-Init right here */
+                ctx->h.hashBitLen = 8 * sizeof(ctx->X); /* set output hash bit count = state size */
+                Skein_Start_New_Type(ctx, KEY);         /* set tweaks: T0 = 0; T1 = KEY type */
+                memset(ctx->X, 0, sizeof(ctx->X));      /* zero the initial chaining variables */
+                Skein1024_Update(ctx, key, keyBytes);    /* hash the key */
+                Skein1024_Final_Pad(ctx, cfg.b);         /* put result into cfg.b[] */
+                memcpy(ctx->X, cfg.b, sizeof(cfg.b));   /* copy over into ctx->X[] */
+#if SKEIN_NEED_SWAP
+                {
+                    u32 i;
+                    for (i = 0; i < SKEIN1024_STATE_WORDS; i++) /* convert key bytes to context words */
+                        ctx->X[i] = Skein_Swap64(ctx->X[i]);
+                }
+#endif
+            }
+            /* build/process the config block, type == CONFIG (could be precomputed for each key) */
+            ctx->h.hashBitLen = hashBitLen; /* output hash bit count */
+            Skein_Start_New_Type(ctx, CFG_FINAL);
+
+            memset(&cfg.w, 0, sizeof(cfg.w)); /* pre-pad cfg.w[] with zeroes */
+            cfg.w[0] = Skein_Swap64(SKEIN_SCHEMA_VER);
+            cfg.w[1] = Skein_Swap64(hashBitLen); /* hash result length in bits */
+            cfg.w[2] = Skein_Swap64(treeInfo);   /* tree hash config info (or SKEIN_CFG_TREE_INFO_SEQUENTIAL) */
+
+            Skein_Show_Key(1024, &ctx->h, key, keyBytes);
+
+            /* compute the initial chaining values from config block */
+            Skein1024_Process_Block(ctx, cfg.b, 1, SKEIN_CFG_STR_LEN);
+
+            /* The chaining vars ctx->X are now initialized */
+            /* Set up to process the data message portion of the hash (default) */
+            Skein_Start_New_Type(ctx, MSG);
+
+            return SKEIN_SUCCESS;
+        }
+
+        /*++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+        /* finalize the hash computation and output the block, no OUTPUT stage */
+        s32 Skein1024_Final_Pad(Skein1024_Ctxt_t* ctx, u8* hashVal)
+        {
+            Skein_Assert(ctx->h.bCnt <= SKEIN1024_BLOCK_BYTES, SKEIN_FAIL); /* catch uninitialized context */
+
+            ctx->h.T[1] |= SKEIN_T1_FLAG_FINAL;      /* tag as the final block */
+            if (ctx->h.bCnt < SKEIN1024_BLOCK_BYTES) /* zero pad b[] if necessary */
+                memset(&ctx->b[ctx->h.bCnt], 0, SKEIN1024_BLOCK_BYTES - ctx->h.bCnt);
+            Skein1024_Process_Block(ctx, ctx->b, 1, ctx->h.bCnt); /* process the final block */
+
+            Skein_Put64_LSB_First(hashVal, ctx->X, SKEIN1024_BLOCK_BYTES); /* "output" the state bytes */
+
+            return SKEIN_SUCCESS;
+        }
+
+        /*++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+        /* just do the OUTPUT stage, with the chaining value in ctx->X */
+        s32 Skein1024_Output(Skein1024_Ctxt_t* ctx, u8* hashVal)
+        {
+            u32 i, n, byteCnt;
+            u64 X[SKEIN1024_STATE_WORDS];
+
+            /* now output the result */
+            byteCnt = (ctx->h.hashBitLen + 7) >> 3; /* total number of output bytes */
+
+            /* run Threefish in "counter mode" to generate output */
+            memset(ctx->b, 0, sizeof(ctx->b)); /* zero out b[], so it can hold the counter */
+            memcpy(X, ctx->X, sizeof(X));      /* keep a local copy of counter mode "key" */
+            for (i = 0; i * SKEIN1024_BLOCK_BYTES < byteCnt; i++)
+            {
+                ((u64*)ctx->b)[0] = Skein_Swap64((u64)i); /* build the counter block */
+                Skein_Start_New_Type(ctx, OUT_FINAL);
+                Skein1024_Process_Block(ctx, ctx->b, 1, sizeof(u64)); /* run "counter mode" */
+                n = byteCnt - i * SKEIN1024_BLOCK_BYTES;              /* number of output bytes left to go */
+                if (n >= SKEIN1024_BLOCK_BYTES)
+                    n = SKEIN1024_BLOCK_BYTES;
+                Skein_Put64_LSB_First(hashVal + i * SKEIN1024_BLOCK_BYTES, ctx->X, n); /* "output" the ctr mode bytes */
+                Skein_Show_Final(1024, &ctx->h, n, hashVal + i * SKEIN1024_BLOCK_BYTES);
+                memcpy(ctx->X, X, sizeof(X)); /* restore the counter mode key for next time */
+            }
+            return SKEIN_SUCCESS;
+        }
+
+        /*****************************************************************/
+        /*     Tree hashing                                              */
+        /*****************************************************************/
+
+        // The message is split into leaves of Nb * 2^leaf bytes that are hashed on their own (tree level 1,
+        // the tweak starts at the byte position of the leaf), the chaining values of level l are the message
+        // of level l+1 which is split into nodes of Nb * 2^fanout bytes. This ends when one chaining value is
+        // left, or at level max_level which takes all chaining values of the level below in a single node.
+        // The leaves are hashed in batches, as jobs when a batch is large enough, the levels above them are
+        // fed on the calling thread one chaining value at a time so no level is ever held in memory.
+
+        static inline void Skein_Update(Skein_256_Ctxt_t* ctx, const u8* msg, u64 msgByteCnt) { Skein_256_Update(ctx, msg, msgByteCnt); }
+        static inline void Skein_Update(Skein_512_Ctxt_t* ctx, const u8* msg, u64 msgByteCnt) { Skein_512_Update(ctx, msg, msgByteCnt); }
+        static inline void Skein_Update(Skein1024_Ctxt_t* ctx, const u8* msg, u64 msgByteCnt) { Skein1024_Update(ctx, msg, msgByteCnt); }
+        static inline void Skein_Final_Pad(Skein_256_Ctxt_t* ctx, u8* hashVal) { Skein_256_Final_Pad(ctx, hashVal); }
+        static inline void Skein_Final_Pad(Skein_512_Ctxt_t* ctx, u8* hashVal) { Skein_512_Final_Pad(ctx, hashVal); }
+        static inline void Skein_Final_Pad(Skein1024_Ctxt_t* ctx, u8* hashVal) { Skein1024_Final_Pad(ctx, hashVal); }
+        static inline void Skein_Output(Skein_256_Ctxt_t* ctx, u8* hashVal) { Skein_256_Output(ctx, hashVal); }
+        static inline void Skein_Output(Skein_512_Ctxt_t* ctx, u8* hashVal) { Skein_512_Output(ctx, hashVal); }
+        static inline void Skein_Output(Skein1024_Ctxt_t* ctx, u8* hashVal) { Skein1024_Output(ctx, hashVal); }
+        static inline void Skein_Process_Block_X4(Skein_256_Ctxt_t* ctx, const u8* const* blkPtr, u64 blkCnt, u32 byteCntAdd)
+        {
+            for (u32 l = 0; l < 4; ++l)
+                Skein_256_Process_Block(&ctx[l], blkPtr[l], blkCnt, byteCntAdd);
+        }
+        static inline void Skein_Process_Block_X4(Skein_512_Ctxt_t* ctx, const u8* const* blkPtr, u64 blkCnt, u32 byteCntAdd) { Skein_512_X4_Kernel()(ctx, blkPtr, blkCnt, byteCntAdd); }
+        static inline void Skein_Process_Block_X4(Skein1024_Ctxt_t* ctx, const u8* const* blkPtr, u64 blkCnt, u32 byteCntAdd) { Skein1024_X4_Kernel()(ctx, blkPtr, blkCnt, byteCntAdd); }
+
+        enum
+        {
+            SKEIN_TREE_HEIGHT_MAX = 64,        // Leaves of at least 2 blocks and a fan-out of at least 2 stay below this
+            SKEIN_TREE_BATCH      = 64,        // Leaves hashed per batch, their chaining values are kept on the stack
+            SKEIN_TREE_JOB_BYTES  = 64 * 1024, // Minimum message bytes per job
+        };
+
+        // Start a node of <level> at byte position <pos> of the message of that level, <G> holds the chaining
+        // values that follow the config block
+        template <typename C> static inline void Skein_Tree_Begin(C* ctx, const C* G, u64 pos, u32 level)
+        {
+            ctx->h.hashBitLen = G->h.hashBitLen;
+            memcpy(ctx->X, G->X, sizeof(ctx->X));
+            Skein_Set_T0_T1(ctx, pos, SKEIN_T1_FLAG_FIRST | SKEIN_T1_BLK_TYPE_MSG | SKEIN_T1_TREE_LEVEL(level));
+            ctx->h.bCnt = 0;
+        }
+
+        template <typename C> struct Skein_Tree_Jobs_t
+        {
+            const C*  G;
+            const u8* msg;        // The message
+            u64       msgByteCnt; // and its length in bytes
+            u64       leafBytes;
+            u64       first;      // First leaf of the batch
+            u32       cnt;        // Leaves in the batch
+            u32       perJob;     // Leaves per job
+            u8*       cvs;        // Chaining values of the leaves of the batch
+
+            static void job(void* user, s32 index)
+            {
+                Skein_Tree_Jobs_t* jobs = (Skein_Tree_Jobs_t*)user;
+                u32 const          end  = ((u32)index + 1) * jobs->perJob < jobs->cnt ? ((u32)index + 1) * jobs->perJob : jobs->cnt;
+                u64 const          full = jobs->msgByteCnt / jobs->leafBytes; // Leaves without padding
+
+                // Whole leaves are hashed 4 at a time, all but the last block and then the last block
+                u32 i = (u32)index * jobs->perJob;
+                for (; i + 4 <= end && jobs->first + i + 4 <= full; i += 4)
+                {
+                    C         leaf[4];
+                    const u8* blk[4];
+                    u64 const blkBytes = sizeof(leaf[0].X);
+                    u64 const blkCnt   = jobs->leafBytes / blkBytes;
+                    for (u32 l = 0; l < 4; ++l)
+                    {
+                        u64 const pos = (jobs->first + i + l) * jobs->leafBytes;
+                        Skein_Tree_Begin(&leaf[l], jobs->G, pos, 1);
+                        blk[l] = jobs->msg + pos;
+                    }
+                    Skein_Process_Block_X4(leaf, blk, blkCnt - 1, (u32)blkBytes);
+                    for (u32 l = 0; l < 4; ++l)
+                    {
+                        leaf[l].h.T[1] |= SKEIN_T1_FLAG_FINAL;
+                        blk[l] += (blkCnt - 1) * blkBytes;
+                    }
+                    Skein_Process_Block_X4(leaf, blk, 1, (u32)blkBytes);
+                    for (u32 l = 0; l < 4; ++l)
+                        Skein_Put64_LSB_First(jobs->cvs + (u64)(i + l) * blkBytes, leaf[l].X, blkBytes);
+                }
+
+                for (; i < end; ++i)
+                {
+                    u64 const pos = (jobs->first + i) * jobs->leafBytes;
+                    u64 const n   = (jobs->msgByteCnt - pos) < jobs->leafBytes ? (jobs->msgByteCnt - pos) : jobs->leafBytes;
+
+                    C leaf;
+                    Skein_Tree_Begin(&leaf, jobs->G, pos, 1);
+                    Skein_Update(&leaf, jobs->msg + pos, n);
+                    Skein_Final_Pad(&leaf, jobs->cvs + (u64)i * sizeof(leaf.X));
+                }
+            }
+        };
+
+        template <typename C> struct Skein_Tree_Level_t
+        {
+            C   node;     // The node being filled
+            u64 nodes;    // Nodes of this level that are done
+            u64 children; // Chaining values in <node>
+        };
+
+        // Append the chaining value <cv> to the node of <level>, full nodes are passed up the tree
+        template <typename C> static void Skein_Tree_Push(const C* G, Skein_Tree_Level_t<C>* levels, u32 level, u32 height, u64 nodeCvs, const u8* cv)
+        {
+            u8 parent[sizeof(G->X)];
+            for (;;)
+            {
+                Skein_Tree_Level_t<C>& lvl = levels[level];
+                if (lvl.children == 0)
+                    Skein_Tree_Begin(&lvl.node, G, lvl.nodes * nodeCvs * sizeof(G->X), level);
+                Skein_Update(&lvl.node, cv, sizeof(G->X));
+                if (++lvl.children < nodeCvs || level == height)
+                    return;
+
+                Skein_Final_Pad(&lvl.node, parent);
+                lvl.nodes++;
+                lvl.children = 0;
+                cv           = parent;
+                level++;
+            }
+        }
+
+        // Tree hash <msg> with the context <ctx> set up by InitExt with the same tree parameters
+        template <typename C> static void Skein_Tree_Hash(C* ctx, const u8* msg, u64 msgByteCnt, u32 leaf, u32 fanout, u32 maxLevel, hash_jobs_t* jobs, u8* hashVal)
+        {
+            u64 const blkBytes  = sizeof(ctx->X);
+            u64 const leafBytes = leaf < 56 ? blkBytes << leaf : ~(u64)0;
+            u64 const nodeCvs   = fanout < 56 ? (u64)1 << fanout : ~(u64)0;
+            u64 const leaves    = msgByteCnt == 0 ? 1 : (msgByteCnt - 1) / leafBytes + 1;
+
+            // Level <height> holds the root node, a tree of a single leaf has no nodes
+            u32 height = 1;
+            for (u64 n = leaves; n > 1; ++height)
+                n = (height + 1 == maxLevel) ? 1 : (n - 1) / nodeCvs + 1;
+
+            Skein_Tree_Level_t<C> levels[SKEIN_TREE_HEIGHT_MAX + 1];
+            for (u32 l = 2; l <= height; ++l)
+            {
+                levels[l].nodes    = 0;
+                levels[l].children = 0;
+            }
+
+            Skein_Tree_Jobs_t<C> batch;
+            u8                   cvs[SKEIN_TREE_BATCH * sizeof(ctx->X)];
+            batch.G          = ctx;
+            batch.msg        = msg;
+            batch.msgByteCnt = msgByteCnt;
+            batch.leafBytes  = leafBytes;
+            batch.cvs        = cvs;
+
+            u8 root[sizeof(ctx->X)];
+            for (u64 first = 0; first < leaves; first += SKEIN_TREE_BATCH)
+            {
+                batch.first  = first;
+                batch.cnt    = (leaves - first) < SKEIN_TREE_BATCH ? (u32)(leaves - first) : (u32)SKEIN_TREE_BATCH;
+                batch.perJob = batch.cnt;
+
+                u64 const bytes = (batch.cnt < leaves - first) ? batch.cnt * leafBytes : msgByteCnt - first * leafBytes;
+                if (jobs != nullptr && jobs->workers() > 1 && batch.cnt > 1 && bytes >= 2 * SKEIN_TREE_JOB_BYTES)
+                {
+                    u64 pieces = (u64)jobs->workers() * 4;
+                    if (pieces > bytes / SKEIN_TREE_JOB_BYTES)
+                        pieces = bytes / SKEIN_TREE_JOB_BYTES;
+                    if (pieces > batch.cnt)
+                        pieces = batch.cnt;
+                    batch.perJob = (u32)((batch.cnt + pieces - 1) / pieces);
+                    jobs->run(&Skein_Tree_Jobs_t<C>::job, &batch, (s32)((batch.cnt + batch.perJob - 1) / batch.perJob));
+                }
+                else
+                {
+                    Skein_Tree_Jobs_t<C>::job(&batch, 0);
+                }
+
+                if (height == 1)
+                    memcpy(root, cvs, sizeof(root));
+                else
+                    for (u32 i = 0; i < batch.cnt; ++i)
+                        Skein_Tree_Push(ctx, levels, 2, height, nodeCvs, cvs + i * blkBytes);
+            }
+
+            // Close the partial nodes bottom up, the node at <height> is the root
+            if (height > 1)
+            {
+                for (u32 l = 2; l < height; ++l)
+                {
+                    if (levels[l].children == 0)
+                        continue;
+                    Skein_Final_Pad(&levels[l].node, root);
+                    levels[l].children = 0;
+                    Skein_Tree_Push(ctx, levels, l + 1, height, nodeCvs, root);
+                }
+                Skein_Final_Pad(&levels[height].node, root);
+            }
+
+            Skein_Get64_LSB_First(ctx->X, root, sizeof(ctx->X) / 8);
+            Skein_Output(ctx, hashVal);
+        }
+
+        /*****************************************************************/
+        /*     Skein-MAC                                                 */
+        /*****************************************************************/
+
+        // The key and config blocks only depend on the key, InitExt runs them once and the chaining values it
+        // leaves in ctx->X are the MAC key. A message starts from a copy of those, as InitExt itself would.
+        template <typename C> static inline void Skein_MAC_Key(const C* ctx, u64* key) { memcpy(key, ctx->X, sizeof(ctx->X)); }
+
+        template <typename C> static inline void Skein_MAC_Begin(C* ctx, u32 hashBitLen, const u64* key)
+        {
+            ctx->h.hashBitLen = hashBitLen;
+            memcpy(ctx->X, key, sizeof(ctx->X));
+            Skein_Start_New_Type(ctx, MSG);
+        }
     } // namespace skein
 
     // -----------------------------------------------------------------------------------------------------------------
@@ -1553,11 +2433,18 @@ namespace ncore
             skein::Skein_256_Init(ctx, 256);
         }
 
+        void skein256_t::reset(nhash::skein256_key const& key)
+        {
+            skein::Skein_256_Ctxt_t* ctx = (skein::Skein_256_Ctxt_t*)&m_ctxt;
+            m_initialized                = true;
+            skein::Skein_MAC_Begin(ctx, 256, key.m_X);
+        }
+
         void skein256_t::hash(const u8* begin, const u8* end)
         {
             skein::Skein_256_Ctxt_t* ctx = (skein::Skein_256_Ctxt_t*)&m_ctxt;
             if (m_initialized)
-                skein::Skein_256_Update(ctx, begin, (u32)(end - begin));
+                skein::Skein_256_Update(ctx, begin, (u64)(end - begin));
         }
 
         void skein256_t::end(u8* hash)
@@ -1577,11 +2464,18 @@ namespace ncore
             skein::Skein_512_Init(ctx, 512);
         }
 
+        void skein512_t::reset(nhash::skein512_key const& key)
+        {
+            skein::Skein_512_Ctxt_t* ctx = (skein::Skein_512_Ctxt_t*)&m_ctxt;
+            m_initialized                = true;
+            skein::Skein_MAC_Begin(ctx, 512, key.m_X);
+        }
+
         void skein512_t::hash(const u8* begin, const u8* end)
         {
             skein::Skein_512_Ctxt_t* ctx = (skein::Skein_512_Ctxt_t*)&m_ctxt;
             if (m_initialized)
-                skein::Skein_512_Update(ctx, begin, (u32)(end - begin));
+                skein::Skein_512_Update(ctx, begin, (u64)(end - begin));
         }
 
         void skein512_t::end(u8* hash)
@@ -1601,11 +2495,18 @@ namespace ncore
             skein::Skein1024_Init(ctx, 256);
         }
 
+        void skein1024_t::reset(nhash::skein1024_key const& key)
+        {
+            skein::Skein1024_Ctxt_t* ctx = (skein::Skein1024_Ctxt_t*)&m_ctxt;
+            m_initialized                = true;
+            skein::Skein_MAC_Begin(ctx, 256, key.m_X);
+        }
+
         void skein1024_t::hash(const u8* begin, const u8* end)
         {
             skein::Skein1024_Ctxt_t* ctx = (skein::Skein1024_Ctxt_t*)&m_ctxt;
             if (m_initialized)
-                skein::Skein1024_Update(ctx, begin, (u32)(end - begin));
+                skein::Skein1024_Update(ctx, begin, (u64)(end - begin));
         }
 
         void skein1024_t::end(u8* hash)
@@ -1619,4 +2520,131 @@ namespace ncore
         }
 
     } // namespace nhash_private
+
+    namespace nhash
+    {
+        // Skein always holds back the last block to flag it as final, so the one-shot runs the
+        // regular Init / Update / Final on a context on the stack
+        skein256 hash_skein256(u8 const* data, u64 len)
+        {
+            skein::Skein_256_Ctxt_t ctx;
+            skein::Skein_256_Init(&ctx, 256);
+            skein::Skein_256_Update(&ctx, data, len);
+            skein256 digest;
+            skein::Skein_256_Final(&ctx, digest.m_data);
+            return digest;
+        }
+
+        skein512 hash_skein512(u8 const* data, u64 len)
+        {
+            skein::Skein_512_Ctxt_t ctx;
+            skein::Skein_512_Init(&ctx, 512);
+            skein::Skein_512_Update(&ctx, data, len);
+            skein512 digest;
+            skein::Skein_512_Final(&ctx, digest.m_data);
+            return digest;
+        }
+
+        skein1024 hash_skein1024(u8 const* data, u64 len)
+        {
+            skein::Skein1024_Ctxt_t ctx;
+            skein::Skein1024_Init(&ctx, 256);
+            skein::Skein1024_Update(&ctx, data, len);
+            skein1024 digest = {};
+            skein::Skein1024_Final(&ctx, digest.m_data);
+            return digest;
+        }
+
+        skein256_key skein256_mac_key(u8 const* key, u64 len)
+        {
+            skein::Skein_256_Ctxt_t ctx;
+            skein::Skein_256_InitExt(&ctx, 256, SKEIN_CFG_TREE_INFO_SEQUENTIAL, key, len);
+            skein256_key mac;
+            skein::Skein_MAC_Key(&ctx, mac.m_X);
+            return mac;
+        }
+
+        skein512_key skein512_mac_key(u8 const* key, u64 len)
+        {
+            skein::Skein_512_Ctxt_t ctx;
+            skein::Skein_512_InitExt(&ctx, 512, SKEIN_CFG_TREE_INFO_SEQUENTIAL, key, len);
+            skein512_key mac;
+            skein::Skein_MAC_Key(&ctx, mac.m_X);
+            return mac;
+        }
+
+        skein1024_key skein1024_mac_key(u8 const* key, u64 len)
+        {
+            skein::Skein1024_Ctxt_t ctx;
+            skein::Skein1024_InitExt(&ctx, 256, SKEIN_CFG_TREE_INFO_SEQUENTIAL, key, len);
+            skein1024_key mac;
+            skein::Skein_MAC_Key(&ctx, mac.m_X);
+            return mac;
+        }
+
+        skein256 hash_skein256_mac(skein256_key const& key, u8 const* data, u64 len)
+        {
+            skein::Skein_256_Ctxt_t ctx;
+            skein::Skein_MAC_Begin(&ctx, 256, key.m_X);
+            skein::Skein_256_Update(&ctx, data, len);
+            skein256 digest;
+            skein::Skein_256_Final(&ctx, digest.m_data);
+            return digest;
+        }
+
+        skein512 hash_skein512_mac(skein512_key const& key, u8 const* data, u64 len)
+        {
+            skein::Skein_512_Ctxt_t ctx;
+            skein::Skein_MAC_Begin(&ctx, 512, key.m_X);
+            skein::Skein_512_Update(&ctx, data, len);
+            skein512 digest;
+            skein::Skein_512_Final(&ctx, digest.m_data);
+            return digest;
+        }
+
+        skein1024 hash_skein1024_mac(skein1024_key const& key, u8 const* data, u64 len)
+        {
+            skein::Skein1024_Ctxt_t ctx;
+            skein::Skein_MAC_Begin(&ctx, 256, key.m_X);
+            skein::Skein1024_Update(&ctx, data, len);
+            skein1024 digest = {};
+            skein::Skein1024_Final(&ctx, digest.m_data);
+            return digest;
+        }
+
+        static inline u64 skein_tree_info(u32 leaf, u32 fanout, u32 max_level)
+        {
+            ASSERTS(leaf >= 1 && leaf <= 255, "Skein tree leaf size out of range");
+            ASSERTS(fanout >= 1 && fanout <= 255, "Skein tree fan-out out of range");
+            ASSERTS(max_level >= 2 && max_level <= 255, "Skein tree height out of range");
+            return SKEIN_CFG_TREE_INFO(leaf, fanout, max_level);
+        }
+
+        skein256 hash_skein256_tree(u8 const* data, u64 len, u32 leaf, u32 fanout, u32 max_level, hash_jobs_t* jobs)
+        {
+            skein::Skein_256_Ctxt_t ctx;
+            skein::Skein_256_InitExt(&ctx, 256, skein_tree_info(leaf, fanout, max_level), nullptr, 0);
+            skein256 digest;
+            skein::Skein_Tree_Hash(&ctx, data, len, leaf, fanout, max_level, jobs, digest.m_data);
+            return digest;
+        }
+
+        skein512 hash_skein512_tree(u8 const* data, u64 len, u32 leaf, u32 fanout, u32 max_level, hash_jobs_t* jobs)
+        {
+            skein::Skein_512_Ctxt_t ctx;
+            skein::Skein_512_InitExt(&ctx, 512, skein_tree_info(leaf, fanout, max_level), nullptr, 0);
+            skein512 digest;
+            skein::Skein_Tree_Hash(&ctx, data, len, leaf, fanout, max_level, jobs, digest.m_data);
+            return digest;
+        }
+
+        skein1024 hash_skein1024_tree(u8 const* data, u64 len, u32 leaf, u32 fanout, u32 max_level, hash_jobs_t* jobs)
+        {
+            skein::Skein1024_Ctxt_t ctx;
+            skein::Skein1024_InitExt(&ctx, 256, skein_tree_info(leaf, fanout, max_level), nullptr, 0);
+            skein1024 digest = {};
+            skein::Skein_Tree_Hash(&ctx, data, len, leaf, fanout, max_level, jobs, digest.m_data);
+            return digest;
+        }
+    } // namespace nhash
 } // namespace ncore
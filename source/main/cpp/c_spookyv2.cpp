@@ -1,5 +1,6 @@
 #include "ccore/c_target.h"
 #include "cbase/c_memory.h"
+#include "chash/c_hash.h"
 #include "chash/private/c_internal_hash.h"
 
 namespace ncore
@@ -717,4 +718,16 @@ namespace ncore
 
     } // namespace nhash_private
 
+    namespace nhash
+    {
+        spookyhashv2 hash_spookyhashv2(u8 const* data, u64 len, u64 seed1, u64 seed2)
+        {
+            u64 h[2] = {seed1, seed2};
+            spooky_hash_t::Hash128(data, (s64)len, &h[0], &h[1]);
+            spookyhashv2 digest;
+            nmem::memcpy(digest.m_data, h, sizeof(h));
+            return digest;
+        }
+    } // namespace nhash
+
 } // namespace ncore
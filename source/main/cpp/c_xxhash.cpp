@@ -1,52 +1,37 @@
 #include "ccore/c_target.h"
+#include "cbase/c_memory.h"
 
+#include "chash/c_hash.h"
+#include "chash/private/c_hash_load.h"
+#include "chash/private/c_hash_mix.h"
 #include "chash/private/c_internal_hash.h"
 
 namespace ncore
 {
-    static constexpr u64 PRIME64_1 = 11400714785074694791ULL;
-    static constexpr u64 PRIME64_2 = 14029467366897019727ULL;
-    static constexpr u64 PRIME64_3 = 1609587929392839161ULL;
-    static constexpr u64 PRIME64_4 = 9650029242287828579ULL;
-    static constexpr u64 PRIME64_5 = 2870177450012600261ULL;
-
-    struct xxhash64_ctxt_t
-    {
-        u64 m_total_len;
-        u64 m_v1;
-        u64 m_v2;
-        u64 m_v3;
-        u64 m_v4;
-        u64 m_mem64[4];
-        s32 m_memsize;
-
-        void reset(unsigned long long seed)
-        {
-            m_total_len = 0;
-            m_v1        = seed + PRIME64_1 + PRIME64_2;
-            m_v2        = seed + PRIME64_2;
-            m_v3        = seed + 0;
-            m_v4        = seed - PRIME64_1;
-            m_mem64[0]  = 0;
-            m_mem64[1]  = 0;
-            m_mem64[2]  = 0;
-            m_mem64[3]  = 0;
-            m_memsize   = 0;
-        }
+    using nhash_private::XXH_PRIME64_1;
+    using nhash_private::XXH_PRIME64_2;
+    using nhash_private::XXH_PRIME64_3;
+    using nhash_private::XXH_PRIME64_4;
+    using nhash_private::XXH_PRIME64_5;
+    using nhash_private::XXH_PRIME32_1;
+    using nhash_private::XXH_PRIME32_2;
+    using nhash_private::XXH_PRIME32_3;
+    using nhash_private::XXH_PRIME32_4;
+    using nhash_private::XXH_PRIME32_5;
 
 #define XXH_rotl32(x, r) ((x << r) | (x >> (32 - r)))
 #define XXH_rotl64(x, r) ((x << r) | (x >> (64 - r)))
 
-#define XXH_COPY_MEMORY(dst, src, length)       \
-    {                                           \
-        u8*       pdst = (u8*)(dst);            \
-        u8 const* psrc = (u8 const*)(src);      \
-        for (s32 i = 0; i < (s32)(length); ++i) \
-        {                                       \
-            pdst[i] = psrc[i];                  \
-        }                                       \
-    }
+    // Little-endian loads, as specified by the reference implementation
+    struct xxhash64_reader_t
+    {
+        static u32 read32bits(const void* memPtr) { return nhash_private::load_le32((u8 const*)memPtr); }
+        static u64 read64bits(const void* memPtr) { return nhash_private::load_le64((u8 const*)memPtr); }
+    };
 
+    // Big-endian loads, digests produced by earlier versions of this library depend on it
+    struct xxhash64_legacy_reader_t
+    {
         static u32 read32bits(const void* memPtr)
         {
             u8 const* bptr = (u8 const*)memPtr;
@@ -70,36 +55,75 @@ namespace ncore
             val            = val << 8 | bptr[7];
             return val;
         }
+    };
 
-        static u64 round(u64 acc, u64 input)
+    template <typename R> struct xxhash64_ctxt_t
+    {
+        u64 m_total_len;
+        u64 m_v1;
+        u64 m_v2;
+        u64 m_v3;
+        u64 m_v4;
+        u64 m_mem64[4];
+        s32 m_memsize;
+
+        void reset(unsigned long long seed)
         {
-            acc += input * PRIME64_2;
-            acc = XXH_rotl64(acc, 31);
-            acc *= PRIME64_1;
-            return acc;
+            m_total_len = 0;
+            m_v1        = seed + XXH_PRIME64_1 + XXH_PRIME64_2;
+            m_v2        = seed + XXH_PRIME64_2;
+            m_v3        = seed + 0;
+            m_v4        = seed - XXH_PRIME64_1;
+            m_mem64[0]  = 0;
+            m_mem64[1]  = 0;
+            m_mem64[2]  = 0;
+            m_mem64[3]  = 0;
+            m_memsize   = 0;
         }
 
+        static u64 round(u64 acc, u64 input) { return nhash_private::xxh64_round(acc, input); }
+
         static u64 mergeRound(u64 acc, u64 val)
         {
             val = round(0, val);
             acc ^= val;
-            acc = acc * PRIME64_1 + PRIME64_4;
+            acc = acc * XXH_PRIME64_1 + XXH_PRIME64_4;
             return acc;
         }
 
-        static u64 avalanche(u64 h64)
+        static u64 avalanche(u64 h64) { return nhash_private::xxh64_avalanche(h64); }
+
+        // Consume whole 32 byte stripes, returns the first byte that was not consumed
+        static const u8* stripes(u64& v1, u64& v2, u64& v3, u64& v4, const u8* p, const u8* const bEnd)
+        {
+            const u8* const limit = bEnd - 32;
+            do
+            {
+                v1 = round(v1, R::read64bits(p));
+                p += 8;
+                v2 = round(v2, R::read64bits(p));
+                p += 8;
+                v3 = round(v3, R::read64bits(p));
+                p += 8;
+                v4 = round(v4, R::read64bits(p));
+                p += 8;
+            } while (p <= limit);
+            return p;
+        }
+
+        static u64 merge(u64 v1, u64 v2, u64 v3, u64 v4)
         {
-            h64 ^= h64 >> 33;
-            h64 *= PRIME64_2;
-            h64 ^= h64 >> 29;
-            h64 *= PRIME64_3;
-            h64 ^= h64 >> 32;
+            u64 h64 = XXH_rotl64(v1, 1) + XXH_rotl64(v2, 7) + XXH_rotl64(v3, 12) + XXH_rotl64(v4, 18);
+            h64     = mergeRound(h64, v1);
+            h64     = mergeRound(h64, v2);
+            h64     = mergeRound(h64, v3);
+            h64     = mergeRound(h64, v4);
             return h64;
         }
 
-        void update(const u8* _buffer, u32 size)
+        void update(const u8* _buffer, u64 size)
         {
-            const uint_t    len  = size;
+            const uint_t    len  = (uint_t)size;
             const u8*       p    = _buffer;
             const u8* const bEnd = p + len;
 
@@ -107,74 +131,61 @@ namespace ncore
 
             if (m_memsize + len < 32)
             { /* fill in tmp buffer */
-                XXH_COPY_MEMORY(((u8*)m_mem64) + m_memsize, p, len);
+                nmem::memcpy(((u8*)m_mem64) + m_memsize, p, len);
                 m_memsize += (u32)len;
                 return;
             }
 
             if (m_memsize)
             { /* tmp buffer is full */
-                XXH_COPY_MEMORY(((u8*)m_mem64) + m_memsize, p, 32 - m_memsize);
-                m_v1 = round(m_v1, read64bits(m_mem64 + 0));
-                m_v2 = round(m_v2, read64bits(m_mem64 + 1));
-                m_v3 = round(m_v3, read64bits(m_mem64 + 2));
-                m_v4 = round(m_v4, read64bits(m_mem64 + 3));
+                nmem::memcpy(((u8*)m_mem64) + m_memsize, p, 32 - m_memsize);
+                m_v1 = round(m_v1, R::read64bits(m_mem64 + 0));
+                m_v2 = round(m_v2, R::read64bits(m_mem64 + 1));
+                m_v3 = round(m_v3, R::read64bits(m_mem64 + 2));
+                m_v4 = round(m_v4, R::read64bits(m_mem64 + 3));
                 p += 32 - m_memsize;
                 m_memsize = 0;
             }
 
             if (p + 32 <= bEnd)
             {
-                const u8* const limit = bEnd - 32;
-                u64             v1    = m_v1;
-                u64             v2    = m_v2;
-                u64             v3    = m_v3;
-                u64             v4    = m_v4;
-
-                do
-                {
-                    v1 = round(v1, read64bits(p));
-                    p += 8;
-                    v2 = round(v2, read64bits(p));
-                    p += 8;
-                    v3 = round(v3, read64bits(p));
-                    p += 8;
-                    v4 = round(v4, read64bits(p));
-                    p += 8;
-                } while (p <= limit);
-
-                m_v1 = v1;
-                m_v2 = v2;
-                m_v3 = v3;
-                m_v4 = v4;
+                u64 v1 = m_v1;
+                u64 v2 = m_v2;
+                u64 v3 = m_v3;
+                u64 v4 = m_v4;
+                p      = stripes(v1, v2, v3, v4, p, bEnd);
+                m_v1   = v1;
+                m_v2   = v2;
+                m_v3   = v3;
+                m_v4   = v4;
             }
 
             if (p < bEnd)
             {
-                XXH_COPY_MEMORY(m_mem64, p, (u32)(bEnd - p));
+                nmem::memcpy(m_mem64, p, (u32)(bEnd - p));
                 m_memsize = (unsigned)(bEnd - p);
             }
         }
 
-        u64 finalize(u64 h64, const void* ptr, u32 len)
+        static u64 finalize(u64 h64, const void* ptr, u32 len)
         {
             const u8* p = (const u8*)ptr;
 
-#define PROCESS1_64            \
-    h64 ^= (*p++) * PRIME64_5; \
-    h64 = XXH_rotl64(h64, 11) * PRIME64_1;
-
-#define PROCESS4_64                          \
-    h64 ^= (u64)(read32bits(p)) * PRIME64_1; \
-    p += 4;                                  \
-    h64 = XXH_rotl64(h64, 23) * PRIME64_2 + PRIME64_3;
-
-#define PROCESS8_64                                        \
-    {                                                      \
-        u64 const k1 = round(0, read64bits(p));            \
-        p += 8;                                            \
-        h64 ^= k1;                                         \
-        h64 = XXH_rotl64(h64, 27) * PRIME64_1 + PRIME64_4; \
+#define PROCESS1_64                            \
+    h64 ^= (*p++) * XXH_PRIME64_5;             \
+    h64 = XXH_rotl64(h64, 11) * XXH_PRIME64_1;
+
+#define PROCESS4_64                                            \
+    h64 ^= (u64)(R::read32bits(p)) * XXH_PRIME64_1;            \
+    p += 4;                                                    \
+    h64 = XXH_rotl64(h64, 23) * XXH_PRIME64_2 + XXH_PRIME64_3;
+
+#define PROCESS8_64                                                \
+    {                                                              \
+        u64 const k1 = round(0, R::read64bits(p));                 \
+        p += 8;                                                    \
+        h64 ^= k1;                                                 \
+        h64 = XXH_rotl64(h64, 27) * XXH_PRIME64_1 + XXH_PRIME64_4; \
     }
 
             len &= 31;
@@ -200,26 +211,39 @@ namespace ncore
         {
             u64 h64;
             if (m_total_len >= 32)
+                h64 = merge(m_v1, m_v2, m_v3, m_v4);
+            else
+                h64 = m_v3 /*seed*/ + XXH_PRIME64_5;
+
+            h64 += (u64)m_total_len;
+            write(finalize(h64, m_mem64, (u32)m_memsize), hash);
+        }
+
+        // One-shot, works directly on the input without going through the tmp buffer
+        static u64 hash(const u8* p, u64 len, u64 seed)
+        {
+            const u8* const bEnd = p + len;
+            u64             h64;
+            if (len >= 32)
             {
-                u64 const v1 = m_v1;
-                u64 const v2 = m_v2;
-                u64 const v3 = m_v3;
-                u64 const v4 = m_v4;
-
-                h64 = XXH_rotl64(v1, 1) + XXH_rotl64(v2, 7) + XXH_rotl64(v3, 12) + XXH_rotl64(v4, 18);
-                h64 = mergeRound(h64, v1);
-                h64 = mergeRound(h64, v2);
-                h64 = mergeRound(h64, v3);
-                h64 = mergeRound(h64, v4);
+                u64 v1 = seed + XXH_PRIME64_1 + XXH_PRIME64_2;
+                u64 v2 = seed + XXH_PRIME64_2;
+                u64 v3 = seed + 0;
+                u64 v4 = seed - XXH_PRIME64_1;
+                p      = stripes(v1, v2, v3, v4, p, bEnd);
+                h64    = merge(v1, v2, v3, v4);
             }
             else
             {
-                h64 = m_v3 /*seed*/ + PRIME64_5;
+                h64 = seed + XXH_PRIME64_5;
             }
 
-            h64 += (u64)m_total_len;
-            u64 digest = finalize(h64, m_mem64, (u32)m_total_len);
+            h64 += len;
+            return finalize(h64, p, (u32)(bEnd - p));
+        }
 
+        static void write(u64 digest, u8* hash)
+        {
             hash[0] = (digest & 0xFF);
             digest  = digest >> 8;
             hash[1] = (digest & 0xFF);
@@ -238,25 +262,258 @@ namespace ncore
         }
     };
 
+    // XXH32, the same 4 lane structure as XXH64 with 32-bit lanes and 16 byte stripes
+    struct xxhash32_ctxt_t
+    {
+        typedef xxhash64_reader_t R;
+
+        u64 m_total_len;
+        u32 m_v1;
+        u32 m_v2;
+        u32 m_v3;
+        u32 m_v4;
+        u32 m_mem32[4];
+        s32 m_memsize;
+
+        void reset(u32 seed)
+        {
+            m_total_len = 0;
+            m_v1        = seed + XXH_PRIME32_1 + XXH_PRIME32_2;
+            m_v2        = seed + XXH_PRIME32_2;
+            m_v3        = seed + 0;
+            m_v4        = seed - XXH_PRIME32_1;
+            m_mem32[0]  = 0;
+            m_mem32[1]  = 0;
+            m_mem32[2]  = 0;
+            m_mem32[3]  = 0;
+            m_memsize   = 0;
+        }
+
+        static u32 round(u32 acc, u32 input)
+        {
+            acc += input * XXH_PRIME32_2;
+            acc = XXH_rotl32(acc, 13);
+            acc *= XXH_PRIME32_1;
+            return acc;
+        }
+
+        static u32 avalanche(u32 h32)
+        {
+            h32 ^= h32 >> 15;
+            h32 *= XXH_PRIME32_2;
+            h32 ^= h32 >> 13;
+            h32 *= XXH_PRIME32_3;
+            h32 ^= h32 >> 16;
+            return h32;
+        }
+
+        // Consume whole 16 byte stripes, returns the first byte that was not consumed
+        static const u8* stripes(u32& v1, u32& v2, u32& v3, u32& v4, const u8* p, const u8* const bEnd)
+        {
+            const u8* const limit = bEnd - 16;
+            do
+            {
+                v1 = round(v1, R::read32bits(p));
+                p += 4;
+                v2 = round(v2, R::read32bits(p));
+                p += 4;
+                v3 = round(v3, R::read32bits(p));
+                p += 4;
+                v4 = round(v4, R::read32bits(p));
+                p += 4;
+            } while (p <= limit);
+            return p;
+        }
+
+        void update(const u8* _buffer, u64 size)
+        {
+            const uint_t    len  = (uint_t)size;
+            const u8*       p    = _buffer;
+            const u8* const bEnd = p + len;
+
+            m_total_len += len;
+
+            if (m_memsize + len < 16)
+            { /* fill in tmp buffer */
+                nmem::memcpy(((u8*)m_mem32) + m_memsize, p, len);
+                m_memsize += (u32)len;
+                return;
+            }
+
+            if (m_memsize)
+            { /* tmp buffer is full */
+                nmem::memcpy(((u8*)m_mem32) + m_memsize, p, 16 - m_memsize);
+                m_v1 = round(m_v1, R::read32bits(m_mem32 + 0));
+                m_v2 = round(m_v2, R::read32bits(m_mem32 + 1));
+                m_v3 = round(m_v3, R::read32bits(m_mem32 + 2));
+                m_v4 = round(m_v4, R::read32bits(m_mem32 + 3));
+                p += 16 - m_memsize;
+                m_memsize = 0;
+            }
+
+            if (p + 16 <= bEnd)
+                p = stripes(m_v1, m_v2, m_v3, m_v4, p, bEnd);
+
+            if (p < bEnd)
+            {
+                nmem::memcpy(m_mem32, p, (u32)(bEnd - p));
+                m_memsize = (unsigned)(bEnd - p);
+            }
+        }
+
+        static u32 finalize(u32 h32, const void* ptr, u32 len)
+        {
+            const u8* p = (const u8*)ptr;
+
+            len &= 15;
+            while (len >= 4)
+            {
+                h32 += R::read32bits(p) * XXH_PRIME32_3;
+                p += 4;
+                h32 = XXH_rotl32(h32, 17) * XXH_PRIME32_4;
+                len -= 4;
+            }
+            while (len > 0)
+            {
+                h32 += (*p++) * XXH_PRIME32_5;
+                h32 = XXH_rotl32(h32, 11) * XXH_PRIME32_1;
+                --len;
+            }
+            return avalanche(h32);
+        }
+
+        static u32 merge(u32 v1, u32 v2, u32 v3, u32 v4) { return XXH_rotl32(v1, 1) + XXH_rotl32(v2, 7) + XXH_rotl32(v3, 12) + XXH_rotl32(v4, 18); }
+
+        u32 digest() const
+        {
+            u32 h32;
+            if (m_total_len >= 16)
+                h32 = merge(m_v1, m_v2, m_v3, m_v4);
+            else
+                h32 = m_v3 /*seed*/ + XXH_PRIME32_5;
+
+            h32 += (u32)m_total_len;
+            return finalize(h32, m_mem32, (u32)m_memsize);
+        }
+
+        // One-shot, works directly on the input without going through the tmp buffer
+        static u32 hash(const u8* p, u64 len, u32 seed)
+        {
+            const u8* const bEnd = p + len;
+            u32             h32;
+            if (len >= 16)
+            {
+                u32 v1 = seed + XXH_PRIME32_1 + XXH_PRIME32_2;
+                u32 v2 = seed + XXH_PRIME32_2;
+                u32 v3 = seed + 0;
+                u32 v4 = seed - XXH_PRIME32_1;
+                p      = stripes(v1, v2, v3, v4, p, bEnd);
+                h32    = merge(v1, v2, v3, v4);
+            }
+            else
+            {
+                h32 = seed + XXH_PRIME32_5;
+            }
+
+            h32 += (u32)len;
+            return finalize(h32, p, (u32)(bEnd - p));
+        }
+    };
+
+    typedef xxhash64_ctxt_t<xxhash64_reader_t>        xxhash64_ref_ctxt_t;
+    typedef xxhash64_ctxt_t<xxhash64_legacy_reader_t> xxhash64_legacy_ctxt_t;
+
     namespace nhash_private
     {
         void xxhash64_t::reset(u64 seed)
         {
-            xxhash64_ctxt_t* ctx = (xxhash64_ctxt_t*)&this->m_ctxt;
-            m_seed               = seed;
+            xxhash64_ref_ctxt_t* ctx = (xxhash64_ref_ctxt_t*)&this->m_ctxt;
+            m_seed                   = seed;
             ctx->reset(m_seed);
         }
 
         void xxhash64_t::hash(const u8* begin, const u8* end)
         {
-            xxhash64_ctxt_t* ctx = (xxhash64_ctxt_t*)&this->m_ctxt;
-            ctx->update(begin, (u32)(end - begin));
+            xxhash64_ref_ctxt_t* ctx = (xxhash64_ref_ctxt_t*)&this->m_ctxt;
+            ctx->update(begin, (u64)(end - begin));
         }
 
         void xxhash64_t::end(u8* out_hash)
         {
-            xxhash64_ctxt_t* ctx = (xxhash64_ctxt_t*)&this->m_ctxt;
+            xxhash64_ref_ctxt_t* ctx = (xxhash64_ref_ctxt_t*)&this->m_ctxt;
+            ctx->digest(out_hash);
+        }
+
+        void xxhash32_t::reset(u64 seed)
+        {
+            xxhash32_ctxt_t* ctx = (xxhash32_ctxt_t*)&this->m_ctxt;
+            m_seed               = seed;
+            ctx->reset((u32)m_seed);
+        }
+
+        void xxhash32_t::hash(const u8* begin, const u8* end)
+        {
+            xxhash32_ctxt_t* ctx = (xxhash32_ctxt_t*)&this->m_ctxt;
+            ctx->update(begin, (u64)(end - begin));
+        }
+
+        void xxhash32_t::end(u8* out_hash)
+        {
+            xxhash32_ctxt_t* ctx    = (xxhash32_ctxt_t*)&this->m_ctxt;
+            u32              digest = ctx->digest();
+            out_hash[0]             = (u8)(digest);
+            out_hash[1]             = (u8)(digest >> 8);
+            out_hash[2]             = (u8)(digest >> 16);
+            out_hash[3]             = (u8)(digest >> 24);
+        }
+
+        u32 xxhash32_t::hash32(const void* message, s64 length, u32 seed) { return xxhash32_ctxt_t::hash((const u8*)message, (u64)length, seed); }
+
+        void xxhash64_legacy_t::reset(u64 seed)
+        {
+            xxhash64_legacy_ctxt_t* ctx = (xxhash64_legacy_ctxt_t*)&this->m_ctxt;
+            m_seed                      = seed;
+            ctx->reset(m_seed);
+        }
+
+        void xxhash64_legacy_t::hash(const u8* begin, const u8* end)
+        {
+            xxhash64_legacy_ctxt_t* ctx = (xxhash64_legacy_ctxt_t*)&this->m_ctxt;
+            ctx->update(begin, (u64)(end - begin));
+        }
+
+        void xxhash64_legacy_t::end(u8* out_hash)
+        {
+            xxhash64_legacy_ctxt_t* ctx = (xxhash64_legacy_ctxt_t*)&this->m_ctxt;
             ctx->digest(out_hash);
         }
     } // namespace nhash_private
+
+    namespace nhash
+    {
+        xxhash32 hash_xxhash32(u8 const* data, u64 len, u32 seed)
+        {
+            u32 const h32 = xxhash32_ctxt_t::hash(data, len, seed);
+            xxhash32  digest;
+            digest.m_data[0] = (u8)(h32);
+            digest.m_data[1] = (u8)(h32 >> 8);
+            digest.m_data[2] = (u8)(h32 >> 16);
+            digest.m_data[3] = (u8)(h32 >> 24);
+            return digest;
+        }
+
+        xxhash64 hash_xxhash64(u8 const* data, u64 len, u64 seed)
+        {
+            xxhash64 digest;
+            xxhash64_ref_ctxt_t::write(xxhash64_ref_ctxt_t::hash(data, len, seed), digest.m_data);
+            return digest;
+        }
+
+        xxhash64legacy hash_xxhash64legacy(u8 const* data, u64 len, u64 seed)
+        {
+            xxhash64legacy digest;
+            xxhash64_legacy_ctxt_t::write(xxhash64_legacy_ctxt_t::hash(data, len, seed), digest.m_data);
+            return digest;
+        }
+    } // namespace nhash
 } // namespace ncore
@@ -0,0 +1,784 @@
+#include "ccore/c_target.h"
+#include "cbase/c_memory.h"
+
+#include "chash/private/c_hash_cpu.h"
+#include "chash/c_hash.h"
+#include "chash/private/c_hash_load.h"
+#include "chash/private/c_internal_hash.h"
+
+#if defined(CHASH_X64)
+#    include <immintrin.h>
+#    if defined(_MSC_VER) && !defined(__clang__)
+#        include <intrin.h>
+#    endif
+#endif
+
+namespace ncore
+{
+    // XXH3, see https://github.com/Cyan4973/xxHash/blob/dev/doc/xxhash_spec.md
+    static constexpr u32 XXH3_PRIME32_1 = 0x9E3779B1U;
+    static constexpr u32 XXH3_PRIME32_2 = 0x85EBCA77U;
+    static constexpr u32 XXH3_PRIME32_3 = 0xC2B2AE3DU;
+    static constexpr u64 XXH3_PRIME64_1 = 0x9E3779B185EBCA87ULL;
+    static constexpr u64 XXH3_PRIME64_2 = 0xC2B2AE3D27D4EB4FULL;
+    static constexpr u64 XXH3_PRIME64_3 = 0x165667B19E3779F9ULL;
+    static constexpr u64 XXH3_PRIME64_4 = 0x85EBCA77C2B2AE63ULL;
+    static constexpr u64 XXH3_PRIME64_5 = 0x27D4EB2F165667C5ULL;
+    static constexpr u64 XXH3_PRIME_MX1 = 0x165667919E3779F9ULL;
+    static constexpr u64 XXH3_PRIME_MX2 = 0x9FB21C651E98DF25ULL;
+
+    enum EXXH3
+    {
+        XXH3_SECRET_SIZE         = 192,
+        XXH3_SECRET_SIZE_MIN     = 136,
+        XXH3_STRIPE_LEN          = 64,
+        XXH3_SECRET_CONSUME_RATE = 8,
+        XXH3_STRIPES_PER_BLOCK   = (XXH3_SECRET_SIZE - XXH3_STRIPE_LEN) / XXH3_SECRET_CONSUME_RATE,
+        XXH3_SECRET_LIMIT        = XXH3_SECRET_SIZE - XXH3_STRIPE_LEN,
+        XXH3_SECRET_LASTACC      = 7,
+        XXH3_SECRET_MERGEACCS    = 11,
+        XXH3_MIDSIZE_MAX         = 240,
+        XXH3_MIDSIZE_STARTOFFSET = 3,
+        XXH3_MIDSIZE_LASTOFFSET  = 17,
+        XXH3_BUFFER_SIZE         = 256,
+    };
+
+    // Pseudorandom secret taken directly from FARSH
+    static const u8 XXH3_kSecret[XXH3_SECRET_SIZE] = {
+        0xb8, 0xfe, 0x6c, 0x39, 0x23, 0xa4, 0x4b, 0xbe, 0x7c, 0x01, 0x81, 0x2c, 0xf7, 0x21, 0xad, 0x1c, 0xde, 0xd4, 0x6d, 0xe9, 0x83, 0x90, 0x97, 0xdb, 0x72, 0x40, 0xa4, 0xa4, 0xb7, 0xb3, 0x67, 0x1f,
+        0xcb, 0x79, 0xe6, 0x4e, 0xcc, 0xc0, 0xe5, 0x78, 0x82, 0x5a, 0xd0, 0x7d, 0xcc, 0xff, 0x72, 0x21, 0xb8, 0x08, 0x46, 0x74, 0xf7, 0x43, 0x24, 0x8e, 0xe0, 0x35, 0x90, 0xe6, 0x81, 0x3a, 0x26, 0x4c,
+        0x3c, 0x28, 0x52, 0xbb, 0x91, 0xc3, 0x00, 0xcb, 0x88, 0xd0, 0x65, 0x8b, 0x1b, 0x53, 0x2e, 0xa3, 0x71, 0x64, 0x48, 0x97, 0xa2, 0x0d, 0xf9, 0x4e, 0x38, 0x19, 0xef, 0x46, 0xa9, 0xde, 0xac, 0xd8,
+        0xa8, 0xfa, 0x76, 0x3f, 0xe3, 0x9c, 0x34, 0x3f, 0xf9, 0xdc, 0xbb, 0xc7, 0xc7, 0x0b, 0x4f, 0x1d, 0x8a, 0x51, 0xe0, 0x4b, 0xcd, 0xb4, 0x59, 0x31, 0xc8, 0x9f, 0x7e, 0xc9, 0xd9, 0x78, 0x73, 0x64,
+        0xea, 0xc5, 0xac, 0x83, 0x34, 0xd3, 0xeb, 0xc3, 0xc5, 0x81, 0xa0, 0xff, 0xfa, 0x13, 0x63, 0xeb, 0x17, 0x0d, 0xdd, 0x51, 0xb7, 0xf0, 0xda, 0x49, 0xd3, 0x16, 0x55, 0x26, 0x29, 0xd4, 0x68, 0x9e,
+        0x2b, 0x16, 0xbe, 0x58, 0x7d, 0x47, 0xa1, 0xfc, 0x8f, 0xf8, 0xb8, 0xd1, 0x7a, 0xd0, 0x31, 0xce, 0x45, 0xcb, 0x3a, 0x8f, 0x95, 0x16, 0x04, 0x28, 0xaf, 0xd7, 0xfb, 0xca, 0xbb, 0x4b, 0x40, 0x7e,
+    };
+
+    struct xxh3_u128_t
+    {
+        u64 lo;
+        u64 hi;
+    };
+
+    static inline void xxh3_write64(u8* p, u64 v)
+    {
+        for (s32 i = 0; i < 8; ++i)
+            p[i] = (u8)(v >> (8 * i));
+    }
+
+    static inline u32 xxh3_swap32(u32 x) { return ((x << 24) & 0xff000000) | ((x << 8) & 0x00ff0000) | ((x >> 8) & 0x0000ff00) | ((x >> 24) & 0x000000ff); }
+    static inline u64 xxh3_swap64(u64 x) { return ((u64)xxh3_swap32((u32)x) << 32) | (u64)xxh3_swap32((u32)(x >> 32)); }
+    static inline u32 xxh3_rotl32(u32 x, s32 r) { return (x << r) | (x >> (32 - r)); }
+    static inline u64 xxh3_rotl64(u64 x, s32 r) { return (x << r) | (x >> (64 - r)); }
+    static inline u64 xxh3_xorshift64(u64 v, s32 shift) { return v ^ (v >> shift); }
+
+    static inline xxh3_u128_t xxh3_mult64to128(u64 lhs, u64 rhs)
+    {
+        xxh3_u128_t r;
+#if defined(__SIZEOF_INT128__)
+        __uint128_t const product = (__uint128_t)lhs * rhs;
+        r.lo                      = (u64)product;
+        r.hi                      = (u64)(product >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+        r.lo = _umul128(lhs, rhs, &r.hi);
+#else
+        u64 const lo_lo = (lhs & 0xFFFFFFFF) * (rhs & 0xFFFFFFFF);
+        u64 const hi_lo = (lhs >> 32) * (rhs & 0xFFFFFFFF);
+        u64 const lo_hi = (lhs & 0xFFFFFFFF) * (rhs >> 32);
+        u64 const hi_hi = (lhs >> 32) * (rhs >> 32);
+        u64 const cross = (lo_lo >> 32) + (hi_lo & 0xFFFFFFFF) + lo_hi;
+        r.hi            = (hi_lo >> 32) + (cross >> 32) + hi_hi;
+        r.lo            = (cross << 32) | (lo_lo & 0xFFFFFFFF);
+#endif
+        return r;
+    }
+
+    static inline u64 xxh3_mul128_fold64(u64 lhs, u64 rhs)
+    {
+        xxh3_u128_t const product = xxh3_mult64to128(lhs, rhs);
+        return product.lo ^ product.hi;
+    }
+
+    static inline u64 xxh64_avalanche(u64 h)
+    {
+        h ^= h >> 33;
+        h *= XXH3_PRIME64_2;
+        h ^= h >> 29;
+        h *= XXH3_PRIME64_3;
+        h ^= h >> 32;
+        return h;
+    }
+
+    static inline u64 xxh3_avalanche(u64 h)
+    {
+        h = xxh3_xorshift64(h, 37);
+        h *= XXH3_PRIME_MX1;
+        return xxh3_xorshift64(h, 32);
+    }
+
+    static inline u64 xxh3_rrmxmx(u64 h, u64 len)
+    {
+        h ^= xxh3_rotl64(h, 49) ^ xxh3_rotl64(h, 24);
+        h *= XXH3_PRIME_MX2;
+        h ^= (h >> 35) + len;
+        h *= XXH3_PRIME_MX2;
+        return xxh3_xorshift64(h, 28);
+    }
+
+    // ---------------------------------------------------------------------------------------
+    // Short inputs, 0 to 240 bytes. Every size class reads its input with a fixed number of
+    // (overlapping) loads, so there are no loops or per-byte branches.
+
+    static inline u64 xxh3_len_1to3_64(u8 const* input, uint_t len, u8 const* secret, u64 seed)
+    {
+        u8 const  c1       = input[0];
+        u8 const  c2       = input[len >> 1];
+        u8 const  c3       = input[len - 1];
+        u32 const combined = ((u32)c1 << 16) | ((u32)c2 << 24) | ((u32)c3 << 0) | ((u32)len << 8);
+        u64 const bitflip  = (nhash_private::load_le32(secret) ^ nhash_private::load_le32(secret + 4)) + seed;
+        return xxh64_avalanche((u64)combined ^ bitflip);
+    }
+
+    static inline u64 xxh3_len_4to8_64(u8 const* input, uint_t len, u8 const* secret, u64 seed)
+    {
+        seed ^= (u64)xxh3_swap32((u32)seed) << 32;
+        u32 const input1  = nhash_private::load_le32(input);
+        u32 const input2  = nhash_private::load_le32(input + len - 4);
+        u64 const bitflip = (nhash_private::load_le64(secret + 8) ^ nhash_private::load_le64(secret + 16)) - seed;
+        u64 const input64 = input2 + (((u64)input1) << 32);
+        return xxh3_rrmxmx(input64 ^ bitflip, len);
+    }
+
+    static inline u64 xxh3_len_9to16_64(u8 const* input, uint_t len, u8 const* secret, u64 seed)
+    {
+        u64 const bitflip1 = (nhash_private::load_le64(secret + 24) ^ nhash_private::load_le64(secret + 32)) + seed;
+        u64 const bitflip2 = (nhash_private::load_le64(secret + 40) ^ nhash_private::load_le64(secret + 48)) - seed;
+        u64 const input_lo = nhash_private::load_le64(input) ^ bitflip1;
+        u64 const input_hi = nhash_private::load_le64(input + len - 8) ^ bitflip2;
+        u64 const acc      = len + xxh3_swap64(input_lo) + input_hi + xxh3_mul128_fold64(input_lo, input_hi);
+        return xxh3_avalanche(acc);
+    }
+
+    static inline u64 xxh3_len_0to16_64(u8 const* input, uint_t len, u8 const* secret, u64 seed)
+    {
+        if (len > 8)
+            return xxh3_len_9to16_64(input, len, secret, seed);
+        if (len >= 4)
+            return xxh3_len_4to8_64(input, len, secret, seed);
+        if (len)
+            return xxh3_len_1to3_64(input, len, secret, seed);
+        return xxh64_avalanche(seed ^ (nhash_private::load_le64(secret + 56) ^ nhash_private::load_le64(secret + 64)));
+    }
+
+    static inline u64 xxh3_mix16B(u8 const* input, u8 const* secret, u64 seed)
+    {
+        u64 const input_lo = nhash_private::load_le64(input);
+        u64 const input_hi = nhash_private::load_le64(input + 8);
+        return xxh3_mul128_fold64(input_lo ^ (nhash_private::load_le64(secret) + seed), input_hi ^ (nhash_private::load_le64(secret + 8) - seed));
+    }
+
+    static inline u64 xxh3_len_17to128_64(u8 const* input, uint_t len, u8 const* secret, u64 seed)
+    {
+        u64 acc = len * XXH3_PRIME64_1;
+        if (len > 32)
+        {
+            if (len > 64)
+            {
+                if (len > 96)
+                {
+                    acc += xxh3_mix16B(input + 48, secret + 96, seed);
+                    acc += xxh3_mix16B(input + len - 64, secret + 112, seed);
+                }
+                acc += xxh3_mix16B(input + 32, secret + 64, seed);
+                acc += xxh3_mix16B(input + len - 48, secret + 80, seed);
+            }
+            acc += xxh3_mix16B(input + 16, secret + 32, seed);
+            acc += xxh3_mix16B(input + len - 32, secret + 48, seed);
+        }
+        acc += xxh3_mix16B(input + 0, secret + 0, seed);
+        acc += xxh3_mix16B(input + len - 16, secret + 16, seed);
+        return xxh3_avalanche(acc);
+    }
+
+    static u64 xxh3_len_129to240_64(u8 const* input, uint_t len, u8 const* secret, u64 seed)
+    {
+        u64       acc      = len * XXH3_PRIME64_1;
+        s32 const nbRounds = (s32)len / 16;
+        for (s32 i = 0; i < 8; i++)
+            acc += xxh3_mix16B(input + (16 * i), secret + (16 * i), seed);
+        u64 acc_end = xxh3_mix16B(input + len - 16, secret + XXH3_SECRET_SIZE_MIN - XXH3_MIDSIZE_LASTOFFSET, seed);
+        acc         = xxh3_avalanche(acc);
+        for (s32 i = 8; i < nbRounds; i++)
+            acc_end += xxh3_mix16B(input + (16 * i), secret + (16 * (i - 8)) + XXH3_MIDSIZE_STARTOFFSET, seed);
+        return xxh3_avalanche(acc + acc_end);
+    }
+
+    static inline xxh3_u128_t xxh3_len_1to3_128(u8 const* input, uint_t len, u8 const* secret, u64 seed)
+    {
+        u8 const    c1        = input[0];
+        u8 const    c2        = input[len >> 1];
+        u8 const    c3        = input[len - 1];
+        u32 const   combinedl = ((u32)c1 << 16) | ((u32)c2 << 24) | ((u32)c3 << 0) | ((u32)len << 8);
+        u32 const   combinedh = xxh3_rotl32(xxh3_swap32(combinedl), 13);
+        u64 const   bitflipl  = (nhash_private::load_le32(secret) ^ nhash_private::load_le32(secret + 4)) + seed;
+        u64 const   bitfliph  = (nhash_private::load_le32(secret + 8) ^ nhash_private::load_le32(secret + 12)) - seed;
+        xxh3_u128_t h128;
+        h128.lo = xxh64_avalanche((u64)combinedl ^ bitflipl);
+        h128.hi = xxh64_avalanche((u64)combinedh ^ bitfliph);
+        return h128;
+    }
+
+    static inline xxh3_u128_t xxh3_len_4to8_128(u8 const* input, uint_t len, u8 const* secret, u64 seed)
+    {
+        seed ^= (u64)xxh3_swap32((u32)seed) << 32;
+        u32 const   input_lo = nhash_private::load_le32(input);
+        u32 const   input_hi = nhash_private::load_le32(input + len - 4);
+        u64 const   input_64 = input_lo + ((u64)input_hi << 32);
+        u64 const   bitflip  = (nhash_private::load_le64(secret + 16) ^ nhash_private::load_le64(secret + 24)) + seed;
+        u64 const   keyed    = input_64 ^ bitflip;
+        xxh3_u128_t m128     = xxh3_mult64to128(keyed, XXH3_PRIME64_1 + (len << 2));
+        m128.hi += (m128.lo << 1);
+        m128.lo ^= (m128.hi >> 3);
+        m128.lo = xxh3_xorshift64(m128.lo, 35);
+        m128.lo *= XXH3_PRIME_MX2;
+        m128.lo = xxh3_xorshift64(m128.lo, 28);
+        m128.hi = xxh3_avalanche(m128.hi);
+        return m128;
+    }
+
+    static inline xxh3_u128_t xxh3_len_9to16_128(u8 const* input, uint_t len, u8 const* secret, u64 seed)
+    {
+        u64 const   bitflipl = (nhash_private::load_le64(secret + 32) ^ nhash_private::load_le64(secret + 40)) - seed;
+        u64 const   bitfliph = (nhash_private::load_le64(secret + 48) ^ nhash_private::load_le64(secret + 56)) + seed;
+        u64 const   input_lo = nhash_private::load_le64(input);
+        u64         input_hi = nhash_private::load_le64(input + len - 8);
+        xxh3_u128_t m128     = xxh3_mult64to128(input_lo ^ input_hi ^ bitflipl, XXH3_PRIME64_1);
+        m128.lo += (u64)(len - 1) << 54;
+        input_hi ^= bitfliph;
+        m128.hi += input_hi + (u64)(u32)input_hi * (XXH3_PRIME32_2 - 1);
+        m128.lo ^= xxh3_swap64(m128.hi);
+        xxh3_u128_t h128 = xxh3_mult64to128(m128.lo, XXH3_PRIME64_2);
+        h128.hi += m128.hi * XXH3_PRIME64_2;
+        h128.lo = xxh3_avalanche(h128.lo);
+        h128.hi = xxh3_avalanche(h128.hi);
+        return h128;
+    }
+
+    static inline xxh3_u128_t xxh3_len_0to16_128(u8 const* input, uint_t len, u8 const* secret, u64 seed)
+    {
+        if (len > 8)
+            return xxh3_len_9to16_128(input, len, secret, seed);
+        if (len >= 4)
+            return xxh3_len_4to8_128(input, len, secret, seed);
+        if (len)
+            return xxh3_len_1to3_128(input, len, secret, seed);
+        xxh3_u128_t h128;
+        h128.lo = xxh64_avalanche(seed ^ (nhash_private::load_le64(secret + 64) ^ nhash_private::load_le64(secret + 72)));
+        h128.hi = xxh64_avalanche(seed ^ (nhash_private::load_le64(secret + 80) ^ nhash_private::load_le64(secret + 88)));
+        return h128;
+    }
+
+    static inline xxh3_u128_t xxh3_mix32B(xxh3_u128_t acc, u8 const* input_1, u8 const* input_2, u8 const* secret, u64 seed)
+    {
+        acc.lo += xxh3_mix16B(input_1, secret + 0, seed);
+        acc.lo ^= nhash_private::load_le64(input_2) + nhash_private::load_le64(input_2 + 8);
+        acc.hi += xxh3_mix16B(input_2, secret + 16, seed);
+        acc.hi ^= nhash_private::load_le64(input_1) + nhash_private::load_le64(input_1 + 8);
+        return acc;
+    }
+
+    static inline xxh3_u128_t xxh3_finalize_mid_128(xxh3_u128_t acc, uint_t len, u64 seed)
+    {
+        xxh3_u128_t h128;
+        h128.lo = acc.lo + acc.hi;
+        h128.hi = (acc.lo * XXH3_PRIME64_1) + (acc.hi * XXH3_PRIME64_4) + ((len - seed) * XXH3_PRIME64_2);
+        h128.lo = xxh3_avalanche(h128.lo);
+        h128.hi = (u64)0 - xxh3_avalanche(h128.hi);
+        return h128;
+    }
+
+    static inline xxh3_u128_t xxh3_len_17to128_128(u8 const* input, uint_t len, u8 const* secret, u64 seed)
+    {
+        xxh3_u128_t acc;
+        acc.lo = len * XXH3_PRIME64_1;
+        acc.hi = 0;
+        if (len > 32)
+        {
+            if (len > 64)
+            {
+                if (len > 96)
+                    acc = xxh3_mix32B(acc, input + 48, input + len - 64, secret + 96, seed);
+                acc = xxh3_mix32B(acc, input + 32, input + len - 48, secret + 64, seed);
+            }
+            acc = xxh3_mix32B(acc, input + 16, input + len - 32, secret + 32, seed);
+        }
+        acc = xxh3_mix32B(acc, input, input + len - 16, secret, seed);
+        return xxh3_finalize_mid_128(acc, len, seed);
+    }
+
+    static xxh3_u128_t xxh3_len_129to240_128(u8 const* input, uint_t len, u8 const* secret, u64 seed)
+    {
+        xxh3_u128_t acc;
+        acc.lo = len * XXH3_PRIME64_1;
+        acc.hi = 0;
+        for (uint_t i = 32; i < 160; i += 32)
+            acc = xxh3_mix32B(acc, input + i - 32, input + i - 16, secret + i - 32, seed);
+        acc.lo = xxh3_avalanche(acc.lo);
+        acc.hi = xxh3_avalanche(acc.hi);
+        for (uint_t i = 160; i <= len; i += 32)
+            acc = xxh3_mix32B(acc, input + i - 32, input + i - 16, secret + XXH3_MIDSIZE_STARTOFFSET + i - 160, seed);
+        acc = xxh3_mix32B(acc, input + len - 16, input + len - 32, secret + XXH3_SECRET_SIZE_MIN - XXH3_MIDSIZE_LASTOFFSET - 16, (u64)0 - seed);
+        return xxh3_finalize_mid_128(acc, len, seed);
+    }
+
+    // ---------------------------------------------------------------------------------------
+    // Long inputs, 8 lanes of 64-bit accumulators over stripes of 64 bytes. A block of 16
+    // stripes is followed by a scramble of the accumulators.
+
+    typedef void (*xxh3_accumulate_fn)(u64* acc, u8 const* input, u8 const* secret, uint_t nbStripes);
+    typedef void (*xxh3_scramble_fn)(u64* acc, u8 const* secret);
+
+    struct xxh3_kernel_t
+    {
+        xxh3_accumulate_fn accumulate;
+        xxh3_scramble_fn   scramble;
+    };
+
+    static void xxh3_accumulate_scalar(u64* acc, u8 const* input, u8 const* secret, uint_t nbStripes)
+    {
+        for (uint_t n = 0; n < nbStripes; n++)
+        {
+            u8 const* in  = input + n * XXH3_STRIPE_LEN;
+            u8 const* key = secret + n * XXH3_SECRET_CONSUME_RATE;
+            for (s32 i = 0; i < 8; i++)
+            {
+                u64 const data_val = nhash_private::load_le64(in + i * 8);
+                u64 const data_key = data_val ^ nhash_private::load_le64(key + i * 8);
+                acc[i ^ 1] += data_val;
+                acc[i] += (u64)(u32)data_key * (data_key >> 32);
+            }
+        }
+    }
+
+    static void xxh3_scramble_scalar(u64* acc, u8 const* secret)
+    {
+        for (s32 i = 0; i < 8; i++)
+        {
+            u64 a = xxh3_xorshift64(acc[i], 47);
+            a ^= nhash_private::load_le64(secret + i * 8);
+            acc[i] = a * XXH3_PRIME32_1;
+        }
+    }
+
+#if defined(CHASH_X64)
+    static void xxh3_accumulate_sse2(u64* acc, u8 const* input, u8 const* secret, uint_t nbStripes)
+    {
+        __m128i a0 = _mm_loadu_si128((__m128i const*)acc + 0);
+        __m128i a1 = _mm_loadu_si128((__m128i const*)acc + 1);
+        __m128i a2 = _mm_loadu_si128((__m128i const*)acc + 2);
+        __m128i a3 = _mm_loadu_si128((__m128i const*)acc + 3);
+        for (uint_t n = 0; n < nbStripes; n++)
+        {
+            __m128i const* in  = (__m128i const*)(input + n * XXH3_STRIPE_LEN);
+            __m128i const* key = (__m128i const*)(secret + n * XXH3_SECRET_CONSUME_RATE);
+#    define XXH3_SSE2_ROUND(a, i)                                                             \
+        {                                                                                     \
+            __m128i const data_vec    = _mm_loadu_si128(in + i);                              \
+            __m128i const data_key    = _mm_xor_si128(data_vec, _mm_loadu_si128(key + i));    \
+            __m128i const data_key_lo = _mm_shuffle_epi32(data_key, _MM_SHUFFLE(0, 3, 0, 1)); \
+            __m128i const product     = _mm_mul_epu32(data_key, data_key_lo);                 \
+            __m128i const data_swap   = _mm_shuffle_epi32(data_vec, _MM_SHUFFLE(1, 0, 3, 2)); \
+            a                         = _mm_add_epi64(a, _mm_add_epi64(product, data_swap));  \
+        }
+            XXH3_SSE2_ROUND(a0, 0);
+            XXH3_SSE2_ROUND(a1, 1);
+            XXH3_SSE2_ROUND(a2, 2);
+            XXH3_SSE2_ROUND(a3, 3);
+#    undef XXH3_SSE2_ROUND
+        }
+        _mm_storeu_si128((__m128i*)acc + 0, a0);
+        _mm_storeu_si128((__m128i*)acc + 1, a1);
+        _mm_storeu_si128((__m128i*)acc + 2, a2);
+        _mm_storeu_si128((__m128i*)acc + 3, a3);
+    }
+
+    static void xxh3_scramble_sse2(u64* acc, u8 const* secret)
+    {
+        __m128i const prime32 = _mm_set1_epi32((int)XXH3_PRIME32_1);
+        for (s32 i = 0; i < 4; i++)
+        {
+            __m128i const acc_vec     = _mm_loadu_si128((__m128i const*)acc + i);
+            __m128i const data_vec    = _mm_xor_si128(acc_vec, _mm_srli_epi64(acc_vec, 47));
+            __m128i const data_key    = _mm_xor_si128(data_vec, _mm_loadu_si128((__m128i const*)secret + i));
+            __m128i const data_key_hi = _mm_shuffle_epi32(data_key, _MM_SHUFFLE(0, 3, 0, 1));
+            __m128i const prod_lo     = _mm_mul_epu32(data_key, prime32);
+            __m128i const prod_hi     = _mm_mul_epu32(data_key_hi, prime32);
+            _mm_storeu_si128((__m128i*)acc + i, _mm_add_epi64(prod_lo, _mm_slli_epi64(prod_hi, 32)));
+        }
+    }
+
+    CHASH_TARGET("avx2")
+    static void xxh3_accumulate_avx2(u64* acc, u8 const* input, u8 const* secret, uint_t nbStripes)
+    {
+        __m256i a0 = _mm256_loadu_si256((__m256i const*)acc + 0);
+        __m256i a1 = _mm256_loadu_si256((__m256i const*)acc + 1);
+        for (uint_t n = 0; n < nbStripes; n++)
+        {
+            __m256i const* in  = (__m256i const*)(input + n * XXH3_STRIPE_LEN);
+            __m256i const* key = (__m256i const*)(secret + n * XXH3_SECRET_CONSUME_RATE);
+#    define XXH3_AVX2_ROUND(a, i)                                                                   \
+        {                                                                                           \
+            __m256i const data_vec    = _mm256_loadu_si256(in + i);                                 \
+            __m256i const data_key    = _mm256_xor_si256(data_vec, _mm256_loadu_si256(key + i));    \
+            __m256i const data_key_lo = _mm256_srli_epi64(data_key, 32);                            \
+            __m256i const product     = _mm256_mul_epu32(data_key, data_key_lo);                    \
+            __m256i const data_swap   = _mm256_shuffle_epi32(data_vec, _MM_SHUFFLE(1, 0, 3, 2));    \
+            a                         = _mm256_add_epi64(a, _mm256_add_epi64(product, data_swap));  \
+        }
+            XXH3_AVX2_ROUND(a0, 0);
+            XXH3_AVX2_ROUND(a1, 1);
+#    undef XXH3_AVX2_ROUND
+        }
+        _mm256_storeu_si256((__m256i*)acc + 0, a0);
+        _mm256_storeu_si256((__m256i*)acc + 1, a1);
+    }
+
+    CHASH_TARGET("avx2")
+    static void xxh3_scramble_avx2(u64* acc, u8 const* secret)
+    {
+        __m256i const prime32 = _mm256_set1_epi32((int)XXH3_PRIME32_1);
+        for (s32 i = 0; i < 2; i++)
+        {
+            __m256i const acc_vec     = _mm256_loadu_si256((__m256i const*)acc + i);
+            __m256i const data_vec    = _mm256_xor_si256(acc_vec, _mm256_srli_epi64(acc_vec, 47));
+            __m256i const data_key    = _mm256_xor_si256(data_vec, _mm256_loadu_si256((__m256i const*)secret + i));
+            __m256i const data_key_hi = _mm256_srli_epi64(data_key, 32);
+            __m256i const prod_lo     = _mm256_mul_epu32(data_key, prime32);
+            __m256i const prod_hi     = _mm256_mul_epu32(data_key_hi, prime32);
+            _mm256_storeu_si256((__m256i*)acc + i, _mm256_add_epi64(prod_lo, _mm256_slli_epi64(prod_hi, 32)));
+        }
+    }
+#endif
+
+    static xxh3_kernel_t xxh3_kernel()
+    {
+        xxh3_kernel_t k = {xxh3_accumulate_scalar, xxh3_scramble_scalar};
+#if defined(CHASH_X64)
+        if (nhash_cpu::has(nhash_cpu::AVX2))
+        {
+            k.accumulate = xxh3_accumulate_avx2;
+            k.scramble   = xxh3_scramble_avx2;
+        }
+        else if (nhash_cpu::has(nhash_cpu::SSE2))
+        {
+            k.accumulate = xxh3_accumulate_sse2;
+            k.scramble   = xxh3_scramble_sse2;
+        }
+#endif
+        return k;
+    }
+
+    static inline void xxh3_init_acc(u64* acc)
+    {
+        acc[0] = XXH3_PRIME32_3;
+        acc[1] = XXH3_PRIME64_1;
+        acc[2] = XXH3_PRIME64_2;
+        acc[3] = XXH3_PRIME64_3;
+        acc[4] = XXH3_PRIME64_4;
+        acc[5] = XXH3_PRIME32_2;
+        acc[6] = XXH3_PRIME64_5;
+        acc[7] = XXH3_PRIME32_1;
+    }
+
+    static void xxh3_init_secret(u8* secret, u64 seed)
+    {
+        for (s32 i = 0; i < XXH3_SECRET_SIZE / 16; i++)
+        {
+            xxh3_write64(secret + 16 * i, nhash_private::load_le64(XXH3_kSecret + 16 * i) + seed);
+            xxh3_write64(secret + 16 * i + 8, nhash_private::load_le64(XXH3_kSecret + 16 * i + 8) - seed);
+        }
+    }
+
+    static void xxh3_hash_long_loop(u64* acc, u8 const* input, u64 len, u8 const* secret)
+    {
+        xxh3_kernel_t const k         = xxh3_kernel();
+        u64 const           block_len = XXH3_STRIPE_LEN * XXH3_STRIPES_PER_BLOCK;
+        u64 const           nb_blocks = (len - 1) / block_len;
+        for (u64 n = 0; n < nb_blocks; n++)
+        {
+            k.accumulate(acc, input + n * block_len, secret, XXH3_STRIPES_PER_BLOCK);
+            k.scramble(acc, secret + XXH3_SECRET_LIMIT);
+        }
+
+        // Last partial block and the last stripe, which may overlap the previous one
+        uint_t const nbStripes = (uint_t)(((len - 1) - (block_len * nb_blocks)) / XXH3_STRIPE_LEN);
+        k.accumulate(acc, input + nb_blocks * block_len, secret, nbStripes);
+        k.accumulate(acc, input + len - XXH3_STRIPE_LEN, secret + XXH3_SECRET_LIMIT - XXH3_SECRET_LASTACC, 1);
+    }
+
+    static u64 xxh3_merge_accs(u64 const* acc, u8 const* secret, u64 start)
+    {
+        u64 result = start;
+        for (s32 i = 0; i < 4; i++)
+            result += xxh3_mul128_fold64(acc[2 * i] ^ nhash_private::load_le64(secret + 16 * i), acc[2 * i + 1] ^ nhash_private::load_le64(secret + 16 * i + 8));
+        return xxh3_avalanche(result);
+    }
+
+    static inline u64 xxh3_merge_64(u64 const* acc, u8 const* secret, u64 len) { return xxh3_merge_accs(acc, secret + XXH3_SECRET_MERGEACCS, len * XXH3_PRIME64_1); }
+
+    static inline xxh3_u128_t xxh3_merge_128(u64 const* acc, u8 const* secret, u64 len)
+    {
+        xxh3_u128_t h128;
+        h128.lo = xxh3_merge_accs(acc, secret + XXH3_SECRET_MERGEACCS, len * XXH3_PRIME64_1);
+        h128.hi = xxh3_merge_accs(acc, secret + XXH3_SECRET_SIZE - 64 - XXH3_SECRET_MERGEACCS, ~(len * XXH3_PRIME64_2));
+        return h128;
+    }
+
+    static u64 xxh3_64(u8 const* input, u64 len, u64 seed)
+    {
+        if (len <= 16)
+            return xxh3_len_0to16_64(input, (uint_t)len, XXH3_kSecret, seed);
+        if (len <= 128)
+            return xxh3_len_17to128_64(input, (uint_t)len, XXH3_kSecret, seed);
+        if (len <= XXH3_MIDSIZE_MAX)
+            return xxh3_len_129to240_64(input, (uint_t)len, XXH3_kSecret, seed);
+
+        u8        custom[XXH3_SECRET_SIZE];
+        u8 const* secret = XXH3_kSecret;
+        if (seed != 0)
+        {
+            xxh3_init_secret(custom, seed);
+            secret = custom;
+        }
+        u64 acc[8];
+        xxh3_init_acc(acc);
+        xxh3_hash_long_loop(acc, input, len, secret);
+        return xxh3_merge_64(acc, secret, len);
+    }
+
+    static xxh3_u128_t xxh3_128(u8 const* input, u64 len, u64 seed)
+    {
+        if (len <= 16)
+            return xxh3_len_0to16_128(input, (uint_t)len, XXH3_kSecret, seed);
+        if (len <= 128)
+            return xxh3_len_17to128_128(input, (uint_t)len, XXH3_kSecret, seed);
+        if (len <= XXH3_MIDSIZE_MAX)
+            return xxh3_len_129to240_128(input, (uint_t)len, XXH3_kSecret, seed);
+
+        u8        custom[XXH3_SECRET_SIZE];
+        u8 const* secret = XXH3_kSecret;
+        if (seed != 0)
+        {
+            xxh3_init_secret(custom, seed);
+            secret = custom;
+        }
+        u64 acc[8];
+        xxh3_init_acc(acc);
+        xxh3_hash_long_loop(acc, input, len, secret);
+        return xxh3_merge_128(acc, secret, len);
+    }
+
+    // ---------------------------------------------------------------------------------------
+    // Streaming, input is buffered up to 256 bytes, beyond that whole stripes are consumed
+    // while the last stripe is always kept back for the digest.
+
+    struct xxh3_ctxt_t
+    {
+        u64 m_acc[8];
+        u8  m_secret[XXH3_SECRET_SIZE];
+        u8  m_buffer[XXH3_BUFFER_SIZE];
+        u64 m_total_len;
+        u64 m_seed;
+        u32 m_buffered;
+        u32 m_stripes;  // stripes consumed in the current block
+
+        void reset(u64 seed)
+        {
+            xxh3_init_acc(m_acc);
+            xxh3_init_secret(m_secret, seed);
+            m_total_len = 0;
+            m_seed      = seed;
+            m_buffered  = 0;
+            m_stripes   = 0;
+        }
+
+        static u8 const* consume(u64* acc, u32& ioStripes, u8 const* input, uint_t nbStripes, u8 const* secret, xxh3_kernel_t const& k)
+        {
+            if (nbStripes >= (uint_t)(XXH3_STRIPES_PER_BLOCK - ioStripes))
+            {
+                // Finish the current block, then whole blocks
+                uint_t    stripes = XXH3_STRIPES_PER_BLOCK - ioStripes;
+                u8 const* key     = secret + ioStripes * XXH3_SECRET_CONSUME_RATE;
+                do
+                {
+                    k.accumulate(acc, input, key, stripes);
+                    k.scramble(acc, secret + XXH3_SECRET_LIMIT);
+                    input += stripes * XXH3_STRIPE_LEN;
+                    nbStripes -= stripes;
+                    stripes = XXH3_STRIPES_PER_BLOCK;
+                    key     = secret;
+                } while (nbStripes >= XXH3_STRIPES_PER_BLOCK);
+                ioStripes = 0;
+            }
+            if (nbStripes > 0)
+            {
+                k.accumulate(acc, input, secret + ioStripes * XXH3_SECRET_CONSUME_RATE, nbStripes);
+                input += nbStripes * XXH3_STRIPE_LEN;
+                ioStripes += (u32)nbStripes;
+            }
+            return input;
+        }
+
+        void update(u8 const* input, u64 len)
+        {
+            u8 const* const end = input + len;
+            m_total_len += len;
+
+            if (len <= (u64)(XXH3_BUFFER_SIZE - m_buffered))
+            {
+                nmem::memcpy(m_buffer + m_buffered, input, (uint_t)len);
+                m_buffered += (u32)len;
+                return;
+            }
+
+            xxh3_kernel_t const k = xxh3_kernel();
+            if (m_buffered)
+            {
+                u32 const load = XXH3_BUFFER_SIZE - m_buffered;
+                nmem::memcpy(m_buffer + m_buffered, input, load);
+                input += load;
+                consume(m_acc, m_stripes, m_buffer, XXH3_BUFFER_SIZE / XXH3_STRIPE_LEN, m_secret, k);
+                m_buffered = 0;
+            }
+
+            if (end - input > XXH3_BUFFER_SIZE)
+            {
+                uint_t const nbStripes = (uint_t)(end - 1 - input) / XXH3_STRIPE_LEN;
+                input                  = consume(m_acc, m_stripes, input, nbStripes, m_secret, k);
+                nmem::memcpy(m_buffer + XXH3_BUFFER_SIZE - XXH3_STRIPE_LEN, input - XXH3_STRIPE_LEN, XXH3_STRIPE_LEN);
+            }
+
+            nmem::memcpy(m_buffer, input, (uint_t)(end - input));
+            m_buffered = (u32)(end - input);
+        }
+
+        void digest_long(u64* acc) const
+        {
+            xxh3_kernel_t const k = xxh3_kernel();
+            u8                  last_stripe[XXH3_STRIPE_LEN];
+            u8 const*           last;
+
+            nmem::memcpy(acc, m_acc, sizeof(m_acc));
+            if (m_buffered >= XXH3_STRIPE_LEN)
+            {
+                u32 stripes = m_stripes;
+                consume(acc, stripes, m_buffer, (m_buffered - 1) / XXH3_STRIPE_LEN, m_secret, k);
+                last = m_buffer + m_buffered - XXH3_STRIPE_LEN;
+            }
+            else
+            {
+                // Complete the last stripe with the tail of the previous buffer contents
+                u32 const catchup = XXH3_STRIPE_LEN - m_buffered;
+                nmem::memcpy(last_stripe, m_buffer + XXH3_BUFFER_SIZE - catchup, catchup);
+                nmem::memcpy(last_stripe + catchup, m_buffer, m_buffered);
+                last = last_stripe;
+            }
+            k.accumulate(acc, last, m_secret + XXH3_SECRET_LIMIT - XXH3_SECRET_LASTACC, 1);
+        }
+
+        u64 digest64() const
+        {
+            if (m_total_len > XXH3_MIDSIZE_MAX)
+            {
+                u64 acc[8];
+                digest_long(acc);
+                return xxh3_merge_64(acc, m_secret, m_total_len);
+            }
+            return xxh3_64(m_buffer, m_total_len, m_seed);
+        }
+
+        xxh3_u128_t digest128() const
+        {
+            if (m_total_len > XXH3_MIDSIZE_MAX)
+            {
+                u64 acc[8];
+                digest_long(acc);
+                return xxh3_merge_128(acc, m_secret, m_total_len);
+            }
+            return xxh3_128(m_buffer, m_total_len, m_seed);
+        }
+    };
+
+    namespace nhash_private
+    {
+        static_assert(sizeof(xxh3_ctxt_t) <= sizeof(xxh3_64_t::m_ctxt), "xxh3_64_t context too small");
+        static_assert(sizeof(xxh3_ctxt_t) <= sizeof(xxh3_128_t::m_ctxt), "xxh3_128_t context too small");
+
+        void xxh3_64_t::reset(u64 seed)
+        {
+            xxh3_ctxt_t* ctx = (xxh3_ctxt_t*)&this->m_ctxt;
+            m_seed           = seed;
+            ctx->reset(m_seed);
+        }
+
+        void xxh3_64_t::hash(const u8* begin, const u8* end)
+        {
+            xxh3_ctxt_t* ctx = (xxh3_ctxt_t*)&this->m_ctxt;
+            ctx->update(begin, (u64)(end - begin));
+        }
+
+        void xxh3_64_t::end(u8* out_hash)
+        {
+            xxh3_ctxt_t* ctx = (xxh3_ctxt_t*)&this->m_ctxt;
+            xxh3_write64(out_hash, ctx->digest64());
+        }
+
+        u64 xxh3_64_t::hash64(const void* data, s64 length, u64 seed) { return xxh3_64((u8 const*)data, (u64)length, seed); }
+
+        void xxh3_128_t::reset(u64 seed)
+        {
+            xxh3_ctxt_t* ctx = (xxh3_ctxt_t*)&this->m_ctxt;
+            m_seed           = seed;
+            ctx->reset(m_seed);
+        }
+
+        void xxh3_128_t::hash(const u8* begin, const u8* end)
+        {
+            xxh3_ctxt_t* ctx = (xxh3_ctxt_t*)&this->m_ctxt;
+            ctx->update(begin, (u64)(end - begin));
+        }
+
+        void xxh3_128_t::end(u8* out_hash)
+        {
+            xxh3_ctxt_t*      ctx = (xxh3_ctxt_t*)&this->m_ctxt;
+            xxh3_u128_t const h   = ctx->digest128();
+            xxh3_write64(out_hash, h.lo);
+            xxh3_write64(out_hash + 8, h.hi);
+        }
+
+        void xxh3_128_t::hash128(const void* data, s64 length, u64 seed, u64* low, u64* high)
+        {
+            xxh3_u128_t const h = xxh3_128((u8 const*)data, (u64)length, seed);
+            *low                = h.lo;
+            *high               = h.hi;
+        }
+    } // namespace nhash_private
+
+    namespace nhash
+    {
+        xxh3_64 hash_xxh3_64(u8 const* data, u64 len, u64 seed)
+        {
+            xxh3_64 digest;
+            xxh3_write64(digest.m_data, ncore::xxh3_64(data, len, seed));
+            return digest;
+        }
+
+        xxh3_128 hash_xxh3_128(u8 const* data, u64 len, u64 seed)
+        {
+            xxh3_u128_t const h = ncore::xxh3_128(data, len, seed);
+            xxh3_128          digest;
+            xxh3_write64(digest.m_data, h.lo);
+            xxh3_write64(digest.m_data + 8, h.hi);
+            return digest;
+        }
+    } // namespace nhash
+} // namespace ncore
@@ -16,6 +16,8 @@
 
 namespace ncore
 {
+	class hash_jobs_t;
+
 	/**
 	 * @group		xhash
 	 * @brief		CRC implementations
@@ -24,9 +26,21 @@ namespace ncore
 	{
 	public:
 		static u32			crc32(cbuffer_t const& buffer, u32 inInitVal = 0);
+		static u32			crc32c(cbuffer_t const& buffer, u32 inInitVal = 0);
+		static u64			crc64(cbuffer_t const& buffer, u64 inInitVal = 0);		// CRC-64/XZ
 
 		static u16			adler16(cbuffer_t const& buffer, u16 inInitVal = 1);
 		static u32			adler32(cbuffer_t const& buffer, u32 inInitVal = 1);
+
+		// Checksum of A followed by B from the checksums of A and B, in O(log(inLengthB)) without touching the data
+		static u32			crc32_combine(u32 inCRCA, u32 inCRCB, u64 inLengthB);
+		static u32			crc32c_combine(u32 inCRCA, u32 inCRCB, u64 inLengthB);
+		static u32			adler32_combine(u32 inAdlerA, u32 inAdlerB, u64 inLengthB);
+
+		// Split large buffers into stripes that are checksummed as jobs, the result equals the sequential one
+		static u32			crc32_parallel(cbuffer_t const& buffer, hash_jobs_t* jobs, u32 inInitVal = 0);
+		static u32			crc32c_parallel(cbuffer_t const& buffer, hash_jobs_t* jobs, u32 inInitVal = 0);
+		static u32			adler32_parallel(cbuffer_t const& buffer, hash_jobs_t* jobs, u32 inInitVal = 1);
 	};
 
 
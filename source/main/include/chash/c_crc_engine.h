@@ -0,0 +1,187 @@
+#ifndef __CHASH_CRC_ENGINE_H__
+#define __CHASH_CRC_ENGINE_H__
+#include "ccore/c_target.h"
+#ifdef USE_PRAGMA_ONCE
+#    pragma once
+#endif
+
+#include "ccore/c_debug.h"
+#include "cbase/c_buffer.h"
+
+namespace ncore
+{
+    namespace ncrc
+    {
+        template <s32 Width> struct width_t;
+        template <> struct width_t<8>
+        {
+            typedef u8 type;
+        };
+        template <> struct width_t<16>
+        {
+            typedef u16 type;
+        };
+        template <> struct width_t<32>
+        {
+            typedef u32 type;
+        };
+        template <> struct width_t<64>
+        {
+            typedef u64 type;
+        };
+
+        // Slice k holds the CRC of byte n followed by k zero bytes
+        template <typename T, s32 Slices> struct table_t
+        {
+            T m[Slices][256];
+
+            inline constexpr T const* operator[](s32 slice) const { return m[slice]; }
+        };
+
+        // Mirror the lower <width> bits of <v>
+        inline constexpr u64 reflect(u64 v, s32 width)
+        {
+            u64 r = 0;
+            for (s32 i = 0; i < width; ++i)
+            {
+                r = (r << 1) | (v & 1);
+                v >>= 1;
+            }
+            return r;
+        }
+
+        // Generate the slicing tables for a <Width> bit CRC with polynomial <poly> in its normal (msb-first)
+        // notation. A reflected CRC shifts right and uses the bit-reversed polynomial, a normal CRC shifts
+        // left with the CRC register kept in the upper bits.
+        template <typename T, s32 Width, bool Reflected, s32 Slices> constexpr table_t<T, Slices> make_table(u64 poly)
+        {
+            table_t<T, Slices> t = {};
+            u64 const          top   = (u64)1 << (Width - 1);
+            u64 const          mask  = top | (top - 1);
+            u64 const          rpoly = reflect(poly, Width);
+            for (s32 n = 0; n < 256; ++n)
+            {
+                u64 c = Reflected ? (u64)n : ((u64)n << (Width - 8));
+                for (s32 k = 0; k < 8; ++k)
+                {
+                    if (Reflected)
+                        c = (c & 1) ? ((c >> 1) ^ rpoly) : (c >> 1);
+                    else
+                        c = (c & top) ? (((c << 1) ^ poly) & mask) : ((c << 1) & mask);
+                }
+                t.m[0][n] = (T)c;
+            }
+            for (s32 n = 0; n < 256; ++n)
+            {
+                u64 c = t.m[0][n];
+                for (s32 k = 1; k < Slices; ++k)
+                {
+                    if (Reflected)
+                        c = t.m[0][c & 0xff] ^ (c >> 8);
+                    else
+                        c = t.m[0][(c >> (Width - 8)) & 0xff] ^ ((c << 8) & mask);
+                    t.m[k][n] = (T)c;
+                }
+            }
+            return t;
+        }
+
+        inline u64 load_le64(u8 const* p)
+        {
+#ifdef D_LITTLE_ENDIAN
+            return *(u64 const*)p;
+#else
+            return (u64)p[0] | ((u64)p[1] << 8) | ((u64)p[2] << 16) | ((u64)p[3] << 24) | ((u64)p[4] << 32) | ((u64)p[5] << 40) | ((u64)p[6] << 48) | ((u64)p[7] << 56);
+#endif
+        }
+
+        inline u64 load_be64(u8 const* p) { return ((u64)p[0] << 56) | ((u64)p[1] << 48) | ((u64)p[2] << 40) | ((u64)p[3] << 32) | ((u64)p[4] << 24) | ((u64)p[5] << 16) | ((u64)p[6] << 8) | (u64)p[7]; }
+    } // namespace ncrc
+
+    /**
+     * @group		xhash
+     * @brief		Table driven CRC of any of the common widths (8, 16, 32 or 64 bits)
+
+     * 			The parameters follow the usual catalogue notation: <Poly> in normal (msb-first)
+     * 			notation, <Reflected> for CRCs that process the bits of a byte lsb-first (and
+     * 			reflect the result), <XorOut> is applied to the final value and <Init> is the
+     * 			initial register value. The tables are generated at compile time and the inner
+     * 			loop processes 8 bytes per step (slicing-by-8).
+     *
+     * 			checksum() keeps the running convention of crc_t, passing the result of a
+     * 			previous call as <inInitVal> continues the CRC over the next buffer.
+     */
+    template <s32 Width, u64 Poly, bool Reflected, u64 XorOut, u64 Init = XorOut> class crc_engine_t
+    {
+    public:
+        typedef typename ncrc::width_t<Width>::type value_t;
+        typedef ncrc::table_t<value_t, 8>              table_t;
+
+        static constexpr value_t INITIAL = (value_t)(Init ^ XorOut);  ///< The CRC of an empty buffer
+        static constexpr table_t sTable  = ncrc::make_table<value_t, Width, Reflected, 8>(Poly);
+
+        static value_t checksum(cbuffer_t const& buffer, value_t inInitVal = INITIAL)
+        {
+            ASSERT(buffer.m_begin);
+            return (value_t)(update((value_t)(inInitVal ^ (value_t)XorOut), (u8 const*)buffer.m_begin, buffer.size()) ^ (value_t)XorOut);
+        }
+
+        // Advance the raw CRC register <inCRC> over <inLength> bytes, without initial or final xor
+        static value_t update(value_t inCRC, u8 const* inData, u64 inLength)
+        {
+            u64 crc = inCRC;
+            while (inLength > 0 && ((uint_t)inData & 7) != 0)
+            {
+                crc = step(crc, *inData++);
+                inLength--;
+            }
+            while (inLength >= 8)
+            {
+                if (Reflected)
+                {
+                    u64 const x = ncrc::load_le64(inData) ^ crc;
+                    crc = (u64)sTable[7][x & 0xff] ^ sTable[6][(x >> 8) & 0xff] ^ sTable[5][(x >> 16) & 0xff] ^ sTable[4][(x >> 24) & 0xff] ^ sTable[3][(x >> 32) & 0xff] ^ sTable[2][(x >> 40) & 0xff] ^ sTable[1][(x >> 48) & 0xff] ^ sTable[0][x >> 56];
+                }
+                else
+                {
+                    u64 const x = ncrc::load_be64(inData) ^ (crc << (64 - Width));
+                    crc = (u64)sTable[7][x >> 56] ^ sTable[6][(x >> 48) & 0xff] ^ sTable[5][(x >> 40) & 0xff] ^ sTable[4][(x >> 32) & 0xff] ^ sTable[3][(x >> 24) & 0xff] ^ sTable[2][(x >> 16) & 0xff] ^ sTable[1][(x >> 8) & 0xff] ^ sTable[0][x & 0xff];
+                }
+                inData += 8;
+                inLength -= 8;
+            }
+            while (inLength > 0)
+            {
+                crc = step(crc, *inData++);
+                inLength--;
+            }
+            return (value_t)crc;
+        }
+
+    private:
+        static inline u64 step(u64 crc, u8 b)
+        {
+            if (Reflected)
+                return sTable[0][(crc ^ b) & 0xff] ^ (crc >> 8);
+            return (sTable[0][((crc >> (Width - 8)) ^ b) & 0xff] ^ (crc << 8)) & (u64)(value_t)~(value_t)0;
+        }
+    };
+
+    template <s32 Width, u64 Poly, bool Reflected, u64 XorOut, u64 Init> constexpr typename crc_engine_t<Width, Poly, Reflected, XorOut, Init>::value_t crc_engine_t<Width, Poly, Reflected, XorOut, Init>::INITIAL;
+    template <s32 Width, u64 Poly, bool Reflected, u64 XorOut, u64 Init> constexpr typename crc_engine_t<Width, Poly, Reflected, XorOut, Init>::table_t crc_engine_t<Width, Poly, Reflected, XorOut, Init>::sTable;
+
+    // Common CRCs, named after their entry in the CRC catalogue
+    typedef crc_engine_t<8, 0x07, false, 0x00>                                    crc8_smbus_t;       ///< check 0xF4
+    typedef crc_engine_t<16, 0x1021, false, 0x0000, 0xFFFF>                       crc16_ccitt_t;      ///< CRC-16/CCITT-FALSE, check 0x29B1
+    typedef crc_engine_t<16, 0x1021, true, 0x0000>                                crc16_kermit_t;     ///< check 0x2189
+    typedef crc_engine_t<16, 0x1021, false, 0x0000>                               crc16_xmodem_t;     ///< check 0x31C3
+    typedef crc_engine_t<16, 0x8005, true, 0x0000>                                crc16_arc_t;        ///< check 0xBB3D
+    typedef crc_engine_t<32, 0x04C11DB7, true, 0xFFFFFFFF>                        crc32_iso_hdlc_t;   ///< zlib/PNG CRC-32, check 0xCBF43926
+    typedef crc_engine_t<32, 0x04C11DB7, false, 0xFFFFFFFF>                       crc32_bzip2_t;      ///< check 0xFC891918
+    typedef crc_engine_t<32, 0x1EDC6F41, true, 0xFFFFFFFF>                        crc32_castagnoli_t; ///< check 0xE3069283
+    typedef crc_engine_t<64, 0x42F0E1EBA9EA3693ULL, true, 0xFFFFFFFFFFFFFFFFULL>  crc64_xz_t;         ///< check 0x995DC9BBDF1939FA
+    typedef crc_engine_t<64, 0x42F0E1EBA9EA3693ULL, false, 0x0000000000000000ULL> crc64_ecma_t;       ///< CRC-64/ECMA-182, check 0x6C40DF5F0B497347
+
+} // namespace ncore
+
+#endif
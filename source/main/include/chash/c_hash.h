@@ -10,6 +10,7 @@
 namespace ncore
 {
     class alloc_t;
+    class hash_jobs_t;
 
     namespace ehashtype
     {
@@ -26,20 +27,37 @@ namespace ncore
         typedef u32 value_t;
         enum
         {
-            MD5          = (1 << IndexShift) | (16 << SizeShift) | (sizeof(nhash_private::md5_t) << CtxSizeShift),
-            SHA1         = (2 << IndexShift) | (20 << SizeShift) | (sizeof(nhash_private::sha1_t) << CtxSizeShift),
-            Skein256     = (3 << IndexShift) | (32 << SizeShift) | (sizeof(nhash_private::skein256_t) << CtxSizeShift),
-            Skein512     = (4 << IndexShift) | (64 << SizeShift) | (sizeof(nhash_private::skein512_t) << CtxSizeShift),
-            Skein1024    = (5 << IndexShift) | (128 << SizeShift) | (sizeof(nhash_private::skein1024_t) << CtxSizeShift),
-            Murmur32     = (6 << IndexShift) | (4 << SizeShift) | (sizeof(nhash_private::murmur32_t) << CtxSizeShift),
-            Murmur64     = (7 << IndexShift) | (8 << SizeShift) | (sizeof(nhash_private::murmur64_t) << CtxSizeShift),
-            XXHash64     = (8 << IndexShift) | (8 << SizeShift) | (sizeof(nhash_private::xxhash64_t) << CtxSizeShift),
-            SpookyHashV2 = (9 << IndexShift) | (16 << SizeShift) | (sizeof(nhash_private::spookyhashv2_t) << CtxSizeShift),
+            MD5            = (1 << IndexShift) | (16 << SizeShift) | (sizeof(nhash_private::md5_t) << CtxSizeShift),
+            SHA1           = (2 << IndexShift) | (20 << SizeShift) | (sizeof(nhash_private::sha1_t) << CtxSizeShift),
+            Skein256       = (3 << IndexShift) | (32 << SizeShift) | (sizeof(nhash_private::skein256_t) << CtxSizeShift),
+            Skein512       = (4 << IndexShift) | (64 << SizeShift) | (sizeof(nhash_private::skein512_t) << CtxSizeShift),
+            Skein1024      = (5 << IndexShift) | (128 << SizeShift) | (sizeof(nhash_private::skein1024_t) << CtxSizeShift),
+            Murmur32       = (6 << IndexShift) | (4 << SizeShift) | (sizeof(nhash_private::murmur32_t) << CtxSizeShift),
+            Murmur64       = (7 << IndexShift) | (8 << SizeShift) | (sizeof(nhash_private::murmur64_t) << CtxSizeShift),
+            XXHash64       = (8 << IndexShift) | (8 << SizeShift) | (sizeof(nhash_private::xxhash64_t) << CtxSizeShift),
+            SpookyHashV2   = (9 << IndexShift) | (16 << SizeShift) | (sizeof(nhash_private::spookyhashv2_t) << CtxSizeShift),
+            CRC32          = (10 << IndexShift) | (4 << SizeShift) | (sizeof(nhash_private::crc32_t) << CtxSizeShift),
+            CRC32C         = (11 << IndexShift) | (4 << SizeShift) | (sizeof(nhash_private::crc32c_t) << CtxSizeShift),
+            Adler32        = (12 << IndexShift) | (4 << SizeShift) | (sizeof(nhash_private::adler32_t) << CtxSizeShift),
+            XXHash64Legacy = (13 << IndexShift) | (8 << SizeShift) | (sizeof(nhash_private::xxhash64_legacy_t) << CtxSizeShift),
+            XXH3_64        = (14 << IndexShift) | (8 << SizeShift) | (sizeof(nhash_private::xxh3_64_t) << CtxSizeShift),
+            XXH3_128       = (15 << IndexShift) | (16 << SizeShift) | (sizeof(nhash_private::xxh3_128_t) << CtxSizeShift),
+            XXHash32       = (16 << IndexShift) | (4 << SizeShift) | (sizeof(nhash_private::xxhash32_t) << CtxSizeShift),
+            Murmur3_32     = (17 << IndexShift) | (4 << SizeShift) | (sizeof(nhash_private::murmur3_32_t) << CtxSizeShift),
+            Murmur3_128    = (18 << IndexShift) | (16 << SizeShift) | (sizeof(nhash_private::murmur3_128_t) << CtxSizeShift),
+            SHA256         = (19 << IndexShift) | (32 << SizeShift) | (sizeof(nhash_private::sha256_t) << CtxSizeShift),
+            SHA512         = (20 << IndexShift) | (64 << SizeShift) | (sizeof(nhash_private::sha512_t) << CtxSizeShift),
+            BLAKE3         = (21 << IndexShift) | (32 << SizeShift) | (sizeof(nhash_private::blake3_t) << CtxSizeShift),
         };
 
         static inline s32 size(value_t type) { return (s32)((type & SizeMask) >> SizeShift); }
     }; // namespace ehashtype
 
+    // MurmurHash2 and MurmurHash64B, the state is seeded with <size> so these cannot be streamed,
+    // murmur32_t and murmur64_t use the incremental forms
+    u32 gGetMurmurHash32(const u8* data, u32 size, u32 seed);
+    u64 gGetMurmurHash64(const u8* data, u32 size, u64 seed);
+
     typedef void* hash_instance_t;
 
     hash_instance_t create_hash(alloc_t* allocator, ehashtype::value_t type);
@@ -49,6 +67,72 @@ namespace ncore
     void            hash_update(hash_instance_t ctxt, const u8* begin, const u8* end);
     void            hash_end(hash_instance_t ctxt, u8* hash, s32 size);
 
+    // Hash types that can split large inputs into independent pieces (BLAKE3) hand them to <jobs>
+    // in hash_update, other types ignore it. Pass nullptr to hash on the calling thread only.
+    void hash_set_jobs(hash_instance_t ctxt, hash_jobs_t* jobs);
+
+    namespace nhash
+    {
+        // One-shot hashing, no allocation and no context, the digests are identical to a single
+        // hash_begin / hash_update / hash_end sequence. Inputs that fit in one block are hashed
+        // directly from <data> without being copied into a context buffer.
+        md5            hash_md5(u8 const* data, u64 len);
+        sha1           hash_sha1(u8 const* data, u64 len);
+        sha256         hash_sha256(u8 const* data, u64 len);
+        sha512         hash_sha512(u8 const* data, u64 len);
+        skein256       hash_skein256(u8 const* data, u64 len);
+        skein512       hash_skein512(u8 const* data, u64 len);
+        skein1024      hash_skein1024(u8 const* data, u64 len);
+        murmur32       hash_murmur32(u8 const* data, u64 len, u32 seed = 0);
+        murmur64       hash_murmur64(u8 const* data, u64 len, u64 seed = 0);
+        murmur3_32     hash_murmur3_32(u8 const* data, u64 len, u32 seed = 0);
+        murmur3_128    hash_murmur3_128(u8 const* data, u64 len, u32 seed = 0);
+        xxhash32       hash_xxhash32(u8 const* data, u64 len, u32 seed = 0);
+        xxhash64       hash_xxhash64(u8 const* data, u64 len, u64 seed = 0);
+        xxhash64legacy hash_xxhash64legacy(u8 const* data, u64 len, u64 seed = 0);
+        xxh3_64        hash_xxh3_64(u8 const* data, u64 len, u64 seed = 0);
+        xxh3_128       hash_xxh3_128(u8 const* data, u64 len, u64 seed = 0);
+        spookyhashv2   hash_spookyhashv2(u8 const* data, u64 len, u64 seed1 = 0, u64 seed2 = 0);
+        crc32          hash_crc32(u8 const* data, u64 len);
+        crc32c         hash_crc32c(u8 const* data, u64 len);
+        adler32        hash_adler32(u8 const* data, u64 len);
+        blake3         hash_blake3(u8 const* data, u64 len, hash_jobs_t* jobs = nullptr);
+
+        // Skein tree hashing, the message is split into leaves of 2^leaf blocks that are hashed independently
+        // (as jobs with <jobs>) and combined by nodes of 2^fanout chaining values, the tree is at most <max_level>
+        // levels high. Requires leaf >= 1, fanout >= 1 and max_level >= 2, the digests differ from hash_skein*.
+        skein256  hash_skein256_tree(u8 const* data, u64 len, u32 leaf, u32 fanout, u32 max_level, hash_jobs_t* jobs = nullptr);
+        skein512  hash_skein512_tree(u8 const* data, u64 len, u32 leaf, u32 fanout, u32 max_level, hash_jobs_t* jobs = nullptr);
+        skein1024 hash_skein1024_tree(u8 const* data, u64 len, u32 leaf, u32 fanout, u32 max_level, hash_jobs_t* jobs = nullptr);
+
+        // Skein-MAC, skein*_mac_key runs the key and config blocks once, a message then starts from a copy of
+        // the returned key (hash_skein*_mac, or skein*_t::reset(key) when streaming). An empty key gives hash_skein*.
+        skein256_key  skein256_mac_key(u8 const* key, u64 len);
+        skein512_key  skein512_mac_key(u8 const* key, u64 len);
+        skein1024_key skein1024_mac_key(u8 const* key, u64 len);
+        skein256      hash_skein256_mac(skein256_key const& key, u8 const* data, u64 len);
+        skein512      hash_skein512_mac(skein512_key const& key, u8 const* data, u64 len);
+        skein1024     hash_skein1024_mac(skein1024_key const& key, u8 const* data, u64 len);
+
+        // Multi-buffer hashing of <count> independent messages, digests[i] is the hash of data[i][0, lens[i]).
+        // With AVX2 8 messages are hashed side by side, a message that is done frees its lane for the next one.
+        void hash_md5_multi(u8 const* const* data, u64 const* lens, md5* digests, u32 count);
+        void hash_sha1_multi(u8 const* const* data, u64 const* lens, sha1* digests, u32 count);
+
+        // One-shot by type, writes ehashtype::size(type) bytes to <hash>
+        void hash(ehashtype::value_t type, u8 const* data, u64 len, u8* hash);
+
+        // Batch hashing of fixed width integer keys, out[i] is the hash of the little-endian bytes of
+        // keys[i]. With AVX2 8 (32-bit hashes) or 4 (64-bit hashes) keys are computed per instruction.
+        void hash_murmur2_batch(u32 const* keys, u32* out, u64 n, u32 seed = 0);    // gGetMurmurHash32(key, 4, seed)
+        void hash_murmur2_batch(u64 const* keys, u32* out, u64 n, u32 seed = 0);    // gGetMurmurHash32(key, 8, seed)
+        void hash_murmur64b_batch(u64 const* keys, u64* out, u64 n, u64 seed = 0);  // gGetMurmurHash64(key, 8, seed)
+        void hash_xxhash64_batch(u32 const* keys, u64* out, u64 n, u64 seed = 0);   // hash_xxhash64(key, 4, seed)
+        void hash_xxhash64_batch(u64 const* keys, u64* out, u64 n, u64 seed = 0);   // hash_xxhash64(key, 8, seed)
+        void hash_fmix32_batch(u32 const* keys, u32* out, u64 n, u32 seed = 0);     // MurmurHash3 fmix32(key ^ seed)
+        void hash_fmix64_batch(u64 const* keys, u64* out, u64 n, u64 seed = 0);     // MurmurHash3 fmix64(key ^ seed)
+    } // namespace nhash
+
 } // namespace ncore
 
 #endif
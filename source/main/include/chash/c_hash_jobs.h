@@ -0,0 +1,37 @@
+#ifndef __CHASH_HASH_JOBS_H__
+#define __CHASH_HASH_JOBS_H__
+#include "ccore/c_target.h"
+#ifdef USE_PRAGMA_ONCE
+#    pragma once
+#endif
+
+namespace ncore
+{
+    /**
+     * @group		xhash
+     * @brief		Hook into a job system
+
+     * 			Checksum and hash functions that can split their work into independent
+     * 			pieces hand those pieces to this interface, so that the user decides how
+     * 			(and on which threads) they are executed.
+     */
+    class hash_jobs_t
+    {
+    public:
+        typedef void (*job_fn)(void* user, s32 index);
+
+        // Number of jobs that can run concurrently, used to decide how to split the work
+        inline s32 workers() const { return v_workers(); }
+
+        // Execute job(user, i) for every i in [0, count), in any order and possibly
+        // concurrently, and return when all of them have finished.
+        inline void run(job_fn job, void* user, s32 count) { v_run(job, user, count); }
+
+    protected:
+        virtual s32  v_workers() const                           = 0;
+        virtual void v_run(job_fn job, void* user, s32 count) = 0;
+    };
+
+} // namespace ncore
+
+#endif
@@ -0,0 +1,47 @@
+#ifndef __CHASH_HASH_CPU_H__
+#define __CHASH_HASH_CPU_H__
+#include "ccore/c_target.h"
+#ifdef USE_PRAGMA_ONCE
+#    pragma once
+#endif
+
+// Kernels using instruction set extensions are only compiled for x86-64, every
+// other target uses the portable code paths.
+#if defined(_M_X64) || defined(__x86_64__)
+#    define CHASH_X64 1
+#endif
+
+// GCC and Clang need the instruction set enabled per function to be able to use
+// the intrinsics without compiling the whole library for that instruction set.
+#if defined(CHASH_X64) && (!defined(_MSC_VER) || defined(__clang__))
+#    define CHASH_TARGET(features) __attribute__((target(features)))
+#else
+#    define CHASH_TARGET(features)
+#endif
+
+namespace ncore
+{
+    namespace nhash_cpu
+    {
+        enum EFeature
+        {
+            SSE2   = 0x01,
+            SSSE3  = 0x02,
+            SSE41  = 0x04,
+            SSE42  = 0x08,
+            PCLMUL = 0x10,
+            AVX2   = 0x20,
+            SHA    = 0x40,
+        };
+
+        // Detected once, on first use
+        u32 features();
+
+        // Mask out features, e.g. to force the portable code paths when testing
+        void disable(u32 features);
+
+        inline bool has(u32 feature) { return (features() & feature) == feature; }
+    } // namespace nhash_cpu
+} // namespace ncore
+
+#endif
@@ -0,0 +1,48 @@
+#ifndef __CHASH_HASH_LOAD_H__
+#define __CHASH_HASH_LOAD_H__
+#include "ccore/c_target.h"
+#ifdef USE_PRAGMA_ONCE
+#    pragma once
+#endif
+
+#include "cbase/c_memory.h"
+
+namespace ncore
+{
+    namespace nhash_private
+    {
+        // Little-endian loads of input that may start at any byte offset, a plain pointer cast
+        // would be a misaligned (undefined) load, the memcpy compiles to a single mov
+        static inline u32 load_le32(u8 const* p)
+        {
+#if defined(D_LITTLE_ENDIAN)
+            u32 v;
+#    if defined(__GNUC__) || defined(__clang__)
+            __builtin_memcpy(&v, p, sizeof(v));
+#    else
+            nmem::memcpy(&v, p, sizeof(v));
+#    endif
+            return v;
+#else
+            return (u32)p[0] | ((u32)p[1] << 8) | ((u32)p[2] << 16) | ((u32)p[3] << 24);
+#endif
+        }
+
+        static inline u64 load_le64(u8 const* p)
+        {
+#if defined(D_LITTLE_ENDIAN)
+            u64 v;
+#    if defined(__GNUC__) || defined(__clang__)
+            __builtin_memcpy(&v, p, sizeof(v));
+#    else
+            nmem::memcpy(&v, p, sizeof(v));
+#    endif
+            return v;
+#else
+            return (u64)load_le32(p) | ((u64)load_le32(p + 4) << 32);
+#endif
+        }
+    } // namespace nhash_private
+} // namespace ncore
+
+#endif
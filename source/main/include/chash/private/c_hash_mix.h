@@ -0,0 +1,99 @@
+#ifndef __CHASH_HASH_MIX_H__
+#define __CHASH_HASH_MIX_H__
+#include "ccore/c_target.h"
+#ifdef USE_PRAGMA_ONCE
+#    pragma once
+#endif
+
+namespace ncore
+{
+    namespace nhash_private
+    {
+        // Constants and mix steps shared by the streaming hashes and the integer key batch kernels
+        // (c_hash_batch.cpp), both must produce the same digests so they are defined only once here.
+
+        // MurmurHash2 / MurmurHash64B
+        static constexpr u32 MURMUR2_M = 0x5bd1e995;
+        static constexpr s32 MURMUR2_R = 24;
+
+        // Mix one 4 byte word into h
+        static inline u32 murmur2_mix(u32 h, u32 k)
+        {
+            k *= MURMUR2_M;
+            k ^= k >> MURMUR2_R;
+            k *= MURMUR2_M;
+            h *= MURMUR2_M;
+            return h ^ k;
+        }
+
+        static inline u32 murmur2_final(u32 h)
+        {
+            h ^= h >> 13;
+            h *= MURMUR2_M;
+            h ^= h >> 15;
+            return h;
+        }
+
+        // xxHash32 / xxHash64
+        static constexpr u64 XXH_PRIME64_1 = 11400714785074694791ULL;
+        static constexpr u64 XXH_PRIME64_2 = 14029467366897019727ULL;
+        static constexpr u64 XXH_PRIME64_3 = 1609587929392839161ULL;
+        static constexpr u64 XXH_PRIME64_4 = 9650029242287828579ULL;
+        static constexpr u64 XXH_PRIME64_5 = 2870177450012600261ULL;
+
+        static constexpr u32 XXH_PRIME32_1 = 0x9E3779B1U;
+        static constexpr u32 XXH_PRIME32_2 = 0x85EBCA77U;
+        static constexpr u32 XXH_PRIME32_3 = 0xC2B2AE3DU;
+        static constexpr u32 XXH_PRIME32_4 = 0x27D4EB2FU;
+        static constexpr u32 XXH_PRIME32_5 = 0x165667B1U;
+
+        static inline u64 xxh_rotl64(u64 x, s32 r) { return (x << r) | (x >> (64 - r)); }
+
+        // Mix one 8 byte lane into an accumulator
+        static inline u64 xxh64_round(u64 acc, u64 input)
+        {
+            acc += input * XXH_PRIME64_2;
+            acc = xxh_rotl64(acc, 31);
+            acc *= XXH_PRIME64_1;
+            return acc;
+        }
+
+        static inline u64 xxh64_avalanche(u64 h)
+        {
+            h ^= h >> 33;
+            h *= XXH_PRIME64_2;
+            h ^= h >> 29;
+            h *= XXH_PRIME64_3;
+            h ^= h >> 32;
+            return h;
+        }
+
+        // MurmurHash3 finalization mix
+        static constexpr u32 FMIX32_C1 = 0x85ebca6bU;
+        static constexpr u32 FMIX32_C2 = 0xc2b2ae35U;
+        static constexpr u64 FMIX64_C1 = 0xff51afd7ed558ccdULL;
+        static constexpr u64 FMIX64_C2 = 0xc4ceb9fe1a85ec53ULL;
+
+        static inline u32 fmix32(u32 h)
+        {
+            h ^= h >> 16;
+            h *= FMIX32_C1;
+            h ^= h >> 13;
+            h *= FMIX32_C2;
+            h ^= h >> 16;
+            return h;
+        }
+
+        static inline u64 fmix64(u64 k)
+        {
+            k ^= k >> 33;
+            k *= FMIX64_C1;
+            k ^= k >> 33;
+            k *= FMIX64_C2;
+            k ^= k >> 33;
+            return k;
+        }
+    } // namespace nhash_private
+} // namespace ncore
+
+#endif
@@ -0,0 +1,41 @@
+#ifndef __CHASH_HASH_MULTI_H__
+#define __CHASH_HASH_MULTI_H__
+#include "ccore/c_target.h"
+#ifdef USE_PRAGMA_ONCE
+#    pragma once
+#endif
+
+namespace ncore
+{
+    namespace nhash_private
+    {
+        // A Merkle-Damgard hash with 64 byte blocks (MD5, SHA-1) as seen by the multi-buffer engine
+        struct multi_algo_t
+        {
+            enum
+            {
+                LANES = 8,
+            };
+
+            typedef void (*blocks_fn)(u32* state, u8 const* blocks, uint_t nblocks);
+            typedef void (*lanes_fn)(u32 (*state)[LANES], u32 const (*words)[LANES]);
+            typedef void (*digest_fn)(u32 const* state, u8* digest);
+
+            u32 const* iv;          // Initial state
+            s32        state_words; // Words of state, at most 8
+            s32        digest_size; // Bytes written by digest
+            bool       length_be;   // The message length in bits is stored big-endian (SHA-1) or little-endian (MD5)
+            blocks_fn  blocks;      // Process whole blocks of a single message
+            lanes_fn   lanes;       // Process one block of LANES messages, or nullptr when not available
+            digest_fn  digest;
+        };
+
+        // Hash <count> independent messages, digest i (algo.digest_size bytes at <digests>) is the hash of
+        // data[i][0, lens[i]). State and message words are passed to <lanes> transposed, state[w][l] is word
+        // w of lane l and words[w][l] the (not byte swapped) w-th word of the block of lane l. A lane is
+        // refilled with the next message as soon as its message is done.
+        void multi_buffer_hash(multi_algo_t const& algo, u8 const* const* data, u64 const* lens, u8* digests, u32 count);
+    } // namespace nhash_private
+} // namespace ncore
+
+#endif
@@ -9,6 +9,8 @@
 
 namespace ncore
 {
+    class hash_jobs_t;
+
     namespace nhash
     {
         template <s32 N> struct digest_t
@@ -20,13 +22,35 @@ namespace ncore
 
         typedef digest_t<16>  md5;
         typedef digest_t<20>  sha1;
+        typedef digest_t<32>  sha256;
+        typedef digest_t<64>  sha512;
         typedef digest_t<32>  skein256;
         typedef digest_t<64>  skein512;
         typedef digest_t<128> skein1024;
         typedef digest_t<4>   murmur32;
         typedef digest_t<8>   murmur64;
+        typedef digest_t<4>   murmur3_32;
+        typedef digest_t<16>  murmur3_128;
         typedef digest_t<8>   xxhash64;
+        typedef digest_t<8>   xxhash64legacy;
+        typedef digest_t<4>   xxhash32;
+        typedef digest_t<8>   xxh3_64;
+        typedef digest_t<16>  xxh3_128;
         typedef digest_t<16>  spookyhashv2;
+        typedef digest_t<4>   crc32;
+        typedef digest_t<4>   crc32c;
+        typedef digest_t<4>   adler32;
+        typedef digest_t<32>  blake3;
+
+        // Skein-MAC key, the chaining values that follow the key and config blocks, see skein*_mac_key
+        template <s32 N> struct skein_key_t
+        {
+            u64 m_X[N / 64];
+        };
+
+        typedef skein_key_t<256>  skein256_key;
+        typedef skein_key_t<512>  skein512_key;
+        typedef skein_key_t<1024> skein1024_key;
     }; // namespace nhash
 
     namespace nhash_private
@@ -61,12 +85,40 @@ namespace ncore
             u64 m_ctxt[12];
         };
 
+        // SHA-256 and SHA-512 (FIPS 180-4), end() writes the state as big-endian words
+        struct sha256_t
+        {
+            hash_header_t hdr;
+
+            s32  size() const { return sizeof(nhash::sha256); }
+            void reset(u64 seed = 0);
+            void hash(u8 const* data, u8 const* end);
+            void end(u8* hash);
+
+            u64 m_computed;
+            u64 m_ctxt[13];
+        };
+
+        struct sha512_t
+        {
+            hash_header_t hdr;
+
+            s32  size() const { return sizeof(nhash::sha512); }
+            void reset(u64 seed = 0);
+            void hash(u8 const* data, u8 const* end);
+            void end(u8* hash);
+
+            u64 m_computed;
+            u64 m_ctxt[25];
+        };
+
         struct skein256_t
         {
             hash_header_t hdr;
 
             s32  size() const { return sizeof(nhash::skein256); }
             void reset(u64 seed = 0);
+            void reset(nhash::skein256_key const& key); // Skein-MAC, starts from a copy of <key>
             void hash(u8 const* data, u8 const* end);
             void end(u8* hash);
 
@@ -80,6 +132,7 @@ namespace ncore
 
             s32  size() const { return sizeof(nhash::skein512); }
             void reset(u64 seed = 0);
+            void reset(nhash::skein512_key const& key); // Skein-MAC, starts from a copy of <key>
             void hash(u8 const* data, u8 const* end);
             void end(u8* hash);
 
@@ -93,6 +146,7 @@ namespace ncore
 
             s32  size() const { return sizeof(nhash::skein1024); }
             void reset(u64 seed = 0);
+            void reset(nhash::skein1024_key const& key); // Skein-MAC, starts from a copy of <key>
             void hash(u8 const* data, u8 const* end);
             void end(u8* hash);
 
@@ -100,6 +154,9 @@ namespace ncore
             u64  m_ctxt[35];
         };
 
+        // MurmurHash2A (incremental MurmurHash2) and the matching incremental form of MurmurHash64B,
+        // partial words are buffered so the digest does not depend on how the input is split over
+        // hash() calls
         struct murmur32_t
         {
             hash_header_t hdr;
@@ -109,8 +166,8 @@ namespace ncore
             void hash(u8 const* data, u8 const* end);
             void end(u8* hash);
 
-            u32 m_seed;
-            u32 m_hash;
+            u64 m_seed;
+            u64 m_ctxt[3];
         };
 
         struct murmur64_t
@@ -123,9 +180,38 @@ namespace ncore
             void end(u8* hash);
 
             u64 m_seed;
-            u64 m_hash;
+            u64 m_ctxt[3];
+        };
+
+        // MurmurHash3 x86_32 and x64_128, partial blocks are buffered so the digest does not depend on
+        // how the input is split over hash() calls, end() writes the value(s) little-endian
+        struct murmur3_32_t
+        {
+            hash_header_t hdr;
+
+            s32  size() const { return sizeof(nhash::murmur3_32); }
+            void reset(u64 seed = 0);
+            void hash(u8 const* data, u8 const* end);
+            void end(u8* hash);
+
+            u64 m_seed;
+            u64 m_ctxt[3];
+        };
+
+        struct murmur3_128_t
+        {
+            hash_header_t hdr;
+
+            s32  size() const { return sizeof(nhash::murmur3_128); }
+            void reset(u64 seed = 0);
+            void hash(u8 const* data, u8 const* end);
+            void end(u8* hash);
+
+            u64 m_seed;
+            u64 m_ctxt[6];
         };
 
+        // XXH64 as specified by the reference implementation, end() writes the 64-bit value little-endian
         struct xxhash64_t
         {
             hash_header_t hdr;
@@ -139,6 +225,69 @@ namespace ncore
             u64 m_ctxt[11];
         };
 
+        // The XXH64 of earlier versions of this library, which reads the input big-endian and
+        // does not match the reference, only for digests that have to stay the same
+        struct xxhash64_legacy_t
+        {
+            hash_header_t hdr;
+
+            s32  size() const { return sizeof(nhash::xxhash64legacy); }
+            void reset(u64 seed = 0);
+            void hash(u8 const* data, u8 const* end);
+            void end(u8* hash);
+
+            u64 m_seed;
+            u64 m_ctxt[11];
+        };
+
+        // XXH32 as specified by the reference implementation, end() writes the 32-bit value little-endian
+        struct xxhash32_t
+        {
+            hash_header_t hdr;
+
+            s32  size() const { return sizeof(nhash::xxhash32); }
+            void reset(u64 seed = 0);
+            void hash(u8 const* data, u8 const* end);
+            void end(u8* hash);
+
+            static u32 hash32(const void* message, s64 length, u32 seed = 0);
+
+            u64 m_seed;
+            u64 m_ctxt[6];
+        };
+
+        // XXH3 (64 and 128-bit) as specified by the reference implementation, end() writes the
+        // 64-bit value little-endian, the 128-bit value as the low and then the high 64-bit half
+        struct xxh3_64_t
+        {
+            hash_header_t hdr;
+
+            s32  size() const { return sizeof(nhash::xxh3_64); }
+            void reset(u64 seed = 0);
+            void hash(u8 const* data, u8 const* end);
+            void end(u8* hash);
+
+            static u64 hash64(const void* message, s64 length, u64 seed = 0);
+
+            u64 m_seed;
+            u64 m_ctxt[67];
+        };
+
+        struct xxh3_128_t
+        {
+            hash_header_t hdr;
+
+            s32  size() const { return sizeof(nhash::xxh3_128); }
+            void reset(u64 seed = 0);
+            void hash(u8 const* data, u8 const* end);
+            void end(u8* hash);
+
+            static void hash128(const void* message, s64 length, u64 seed, u64* low, u64* high);
+
+            u64 m_seed;
+            u64 m_ctxt[67];
+        };
+
         struct spookyhashv2_t
         {
             hash_header_t hdr;
@@ -155,6 +304,61 @@ namespace ncore
             u64 m_seed;
             u64 m_ctxt[38];
         };
+
+        // BLAKE3 with a 32 byte digest, with m_jobs set the subtrees of large hash() calls are
+        // split over its workers, end() does not change the state
+        struct blake3_t
+        {
+            hash_header_t hdr;
+
+            s32  size() const { return sizeof(nhash::blake3); }
+            void reset(u64 seed = 0);
+            void hash(u8 const* data, u8 const* end);
+            void end(u8* hash);
+
+            hash_jobs_t* m_jobs = nullptr;
+            u64          m_ctxt[239];
+        };
+
+        // Checksums carry their running value between hash() calls, end() writes it big-endian
+        struct crc32_t
+        {
+            hash_header_t hdr;
+
+            s32  size() const { return sizeof(nhash::crc32); }
+            void reset(u64 seed = 0);
+            void hash(u8 const* data, u8 const* end);
+            void end(u8* hash);
+
+            u32 m_seed;
+            u32 m_crc;
+        };
+
+        struct crc32c_t
+        {
+            hash_header_t hdr;
+
+            s32  size() const { return sizeof(nhash::crc32c); }
+            void reset(u64 seed = 0);
+            void hash(u8 const* data, u8 const* end);
+            void end(u8* hash);
+
+            u32 m_seed;
+            u32 m_crc;
+        };
+
+        struct adler32_t
+        {
+            hash_header_t hdr;
+
+            s32  size() const { return sizeof(nhash::adler32); }
+            void reset(u64 seed = 1);
+            void hash(u8 const* data, u8 const* end);
+            void end(u8* hash);
+
+            u32 m_seed;
+            u32 m_adler;
+        };
     } // namespace nhash_private
 } // namespace ncore
 
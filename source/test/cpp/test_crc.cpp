@@ -1,10 +1,96 @@
 #include "ccore/c_target.h"
 #include "chash/c_crc.h"
+#include "chash/c_crc_engine.h"
+#include "chash/c_hash.h"
+#include "chash/c_hash_jobs.h"
+#include "chash/private/c_hash_cpu.h"
 
 #include "cunittest/cunittest.h"
 
 using namespace ncore;
 
+// The tables are generated by the compiler
+static_assert(crc32_iso_hdlc_t::sTable[0][1] == 0x77073096, "CRC-32 table");
+static_assert(crc16_xmodem_t::sTable[0][1] == 0x1021, "CRC-16/XMODEM table");
+
+// Bit-at-a-time reference for CRC-32 (IEEE 802.3, reflected polynomial 0xedb88320)
+static u32 crc32_reference(u8 const* data, s64 len, u32 crc)
+{
+    crc = ~crc;
+    for (s64 i = 0; i < len; ++i)
+    {
+        crc ^= data[i];
+        for (s32 k = 0; k < 8; ++k)
+            crc = (crc & 1) ? (0xedb88320 ^ (crc >> 1)) : (crc >> 1);
+    }
+    return ~crc;
+}
+
+// Bit-at-a-time reference for CRC-32C (Castagnoli, reflected polynomial 0x82f63b78)
+static u32 crc32c_reference(u8 const* data, s64 len, u32 crc)
+{
+    crc = ~crc;
+    for (s64 i = 0; i < len; ++i)
+    {
+        crc ^= data[i];
+        for (s32 k = 0; k < 8; ++k)
+            crc = (crc & 1) ? (0x82f63b78 ^ (crc >> 1)) : (crc >> 1);
+    }
+    return ~crc;
+}
+
+// Bitwise reference for CRC-64/XZ
+static u64 crc64_reference(u8 const* data, s64 len, u64 crc)
+{
+    crc = ~crc;
+    for (s64 i = 0; i < len; ++i)
+    {
+        crc ^= data[i];
+        for (s32 k = 0; k < 8; ++k)
+            crc = (crc & 1) ? ((crc >> 1) ^ 0xC96C5795D7870F42ULL) : (crc >> 1);
+    }
+    return ~crc;
+}
+
+// Byte-at-a-time reference for Adler-32
+static u32 adler32_reference(u8 const* data, s64 len, u32 adler)
+{
+    u32 a = adler & 0xFFFF;
+    u32 b = adler >> 16;
+    for (s64 i = 0; i < len; ++i)
+    {
+        a = (a + data[i]) % 65521;
+        b = (b + a) % 65521;
+    }
+    return a | (b << 16);
+}
+
+static u8 sLargeBuffer[3 * 8192 * 2 + 3 * 256 + 64];
+static u8 sHugeBuffer[1024 * 1024 + 4096 + 123];
+
+// Runs the jobs one after the other, in reverse order to make sure the result does not depend on it
+class test_jobs_t : public hash_jobs_t
+{
+public:
+    test_jobs_t(s32 workers)
+        : m_workers(workers)
+        , m_jobs(0)
+    {
+    }
+
+    s32 m_workers;
+    s32 m_jobs;
+
+protected:
+    virtual s32  v_workers() const { return m_workers; }
+    virtual void v_run(job_fn job, void* user, s32 count)
+    {
+        for (s32 i = count - 1; i >= 0; --i)
+            job(user, i);
+        m_jobs += count;
+    }
+};
+
 UNITTEST_SUITE_BEGIN(crc)
 {
     UNITTEST_FIXTURE(main)
@@ -22,6 +108,146 @@ UNITTEST_SUITE_BEGIN(crc)
             CHECK_EQUAL(crc_t::crc32(cbuffer_t(buffer, buffer + len), 0), crc_t::crc32(cbuffer_t(buffer, buffer + len)));
             CHECK_NOT_EQUAL(crc_t::crc32(cbuffer_t(buffer, buffer + len), 1321), crc_t::crc32(cbuffer_t(buff2, buff2 + len), 654321));
         }
+        UNITTEST_TEST(CRC_CRC32_CheckValue)
+        {
+            u8 const check[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+            CHECK_EQUAL((u32)0xCBF43926, crc_t::crc32(cbuffer_t(check, check + sizeof(check))));
+        }
+        UNITTEST_TEST(CRC_CRC32_Slicing)
+        {
+            u8 buffer[1024 + 16];
+            for (s32 i = 0; i < (s32)sizeof(buffer); ++i)
+                buffer[i] = (u8)((i * 7919) ^ (i >> 3));
+
+            // Every misalignment and a range of lengths, so head, sliced body and tail all get exercised
+            for (s32 offset = 0; offset < 16; ++offset)
+            {
+                for (s32 len = 0; len <= 1024; len += 13)
+                {
+                    u8 const* begin = buffer + offset;
+                    CHECK_EQUAL(crc32_reference(begin, len, 0x12345678), crc_t::crc32(cbuffer_t(begin, begin + len), 0x12345678));
+                }
+            }
+
+            // Running CRC over two pieces equals the CRC over the whole
+            u32 const whole = crc_t::crc32(cbuffer_t(buffer, buffer + 1000));
+            for (s32 split = 0; split <= 1000; split += 37)
+            {
+                u32 const head = crc_t::crc32(cbuffer_t(buffer, buffer + split));
+                CHECK_EQUAL(whole, crc_t::crc32(cbuffer_t(buffer + split, buffer + 1000), head));
+            }
+        }
+        UNITTEST_TEST(CRC_CRC32_Folding)
+        {
+            for (s32 i = 0; i < (s32)sizeof(sLargeBuffer); ++i)
+                sLargeBuffer[i] = (u8)((i * 13) ^ (i >> 7));
+
+            // Carry-less multiply folding (when available) must give the same CRC as the table path
+            s64 const lengths[] = {511, 512, 513, 527, 1024, 4096 + 48, 4096 + 63, (s64)sizeof(sLargeBuffer) - 5};
+            for (s32 l = 0; l < (s32)(sizeof(lengths) / sizeof(lengths[0])); ++l)
+            {
+                u8 const* begin    = sLargeBuffer + 5;
+                u32 const expected = crc32_reference(begin, lengths[l], 0x5a5a5a5a);
+                CHECK_EQUAL(expected, crc_t::crc32(cbuffer_t(begin, begin + lengths[l]), 0x5a5a5a5a));
+                nhash_cpu::disable(nhash_cpu::PCLMUL);
+                CHECK_EQUAL(expected, crc_t::crc32(cbuffer_t(begin, begin + lengths[l]), 0x5a5a5a5a));
+                nhash_cpu::disable(0);
+            }
+        }
+        UNITTEST_TEST(CRC_CRC32C)
+        {
+            u8 const check[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+            CHECK_EQUAL((u32)0xE3069283, crc_t::crc32c(cbuffer_t(check, check + sizeof(check))));
+
+            for (s32 i = 0; i < (s32)sizeof(sLargeBuffer); ++i)
+                sLargeBuffer[i] = (u8)((i * 31) ^ (i >> 5));
+
+            // Hardware path (when available) and the table driven fallback must agree with the reference
+            for (s32 pass = 0; pass < 2; ++pass)
+            {
+                nhash_cpu::disable(pass == 0 ? 0 : nhash_cpu::SSE42);
+
+                s64 const lengths[] = {0, 1, 7, 8, 9, 100, 3 * 256 - 1, 3 * 256, 3 * 256 + 17, 3 * 8192, 3 * 8192 + 3 * 256 + 5, (s64)sizeof(sLargeBuffer) - 3};
+                for (s32 l = 0; l < (s32)(sizeof(lengths) / sizeof(lengths[0])); ++l)
+                {
+                    u8 const* begin = sLargeBuffer + 3;
+                    CHECK_EQUAL(crc32c_reference(begin, lengths[l], 0xdeadbeef), crc_t::crc32c(cbuffer_t(begin, begin + lengths[l]), 0xdeadbeef));
+                }
+            }
+            nhash_cpu::disable(0);
+        }
+        UNITTEST_TEST(CRC_CRC64)
+        {
+            u8 const check[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+            CHECK_EQUAL((u64)0x995DC9BBDF1939FAULL, crc_t::crc64(cbuffer_t(check, check + sizeof(check))));
+
+            for (s32 i = 0; i < (s32)sizeof(sLargeBuffer); ++i)
+                sLargeBuffer[i] = (u8)((i * 97) ^ (i >> 5));
+
+            // Folding kernel and table path, over lengths and offsets around the block sizes
+            for (s32 pass = 0; pass < 2; ++pass)
+            {
+                nhash_cpu::disable(pass == 0 ? 0 : nhash_cpu::PCLMUL);
+                s64 const lengths[] = {0, 1, 15, 511, 512, 513, 527, 576, 1000, 4096 + 7, (s64)sizeof(sLargeBuffer) - 16};
+                for (s32 l = 0; l < (s32)(sizeof(lengths) / sizeof(lengths[0])); ++l)
+                {
+                    for (s32 offset = 0; offset < 16; offset += 5)
+                    {
+                        u8 const* begin = sLargeBuffer + offset;
+                        CHECK_EQUAL(crc64_reference(begin, lengths[l], 0), crc_t::crc64(cbuffer_t(begin, begin + lengths[l])));
+                    }
+                }
+                u8 const* begin = sLargeBuffer;
+                u8 const* mid   = sLargeBuffer + 3001;
+                u8 const* end   = sLargeBuffer + sizeof(sLargeBuffer);
+                CHECK_EQUAL(crc_t::crc64(cbuffer_t(begin, end)), crc_t::crc64(cbuffer_t(mid, end), crc_t::crc64(cbuffer_t(begin, mid))));
+            }
+            nhash_cpu::disable(0);
+        }
+        UNITTEST_TEST(CRC_Combine)
+        {
+            for (s32 i = 0; i < (s32)sizeof(sLargeBuffer); ++i)
+                sLargeBuffer[i] = (u8)((i * 97) ^ (i >> 2));
+
+            s64 const len = 3 * 8192 + 1001;
+            u8 const* all = sLargeBuffer;
+
+            u32 const crc32_whole   = crc_t::crc32(cbuffer_t(all, all + len));
+            u32 const crc32c_whole  = crc_t::crc32c(cbuffer_t(all, all + len));
+            u32 const adler32_whole = crc_t::adler32(cbuffer_t(all, all + len));
+            for (s64 split = 0; split <= len; split += 1237)
+            {
+                cbuffer_t const a(all, all + split);
+                cbuffer_t const b(all + split, all + len);
+                CHECK_EQUAL(crc32_whole, crc_t::crc32_combine(crc_t::crc32(a), crc_t::crc32(b), b.size()));
+                CHECK_EQUAL(crc32c_whole, crc_t::crc32c_combine(crc_t::crc32c(a), crc_t::crc32c(b), b.size()));
+                CHECK_EQUAL(adler32_whole, crc_t::adler32_combine(crc_t::adler32(a), crc_t::adler32(b), b.size()));
+            }
+
+            // Combining with an empty block is the identity
+            CHECK_EQUAL((u32)0x12345678, crc_t::crc32_combine(0x12345678, 0, 0));
+            CHECK_EQUAL((u32)0x12345678, crc_t::crc32c_combine(0x12345678, 0, 0));
+            CHECK_EQUAL(adler32_whole, crc_t::adler32_combine(adler32_whole, 1, 0));
+        }
+        UNITTEST_TEST(CRC_Parallel)
+        {
+            for (s32 i = 0; i < (s32)sizeof(sHugeBuffer); ++i)
+                sHugeBuffer[i] = (u8)((i * 101) ^ (i >> 11));
+
+            cbuffer_t const all(sHugeBuffer + 1, sHugeBuffer + sizeof(sHugeBuffer));
+
+            test_jobs_t jobs(4);
+            CHECK_EQUAL(crc_t::crc32(all, 0x1234), crc_t::crc32_parallel(all, &jobs, 0x1234));
+            CHECK_EQUAL(crc_t::crc32c(all, 0x1234), crc_t::crc32c_parallel(all, &jobs, 0x1234));
+            CHECK_EQUAL(crc_t::adler32(all, 0x1234), crc_t::adler32_parallel(all, &jobs, 0x1234));
+            CHECK_EQUAL(crc_t::adler32(all), crc_t::adler32_parallel(all, &jobs));
+            CHECK_TRUE(jobs.m_jobs > 4);
+
+            // Small buffers and no job system fall back to the sequential path
+            cbuffer_t const small(sHugeBuffer, sHugeBuffer + 1000);
+            CHECK_EQUAL(crc_t::crc32(small), crc_t::crc32_parallel(small, &jobs));
+            CHECK_EQUAL(crc_t::crc32(all), crc_t::crc32_parallel(all, nullptr));
+        }
         UNITTEST_TEST(CRC_Adler16)
         {
             u8  buffer[512] = {1, 2, 3, 4, 5, 6, 7, 8, 9};
@@ -44,6 +270,124 @@ UNITTEST_SUITE_BEGIN(crc)
             CHECK_NOT_EQUAL(crc_t::adler32(cbuffer_t(buffer, buffer + len), 110), crc_t::adler32(cbuffer_t(buffer, buffer + 50), 110));
             CHECK_EQUAL((u32)((112358 & 0xFFFF) | ((112358 >> 16) << 16)), crc_t::adler32(cbuffer_t(buffer, buffer), 112358));
         }
+        UNITTEST_TEST(CRC_Adler32_SIMD)
+        {
+            u8 const wikipedia[] = {'W', 'i', 'k', 'i', 'p', 'e', 'd', 'i', 'a'};
+            CHECK_EQUAL((u32)0x11E60398, crc_t::adler32(cbuffer_t(wikipedia, wikipedia + sizeof(wikipedia))));
+
+            // Worst case input for the sums, all bytes 0xFF
+            for (s32 i = 0; i < (s32)sizeof(sLargeBuffer); ++i)
+                sLargeBuffer[i] = (i < 16384) ? 0xFF : (u8)((i * 59) ^ (i >> 4));
+
+            u32 const disable[] = {0, nhash_cpu::AVX2, nhash_cpu::AVX2 | nhash_cpu::SSSE3};
+            for (s32 pass = 0; pass < 3; ++pass)
+            {
+                nhash_cpu::disable(disable[pass]);
+                s64 const lengths[] = {0, 63, 64, 65, 100, 5552, 5553, 16384, (s64)sizeof(sLargeBuffer) - 1};
+                for (s32 l = 0; l < (s32)(sizeof(lengths) / sizeof(lengths[0])); ++l)
+                {
+                    u8 const* begin = sLargeBuffer + 1;
+                    CHECK_EQUAL(adler32_reference(begin, lengths[l], 1), crc_t::adler32(cbuffer_t(begin, begin + lengths[l])));
+                    CHECK_EQUAL(adler32_reference(begin, lengths[l], 0xFFF0FFF0), crc_t::adler32(cbuffer_t(begin, begin + lengths[l]), 0xFFF0FFF0));
+                }
+            }
+            nhash_cpu::disable(0);
+        }
+        UNITTEST_TEST(CRC_Engine)
+        {
+            u8 const check[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+            cbuffer_t const c(check, check + sizeof(check));
+            CHECK_EQUAL((u8)0xF4, crc8_smbus_t::checksum(c));
+            CHECK_EQUAL((u16)0x29B1, crc16_ccitt_t::checksum(c));
+            CHECK_EQUAL((u16)0x2189, crc16_kermit_t::checksum(c));
+            CHECK_EQUAL((u16)0x31C3, crc16_xmodem_t::checksum(c));
+            CHECK_EQUAL((u16)0xBB3D, crc16_arc_t::checksum(c));
+            CHECK_EQUAL((u32)0xCBF43926, crc32_iso_hdlc_t::checksum(c));
+            CHECK_EQUAL((u32)0xFC891918, crc32_bzip2_t::checksum(c));
+            CHECK_EQUAL((u32)0xE3069283, crc32_castagnoli_t::checksum(c));
+            CHECK_EQUAL((u64)0x995DC9BBDF1939FAULL, crc64_xz_t::checksum(c));
+            CHECK_EQUAL((u64)0x6C40DF5F0B497347ULL, crc64_ecma_t::checksum(c));
+
+            // Matches the dedicated implementations and continues over split buffers
+            for (s32 i = 0; i < (s32)sizeof(sLargeBuffer); ++i)
+                sLargeBuffer[i] = (u8)((i * 29) ^ (i >> 7));
+            for (s32 split = 0; split < 40; split += 3)
+            {
+                u8 const* begin = sLargeBuffer + split;
+                u8 const* mid   = begin + 1000 + split;
+                u8 const* end   = sLargeBuffer + sizeof(sLargeBuffer);
+                CHECK_EQUAL(crc_t::crc32(cbuffer_t(begin, end)), crc32_iso_hdlc_t::checksum(cbuffer_t(begin, end)));
+                CHECK_EQUAL(crc_t::crc32c(cbuffer_t(begin, end)), crc32_castagnoli_t::checksum(cbuffer_t(begin, end)));
+                CHECK_EQUAL(crc16_ccitt_t::checksum(cbuffer_t(begin, end)), crc16_ccitt_t::checksum(cbuffer_t(mid, end), crc16_ccitt_t::checksum(cbuffer_t(begin, mid))));
+                CHECK_EQUAL(crc32_bzip2_t::checksum(cbuffer_t(begin, end)), crc32_bzip2_t::checksum(cbuffer_t(mid, end), crc32_bzip2_t::checksum(cbuffer_t(begin, mid))));
+                CHECK_EQUAL(crc64_ecma_t::checksum(cbuffer_t(begin, end)), crc64_ecma_t::checksum(cbuffer_t(mid, end), crc64_ecma_t::checksum(cbuffer_t(begin, mid))));
+            }
+        }
+        UNITTEST_TEST(CRC_Streaming)
+        {
+            for (s32 i = 0; i < (s32)sizeof(sLargeBuffer); ++i)
+                sLargeBuffer[i] = (u8)((i * 41) ^ (i >> 3));
+            u8 const* begin = sLargeBuffer;
+            u8 const* end   = sLargeBuffer + sizeof(sLargeBuffer);
+
+            nhash_private::crc32_t   crc32;
+            nhash_private::crc32c_t  crc32c;
+            nhash_private::adler32_t adler32;
+            crc32.hdr.type   = ehashtype::CRC32;
+            crc32c.hdr.type  = ehashtype::CRC32C;
+            adler32.hdr.type = ehashtype::Adler32;
+
+            hash_instance_t const contexts[] = {&crc32, &crc32c, &adler32};
+            u32 const             expected[] = {crc_t::crc32(cbuffer_t(begin, end)), crc_t::crc32c(cbuffer_t(begin, end)), crc_t::adler32(cbuffer_t(begin, end))};
+            for (s32 c = 0; c < 3; ++c)
+            {
+                CHECK_EQUAL(4, hash_size(contexts[c]));
+                hash_begin(contexts[c]);
+
+                // Feed the data in pieces of varying size
+                u8 const* p    = begin;
+                s32       step = 1;
+                while (p < end)
+                {
+                    u8 const* e = (end - p) < step ? end : p + step;
+                    hash_update(contexts[c], p, e);
+                    p    = e;
+                    step = step * 3 + 1;
+                }
+
+                u8 digest[4];
+                hash_end(contexts[c], digest, 4);
+                u32 const value = ((u32)digest[0] << 24) | ((u32)digest[1] << 16) | ((u32)digest[2] << 8) | (u32)digest[3];
+                CHECK_EQUAL(expected[c], value);
+            }
+        }
+
+        UNITTEST_TEST(CRC_Empty)
+        {
+            nhash_private::crc32_t   crc32;
+            nhash_private::crc32c_t  crc32c;
+            nhash_private::adler32_t adler32;
+            crc32.hdr.type   = ehashtype::CRC32;
+            crc32c.hdr.type  = ehashtype::CRC32C;
+            adler32.hdr.type = ehashtype::Adler32;
+
+            // An empty range, also as nullptr, leaves the initial value
+            hash_instance_t const    contexts[] = {&crc32, &crc32c, &adler32};
+            ehashtype::value_t const types[]    = {ehashtype::CRC32, ehashtype::CRC32C, ehashtype::Adler32};
+            u32 const                expected[] = {0, 0, 1};
+            for (s32 c = 0; c < 3; ++c)
+            {
+                u8 digest[4];
+                hash_begin(contexts[c]);
+                hash_update(contexts[c], nullptr, nullptr);
+                hash_update(contexts[c], sLargeBuffer, sLargeBuffer);
+                hash_end(contexts[c], digest, 4);
+                CHECK_EQUAL(expected[c], ((u32)digest[0] << 24) | ((u32)digest[1] << 16) | ((u32)digest[2] << 8) | (u32)digest[3]);
+
+                nhash::hash(types[c], nullptr, 0, digest);
+                CHECK_EQUAL(expected[c], ((u32)digest[0] << 24) | ((u32)digest[1] << 16) | ((u32)digest[2] << 8) | (u32)digest[3]);
+            }
+        }
     }
 }
 UNITTEST_SUITE_END
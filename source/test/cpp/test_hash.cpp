@@ -0,0 +1,101 @@
+#include "ccore/c_target.h"
+#include "chash/c_hash.h"
+#include "chash/private/c_internal_hash.h"
+
+#include "cunittest/cunittest.h"
+
+using namespace ncore;
+
+UNITTEST_SUITE_BEGIN(hash_oneshot)
+{
+	UNITTEST_FIXTURE(oneshot)
+	{
+		UNITTEST_FIXTURE_SETUP() {}
+		UNITTEST_FIXTURE_TEARDOWN() {}
+
+		static void fill(u8* data, s32 len)
+		{
+			for (s32 i = 0; i < len; ++i)
+				data[i] = (u8)(((u64)i * 2654435761ULL) >> 24);
+		}
+
+		// Digest of a single reset / hash / end sequence on a (zero initialized) context
+		template <typename T> static void stream(u8 const* data, u32 len, u8* digest)
+		{
+			T ctx = T();
+			ctx.reset();
+			ctx.hash(data, data + len);
+			ctx.end(digest);
+		}
+
+		template <typename T, typename D> static bool same(u8 const* data, u32 len, D const& oneshot, ehashtype::value_t type)
+		{
+			u8 streamed[128] = {0};
+			u8 bytype[128]   = {0};
+			stream<T>(data, len, streamed);
+			nhash::hash(type, data, len, bytype);
+			for (s32 i = 0; i < D::SIZE; ++i)
+			{
+				if (oneshot.m_data[i] != streamed[i] || oneshot.m_data[i] != bytype[i])
+					return false;
+			}
+			return ehashtype::size(type) == D::SIZE;
+		}
+
+		UNITTEST_TEST(matches_streaming)
+		{
+			u8 data[300];
+			fill(data, 300);
+
+			for (u32 len = 0; len <= 300; len += (len < 140) ? 1 : 7)
+			{
+				CHECK_TRUE((same<nhash_private::md5_t>(data, len, nhash::hash_md5(data, len), ehashtype::MD5)));
+				CHECK_TRUE((same<nhash_private::sha1_t>(data, len, nhash::hash_sha1(data, len), ehashtype::SHA1)));
+				CHECK_TRUE((same<nhash_private::sha256_t>(data, len, nhash::hash_sha256(data, len), ehashtype::SHA256)));
+				CHECK_TRUE((same<nhash_private::sha512_t>(data, len, nhash::hash_sha512(data, len), ehashtype::SHA512)));
+				CHECK_TRUE((same<nhash_private::skein256_t>(data, len, nhash::hash_skein256(data, len), ehashtype::Skein256)));
+				CHECK_TRUE((same<nhash_private::skein512_t>(data, len, nhash::hash_skein512(data, len), ehashtype::Skein512)));
+				CHECK_TRUE((same<nhash_private::skein1024_t>(data, len, nhash::hash_skein1024(data, len), ehashtype::Skein1024)));
+				CHECK_TRUE((same<nhash_private::murmur32_t>(data, len, nhash::hash_murmur32(data, len), ehashtype::Murmur32)));
+				CHECK_TRUE((same<nhash_private::murmur64_t>(data, len, nhash::hash_murmur64(data, len), ehashtype::Murmur64)));
+				CHECK_TRUE((same<nhash_private::murmur3_32_t>(data, len, nhash::hash_murmur3_32(data, len), ehashtype::Murmur3_32)));
+				CHECK_TRUE((same<nhash_private::murmur3_128_t>(data, len, nhash::hash_murmur3_128(data, len), ehashtype::Murmur3_128)));
+				CHECK_TRUE((same<nhash_private::xxhash32_t>(data, len, nhash::hash_xxhash32(data, len), ehashtype::XXHash32)));
+				CHECK_TRUE((same<nhash_private::xxhash64_t>(data, len, nhash::hash_xxhash64(data, len), ehashtype::XXHash64)));
+				CHECK_TRUE((same<nhash_private::xxhash64_legacy_t>(data, len, nhash::hash_xxhash64legacy(data, len), ehashtype::XXHash64Legacy)));
+				CHECK_TRUE((same<nhash_private::xxh3_64_t>(data, len, nhash::hash_xxh3_64(data, len), ehashtype::XXH3_64)));
+				CHECK_TRUE((same<nhash_private::xxh3_128_t>(data, len, nhash::hash_xxh3_128(data, len), ehashtype::XXH3_128)));
+				CHECK_TRUE((same<nhash_private::spookyhashv2_t>(data, len, nhash::hash_spookyhashv2(data, len), ehashtype::SpookyHashV2)));
+				CHECK_TRUE((same<nhash_private::crc32_t>(data, len, nhash::hash_crc32(data, len), ehashtype::CRC32)));
+				CHECK_TRUE((same<nhash_private::crc32c_t>(data, len, nhash::hash_crc32c(data, len), ehashtype::CRC32C)));
+				CHECK_TRUE((same<nhash_private::adler32_t>(data, len, nhash::hash_adler32(data, len), ehashtype::Adler32)));
+				CHECK_TRUE((same<nhash_private::blake3_t>(data, len, nhash::hash_blake3(data, len), ehashtype::BLAKE3)));
+			}
+		}
+
+		UNITTEST_TEST(seeds)
+		{
+			u8 data[100];
+			fill(data, 100);
+
+			nhash_private::xxhash64_t xxh64;
+			xxh64.reset(12345);
+			xxh64.hash(data, data + 100);
+			nhash::xxhash64 d64;
+			xxh64.end(d64.m_data);
+			nhash::xxhash64 const o64 = nhash::hash_xxhash64(data, 100, 12345);
+			for (s32 i = 0; i < 8; ++i)
+				CHECK_EQUAL(d64.m_data[i], o64.m_data[i]);
+
+			nhash_private::spookyhashv2_t spooky;
+			spooky.reset(1, 2);
+			spooky.hash(data, data + 100);
+			nhash::spookyhashv2 ds;
+			spooky.end(ds.m_data);
+			nhash::spookyhashv2 const os = nhash::hash_spookyhashv2(data, 100, 1, 2);
+			for (s32 i = 0; i < 16; ++i)
+				CHECK_EQUAL(ds.m_data[i], os.m_data[i]);
+		}
+	}
+}
+UNITTEST_SUITE_END
@@ -1,4 +1,5 @@
 #include "ccore/c_target.h"
+#include "ccore/c_endian.h"
 #include "cbase/c_buffer.h"
 #include "chash/c_hash.h"
 #include "chash/private/c_internal_hash.h"
@@ -37,6 +38,78 @@ UNITTEST_SUITE_BEGIN(murmur32_t)
 			CHECK_EQUAL(ruhash>0,true);
 			CHECK_EQUAL(ruhash,ruhash2);
 		}
+
+		static void fill(u8* data, s32 len)
+		{
+			for (s32 i = 0; i < len; ++i)
+				data[i] = (u8)(((u64)i * 2654435761ULL) >> 24);
+		}
+
+		static u32 murmur32(u8 const* data, u32 len, u32 seed)
+		{
+			nhash_private::murmur32_t ctx;
+			ctx.reset(seed);
+			ctx.hash(data, data + len);
+			nhash::murmur32 digest;
+			ctx.end(digest.m_data);
+			CHECK_EQUAL(nendian_ne::read_u32(nhash::hash_murmur32(data, len, seed).m_data), nendian_ne::read_u32(digest.m_data));
+			return nendian_ne::read_u32(digest.m_data);
+		}
+
+		// Values from the reference MurmurHash2A
+		UNITTEST_TEST(murmurhash2a)
+		{
+			u8 data[1000];
+			fill(data, 1000);
+
+			CHECK_EQUAL((u32)0x00000000, murmur32(data, 0, 0));
+			CHECK_EQUAL((u32)0xb2408361, murmur32(data, 1, 0));
+			CHECK_EQUAL((u32)0x3b46ec98, murmur32(data, 3, 0));
+			CHECK_EQUAL((u32)0x13761cf7, murmur32(data, 4, 0));
+			CHECK_EQUAL((u32)0xb19e1c05, murmur32(data, 5, 0));
+			CHECK_EQUAL((u32)0xb91e1fab, murmur32(data, 7, 0));
+			CHECK_EQUAL((u32)0x05565d0b, murmur32(data, 8, 0));
+			CHECK_EQUAL((u32)0xc1aa76e0, murmur32(data, 9, 0));
+			CHECK_EQUAL((u32)0xf53f712f, murmur32(data, 15, 0));
+			CHECK_EQUAL((u32)0xa3d72811, murmur32(data, 16, 0));
+			CHECK_EQUAL((u32)0xc319dd83, murmur32(data, 17, 0));
+			CHECK_EQUAL((u32)0x1712535c, murmur32(data, 100, 0));
+			CHECK_EQUAL((u32)0xc956807f, murmur32(data, 1000, 0));
+			CHECK_EQUAL((u32)0xf6206774, murmur32(data, 1000, 0x9747b28c));
+		}
+
+		UNITTEST_TEST(seed)
+		{
+			u8 data[100];
+			fill(data, 100);
+			CHECK_NOT_EQUAL(murmur32(data, 100, 0), murmur32(data, 100, 0x9747b28c));
+			CHECK_NOT_EQUAL(murmur32(data, 0, 0), murmur32(data, 0, 0x9747b28c));
+		}
+
+		UNITTEST_TEST(split_invariant)
+		{
+			u8 data[100];
+			fill(data, 100);
+
+			u32 const expected = murmur32(data, 100, 0x9747b28c);
+
+			// Every split point, with the second part fed in pieces of 1 to 13 bytes
+			for (u32 split = 0; split <= 100; ++split)
+			{
+				nhash_private::murmur32_t ctx;
+				ctx.reset(0x9747b28c);
+				ctx.hash(data, data + split);
+				u32 const step = 1 + (split % 13);
+				for (u32 i = split; i < 100; i += step)
+				{
+					u32 const end = (i + step) < 100 ? (i + step) : 100;
+					ctx.hash(data + i, data + end);
+				}
+				nhash::murmur32 digest;
+				ctx.end(digest.m_data);
+				CHECK_EQUAL(expected, nendian_ne::read_u32(digest.m_data));
+			}
+		}
 	}
 
 }
@@ -1,4 +1,5 @@
 #include "ccore/c_target.h"
+#include "ccore/c_endian.h"
 #include "cbase/c_buffer.h"
 #include "chash/c_hash.h"
 #include "chash/private/c_internal_hash.h"
@@ -39,6 +40,56 @@ UNITTEST_SUITE_BEGIN(murmur64_t)
 			CHECK_NOT_EQUAL(ruhash, ruhash2);
 		}
 
+		static void fill(u8* data, s32 len)
+		{
+			for (s32 i = 0; i < len; ++i)
+				data[i] = (u8)(((u64)i * 2654435761ULL) >> 24);
+		}
+
+		static u64 murmur64(u8 const* data, u32 len, u64 seed)
+		{
+			nhash_private::murmur64_t ctx;
+			ctx.reset(seed);
+			ctx.hash(data, data + len);
+			nhash::murmur64 digest;
+			ctx.end(digest.m_data);
+			CHECK_EQUAL(nendian_ne::read_u64(nhash::hash_murmur64(data, len, seed).m_data), nendian_ne::read_u64(digest.m_data));
+			return nendian_ne::read_u64(digest.m_data);
+		}
+
+		UNITTEST_TEST(seed)
+		{
+			u8 data[100];
+			fill(data, 100);
+			CHECK_NOT_EQUAL(murmur64(data, 100, 0), murmur64(data, 100, 0x9747b28c0badf00dULL));
+			CHECK_NOT_EQUAL(murmur64(data, 0, 0), murmur64(data, 0, 0x9747b28c0badf00dULL));
+		}
+
+		UNITTEST_TEST(split_invariant)
+		{
+			u8 data[100];
+			fill(data, 100);
+
+			u64 const expected = murmur64(data, 100, 0x9747b28c0badf00dULL);
+
+			// Every split point, with the second part fed in pieces of 1 to 13 bytes
+			for (u32 split = 0; split <= 100; ++split)
+			{
+				nhash_private::murmur64_t ctx;
+				ctx.reset(0x9747b28c0badf00dULL);
+				ctx.hash(data, data + split);
+				u32 const step = 1 + (split % 13);
+				for (u32 i = split; i < 100; i += step)
+				{
+					u32 const end = (i + step) < 100 ? (i + step) : 100;
+					ctx.hash(data + i, data + end);
+				}
+				nhash::murmur64 digest;
+				ctx.end(digest.m_data);
+				CHECK_EQUAL(expected, nendian_ne::read_u64(digest.m_data));
+			}
+		}
+
 	}
 }
 UNITTEST_SUITE_END
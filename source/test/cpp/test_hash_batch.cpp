@@ -0,0 +1,133 @@
+#include "ccore/c_target.h"
+#include "chash/c_hash.h"
+#include "chash/private/c_hash_cpu.h"
+
+#include "cunittest/cunittest.h"
+
+using namespace ncore;
+
+UNITTEST_SUITE_BEGIN(hash_batch)
+{
+	UNITTEST_FIXTURE(keys)
+	{
+		UNITTEST_FIXTURE_SETUP() {}
+		UNITTEST_FIXTURE_TEARDOWN() {}
+
+		static const u32 N = 77;
+
+		static void fill(u64* keys, u32* keys32, u32 n)
+		{
+			for (u32 i = 0; i < n; ++i)
+			{
+				keys[i]   = ((u64)i * 0x9E3779B97F4A7C15ULL) ^ ((u64)i << 61);
+				keys32[i] = (u32)(keys[i] >> 16);
+			}
+		}
+
+		static u64 read64(u8 const* p)
+		{
+			u64 v = 0;
+			for (s32 i = 7; i >= 0; --i)
+				v = (v << 8) | p[i];
+			return v;
+		}
+
+		static void le32(u8* p, u32 v)
+		{
+			for (s32 i = 0; i < 4; ++i)
+				p[i] = (u8)(v >> (8 * i));
+		}
+
+		static void le64(u8* p, u64 v)
+		{
+			for (s32 i = 0; i < 8; ++i)
+				p[i] = (u8)(v >> (8 * i));
+		}
+
+		static u32 fmix32(u32 h)
+		{
+			h ^= h >> 16;
+			h *= 0x85ebca6bU;
+			h ^= h >> 13;
+			h *= 0xc2b2ae35U;
+			h ^= h >> 16;
+			return h;
+		}
+
+		static u64 fmix64(u64 k)
+		{
+			k ^= k >> 33;
+			k *= 0xff51afd7ed558ccdULL;
+			k ^= k >> 33;
+			k *= 0xc4ceb9fe1a85ec53ULL;
+			k ^= k >> 33;
+			return k;
+		}
+
+		// Every batch size up to N, with and without AVX2, against the per key functions
+		UNITTEST_TEST(per_key)
+		{
+			u64 keys[N];
+			u32 keys32[N];
+			fill(keys, keys32, N);
+
+			u32 const seed32 = 0x9747b28c;
+			u64 const seed64 = 0x9747b28c0badf00dULL;
+
+			u32 out32[N];
+			u64 out64[N];
+			u8  bytes[8];
+			for (s32 pass = 0; pass < 2; ++pass)
+			{
+				nhash_cpu::disable(pass == 0 ? 0 : nhash_cpu::AVX2);
+				for (u32 n = 0; n <= N; n += (n < 20) ? 1 : 19)
+				{
+					nhash::hash_murmur2_batch(keys32, out32, n, seed32);
+					for (u32 i = 0; i < n; ++i)
+					{
+						le32(bytes, keys32[i]);
+						CHECK_EQUAL(gGetMurmurHash32(bytes, 4, seed32), out32[i]);
+					}
+
+					nhash::hash_murmur2_batch(keys, out32, n, seed32);
+					for (u32 i = 0; i < n; ++i)
+					{
+						le64(bytes, keys[i]);
+						CHECK_EQUAL(gGetMurmurHash32(bytes, 8, seed32), out32[i]);
+					}
+
+					nhash::hash_murmur64b_batch(keys, out64, n, seed64);
+					for (u32 i = 0; i < n; ++i)
+					{
+						le64(bytes, keys[i]);
+						CHECK_EQUAL(gGetMurmurHash64(bytes, 8, seed64), out64[i]);
+					}
+
+					nhash::hash_xxhash64_batch(keys32, out64, n, seed64);
+					for (u32 i = 0; i < n; ++i)
+					{
+						le32(bytes, keys32[i]);
+						CHECK_EQUAL(read64(nhash::hash_xxhash64(bytes, 4, seed64).m_data), out64[i]);
+					}
+
+					nhash::hash_xxhash64_batch(keys, out64, n, seed64);
+					for (u32 i = 0; i < n; ++i)
+					{
+						le64(bytes, keys[i]);
+						CHECK_EQUAL(read64(nhash::hash_xxhash64(bytes, 8, seed64).m_data), out64[i]);
+					}
+
+					nhash::hash_fmix32_batch(keys32, out32, n, seed32);
+					for (u32 i = 0; i < n; ++i)
+						CHECK_EQUAL(fmix32(keys32[i] ^ seed32), out32[i]);
+
+					nhash::hash_fmix64_batch(keys, out64, n, seed64);
+					for (u32 i = 0; i < n; ++i)
+						CHECK_EQUAL(fmix64(keys[i] ^ seed64), out64[i]);
+				}
+			}
+			nhash_cpu::disable(0);
+		}
+	}
+}
+UNITTEST_SUITE_END
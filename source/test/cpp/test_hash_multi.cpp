@@ -0,0 +1,69 @@
+#include "ccore/c_target.h"
+#include "chash/c_hash.h"
+#include "chash/private/c_hash_cpu.h"
+
+#include "cunittest/cunittest.h"
+
+using namespace ncore;
+
+UNITTEST_SUITE_BEGIN(hash_multi)
+{
+	UNITTEST_FIXTURE(messages)
+	{
+		UNITTEST_FIXTURE_SETUP() {}
+		UNITTEST_FIXTURE_TEARDOWN() {}
+
+		static const u32 N = 41;
+
+		static void fill(u8* data, s32 len)
+		{
+			for (s32 i = 0; i < len; ++i)
+				data[i] = (u8)(((u64)i * 2654435761ULL) >> 24);
+		}
+
+		static bool equal(u8 const* a, u8 const* b, s32 n)
+		{
+			for (s32 i = 0; i < n; ++i)
+				if (a[i] != b[i])
+					return false;
+			return true;
+		}
+
+		// Messages of different lengths (padding edge cases, empty and multi-block messages) finish
+		// in different passes, every digest must match the one-shot function
+		UNITTEST_TEST(one_shot)
+		{
+			static u8 data[8192];
+			fill(data, 8192);
+
+			u8 const* msgs[N];
+			u64       lens[N];
+			for (u32 i = 0; i < N; ++i)
+			{
+				static const u64 sizes[] = {0, 1, 55, 56, 63, 64, 65, 119, 120, 128, 200, 1000, 4000};
+				lens[i] = sizes[(i * 7) % 13] + (i / 13);
+				msgs[i] = data + (i * 37) % 2048;
+			}
+
+			nhash::md5  md5s[N];
+			nhash::sha1 sha1s[N];
+			u32 const disable[] = {0, nhash_cpu::SHA, nhash_cpu::AVX2, nhash_cpu::AVX2 | nhash_cpu::SHA | nhash_cpu::SSSE3};
+			for (s32 pass = 0; pass < 4; ++pass)
+			{
+				nhash_cpu::disable(disable[pass]);
+				for (u32 count = 0; count <= N; count += (count < 10) ? 1 : 7)
+				{
+					nhash::hash_md5_multi(msgs, lens, md5s, count);
+					nhash::hash_sha1_multi(msgs, lens, sha1s, count);
+					for (u32 i = 0; i < count; ++i)
+					{
+						CHECK_TRUE(equal(md5s[i].m_data, nhash::hash_md5(msgs[i], lens[i]).m_data, 16));
+						CHECK_TRUE(equal(sha1s[i].m_data, nhash::hash_sha1(msgs[i], lens[i]).m_data, 20));
+					}
+				}
+			}
+			nhash_cpu::disable(0);
+		}
+	}
+}
+UNITTEST_SUITE_END
@@ -7,6 +7,103 @@ using namespace ncore;
 
 UNITTEST_SUITE_BEGIN(md5_t)
 {
+	UNITTEST_FIXTURE(generator)
+	{
+		UNITTEST_FIXTURE_SETUP() {}
+		UNITTEST_FIXTURE_TEARDOWN() {}
 
+		struct vector_t
+		{
+			u32 len;
+			u8  digest[16];
+		};
+
+		static bool check(u8 const* digest, u8 const* expected)
+		{
+			for (s32 i = 0; i < 16; ++i)
+				if (digest[i] != expected[i])
+					return false;
+			return true;
+		}
+
+		// Values from the reference implementation, the lengths cover the padding edge cases
+		UNITTEST_TEST(reference)
+		{
+			u8 data[1000];
+			for (s32 i = 0; i < 1000; ++i)
+				data[i] = (u8)(((u64)i * 2654435761ULL) >> 24);
+
+			static const vector_t vectors[] = {
+				{0, {0xd4, 0x1d, 0x8c, 0xd9, 0x8f, 0x00, 0xb2, 0x04, 0xe9, 0x80, 0x09, 0x98, 0xec, 0xf8, 0x42, 0x7e}},
+				{1, {0x93, 0xb8, 0x85, 0xad, 0xfe, 0x0d, 0xa0, 0x89, 0xcd, 0xf6, 0x34, 0x90, 0x4f, 0xd5, 0x9f, 0x71}},
+				{55, {0x1e, 0xec, 0x39, 0xe4, 0x39, 0xa0, 0x68, 0x6e, 0x0f, 0x16, 0x14, 0x3c, 0x93, 0xe6, 0x55, 0x44}},
+				{56, {0x99, 0xd6, 0x9c, 0x39, 0xec, 0x90, 0xaf, 0x2f, 0xb1, 0x49, 0x6b, 0x6e, 0x9c, 0x6c, 0x76, 0x4d}},
+				{63, {0x6b, 0xb0, 0x48, 0xb0, 0x9b, 0xca, 0xdb, 0xcd, 0xfd, 0x18, 0x19, 0x77, 0x32, 0x3c, 0xdf, 0xd0}},
+				{64, {0xe2, 0xea, 0x14, 0xec, 0x96, 0xad, 0x97, 0x24, 0x98, 0x14, 0xfe, 0x4e, 0x07, 0xe0, 0x97, 0x82}},
+				{65, {0x6e, 0xef, 0xe2, 0xea, 0xf8, 0xf7, 0x6d, 0x19, 0xfb, 0x53, 0xcb, 0xf4, 0x52, 0xe5, 0xa3, 0x31}},
+				{119, {0x34, 0xec, 0x2d, 0xd3, 0xb6, 0xfc, 0xe7, 0xed, 0xb5, 0x6c, 0xd7, 0x66, 0x66, 0xf8, 0x19, 0xbf}},
+				{120, {0x06, 0x36, 0x5e, 0x9c, 0xd1, 0x31, 0xee, 0xc7, 0x36, 0xe2, 0x97, 0x27, 0xab, 0x06, 0x08, 0xdd}},
+				{1000, {0xd2, 0x17, 0x1e, 0xed, 0xe9, 0xdb, 0x55, 0xed, 0xab, 0xb7, 0x3b, 0x9e, 0x95, 0xe8, 0xc0, 0xbb}},
+			};
+
+			for (u32 v = 0; v < sizeof(vectors) / sizeof(vectors[0]); ++v)
+			{
+				u32 const len = vectors[v].len;
+
+				nhash_private::md5_t ctx;
+				ctx.reset();
+				ctx.hash(data, data + len);
+				nhash::md5 digest;
+				ctx.end(digest.m_data);
+				CHECK_TRUE(check(digest.m_data, vectors[v].digest));
+
+				// Streaming in pieces
+				ctx.reset();
+				for (u32 i = 0; i < len; i += 7)
+					ctx.hash(data + i, data + ((i + 7) < len ? (i + 7) : len));
+				ctx.end(digest.m_data);
+				CHECK_TRUE(check(digest.m_data, vectors[v].digest));
+
+				CHECK_TRUE(check(nhash::hash_md5(data, len).m_data, vectors[v].digest));
+			}
+		}
+
+		// Whole blocks are read straight from the input, which does not have to be 4 byte aligned
+		UNITTEST_TEST(unaligned)
+		{
+			static const u8 expected[] = {0xd2, 0x17, 0x1e, 0xed, 0xe9, 0xdb, 0x55, 0xed, 0xab, 0xb7, 0x3b, 0x9e, 0x95, 0xe8, 0xc0, 0xbb};
+
+			u8 buffer[1000 + 4];
+			for (s32 offset = 1; offset < 4; ++offset)
+			{
+				u8* data = buffer + offset;
+				for (s32 i = 0; i < 1000; ++i)
+					data[i] = (u8)(((u64)i * 2654435761ULL) >> 24);
+
+				nhash_private::md5_t ctx;
+				ctx.reset();
+				ctx.hash(data, data + 1000);
+				nhash::md5 digest;
+				ctx.end(digest.m_data);
+				CHECK_TRUE(check(digest.m_data, expected));
+
+				// A partial head block, then whole blocks at an odd offset
+				ctx.reset();
+				ctx.hash(data, data + 3);
+				ctx.hash(data + 3, data + 1000);
+				ctx.end(digest.m_data);
+				CHECK_TRUE(check(digest.m_data, expected));
+
+				CHECK_TRUE(check(nhash::hash_md5(data, 1000).m_data, expected));
+			}
+		}
+
+		UNITTEST_TEST(abc)
+		{
+			static const u8 expected[] = {0x90, 0x01, 0x50, 0x98, 0x3c, 0xd2, 0x4f, 0xb0, 0xd6, 0x96, 0x3f, 0x7d, 0x28, 0xe1, 0x7f, 0x72};
+			u8 const        abc[]      = {'a', 'b', 'c'};
+			CHECK_TRUE(check(nhash::hash_md5(abc, 3).m_data, expected));
+		}
+	}
 }
 UNITTEST_SUITE_END
\ No newline at end of file
@@ -0,0 +1,137 @@
+#include "ccore/c_target.h"
+#include "chash/c_hash.h"
+#include "chash/private/c_internal_hash.h"
+
+#include "cunittest/cunittest.h"
+
+using namespace ncore;
+
+UNITTEST_SUITE_BEGIN(murmur3_t)
+{
+	UNITTEST_FIXTURE(murmur3)
+	{
+		UNITTEST_FIXTURE_SETUP() {}
+		UNITTEST_FIXTURE_TEARDOWN() {}
+
+		static void fill(u8* data, s32 len)
+		{
+			for (s32 i = 0; i < len; ++i)
+				data[i] = (u8)(((u64)i * 2654435761ULL) >> 24);
+		}
+
+		static u32 read32(u8 const* p) { return (u32)p[0] | ((u32)p[1] << 8) | ((u32)p[2] << 16) | ((u32)p[3] << 24); }
+
+		static u32 murmur3_32(u8 const* data, u32 len, u32 seed)
+		{
+			nhash_private::murmur3_32_t ctx;
+			ctx.reset(seed);
+			ctx.hash(data, data + len);
+			nhash::murmur3_32 digest;
+			ctx.end(digest.m_data);
+			CHECK_EQUAL(read32(nhash::hash_murmur3_32(data, len, seed).m_data), read32(digest.m_data));
+			return read32(digest.m_data);
+		}
+
+		static bool equal(u8 const* a, u8 const* b, s32 n)
+		{
+			for (s32 i = 0; i < n; ++i)
+				if (a[i] != b[i])
+					return false;
+			return true;
+		}
+
+		// Values from the reference implementation, MurmurHash3.cpp of smhasher (also the mmh3 Python package)
+		UNITTEST_TEST(x86_32)
+		{
+			u8 data[1000];
+			fill(data, 1000);
+
+			CHECK_EQUAL((u32)0x00000000, murmur3_32(data, 0, 0));
+			CHECK_EQUAL((u32)0x514e28b7, murmur3_32(data, 1, 0));
+			CHECK_EQUAL((u32)0xf2ee35db, murmur3_32(data, 3, 0));
+			CHECK_EQUAL((u32)0xeb017c30, murmur3_32(data, 4, 0));
+			CHECK_EQUAL((u32)0xda6c4b20, murmur3_32(data, 5, 0));
+			CHECK_EQUAL((u32)0xa474464e, murmur3_32(data, 15, 0));
+			CHECK_EQUAL((u32)0x2038e935, murmur3_32(data, 16, 0));
+			CHECK_EQUAL((u32)0x563d4e2a, murmur3_32(data, 17, 0));
+			CHECK_EQUAL((u32)0x78dda169, murmur3_32(data, 31, 0));
+			CHECK_EQUAL((u32)0xc67bc176, murmur3_32(data, 32, 0));
+			CHECK_EQUAL((u32)0x9ac645bc, murmur3_32(data, 100, 0));
+			CHECK_EQUAL((u32)0xcb628773, murmur3_32(data, 1000, 0));
+			CHECK_EQUAL((u32)0xe7c81f09, murmur3_32(data, 1000, 0x9747b28c));
+		}
+
+		UNITTEST_TEST(x64_128)
+		{
+			u8 data[1000];
+			fill(data, 1000);
+
+			struct vector_t
+			{
+				u32 len;
+				u32 seed;
+				u8  digest[16];
+			};
+			static const vector_t vectors[] = {
+				{0, 0x00000000, {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},
+				{1, 0x00000000, {0xb5, 0x5c, 0xff, 0x6e, 0xe5, 0xab, 0x10, 0x46, 0x83, 0x35, 0xf8, 0x78, 0xaa, 0x2d, 0x62, 0x51}},
+				{3, 0x00000000, {0x52, 0x16, 0x43, 0xdf, 0xe2, 0x40, 0xed, 0xc5, 0x30, 0x8a, 0x7c, 0x0f, 0x6a, 0x23, 0x88, 0x49}},
+				{4, 0x00000000, {0x68, 0x9d, 0x1e, 0x0a, 0x19, 0x92, 0xec, 0xcd, 0x9a, 0x70, 0xda, 0x83, 0xa5, 0x9e, 0x78, 0x08}},
+				{5, 0x00000000, {0x0b, 0xd0, 0xc8, 0x12, 0x94, 0x6d, 0x45, 0xf0, 0xe9, 0xba, 0xbf, 0x36, 0x04, 0x20, 0x24, 0xb8}},
+				{15, 0x00000000, {0xec, 0x85, 0x36, 0x4d, 0x99, 0x48, 0xf6, 0x4b, 0x1d, 0x87, 0xab, 0x35, 0xab, 0x79, 0xfa, 0x52}},
+				{16, 0x00000000, {0x90, 0xb8, 0xcf, 0xb8, 0x60, 0x2a, 0x58, 0x07, 0xce, 0x5d, 0x12, 0xe1, 0x7c, 0xd2, 0x40, 0x42}},
+				{17, 0x00000000, {0x3d, 0xfb, 0xd3, 0x55, 0x99, 0x3f, 0x70, 0xa0, 0x17, 0x1d, 0x91, 0x58, 0x5d, 0xb5, 0x7f, 0x52}},
+				{31, 0x00000000, {0x45, 0xa6, 0x21, 0x46, 0x72, 0x7e, 0xdf, 0x3b, 0xca, 0xe7, 0xba, 0x5c, 0x55, 0x09, 0x88, 0xc7}},
+				{32, 0x00000000, {0xac, 0x8a, 0x3e, 0x2e, 0x78, 0x6d, 0xb7, 0x5d, 0xe3, 0x6a, 0xaf, 0x2d, 0x9b, 0x35, 0xc5, 0x03}},
+				{100, 0x00000000, {0x52, 0x99, 0xc0, 0x41, 0x9e, 0x62, 0x92, 0x5c, 0x3b, 0x85, 0x83, 0x00, 0x44, 0x47, 0xf9, 0xcf}},
+				{1000, 0x00000000, {0xef, 0xd3, 0xe1, 0x44, 0xa3, 0x02, 0x25, 0x29, 0x79, 0xc4, 0xf5, 0x86, 0x71, 0x56, 0x8a, 0x32}},
+				{1000, 0x9747b28c, {0x9e, 0x2a, 0xf8, 0xc5, 0xc1, 0x25, 0x44, 0x1d, 0x17, 0x63, 0xd8, 0xef, 0x1c, 0x08, 0xd5, 0xb4}},
+			};
+
+			for (u32 v = 0; v < sizeof(vectors) / sizeof(vectors[0]); ++v)
+			{
+				nhash_private::murmur3_128_t ctx;
+				ctx.reset(vectors[v].seed);
+				ctx.hash(data, data + vectors[v].len);
+				nhash::murmur3_128 digest;
+				ctx.end(digest.m_data);
+				CHECK_TRUE(equal(digest.m_data, vectors[v].digest, 16));
+				CHECK_TRUE(equal(nhash::hash_murmur3_128(data, vectors[v].len, vectors[v].seed).m_data, vectors[v].digest, 16));
+			}
+		}
+
+		UNITTEST_TEST(split_invariant)
+		{
+			u8 data[100];
+			fill(data, 100);
+
+			nhash::murmur3_32 const  expected32  = nhash::hash_murmur3_32(data, 100);
+			nhash::murmur3_128 const expected128 = nhash::hash_murmur3_128(data, 100);
+
+			// Every split point, with the second part fed in pieces of 1 to 19 bytes
+			for (u32 split = 0; split <= 100; ++split)
+			{
+				nhash_private::murmur3_32_t  ctx32;
+				nhash_private::murmur3_128_t ctx128;
+				ctx32.reset();
+				ctx128.reset();
+				ctx32.hash(data, data + split);
+				ctx128.hash(data, data + split);
+				u32 const step = 1 + (split % 19);
+				for (u32 i = split; i < 100; i += step)
+				{
+					u32 const end = (i + step) < 100 ? (i + step) : 100;
+					ctx32.hash(data + i, data + end);
+					ctx128.hash(data + i, data + end);
+				}
+				nhash::murmur3_32  d32;
+				nhash::murmur3_128 d128;
+				ctx32.end(d32.m_data);
+				ctx128.end(d128.m_data);
+				CHECK_TRUE(equal(d32.m_data, expected32.m_data, 4));
+				CHECK_TRUE(equal(d128.m_data, expected128.m_data, 16));
+			}
+		}
+	}
+}
+UNITTEST_SUITE_END
@@ -1,5 +1,6 @@
 #include "ccore/c_target.h"
 #include "chash/c_hash.h"
+#include "chash/private/c_hash_cpu.h"
 
 #include "cunittest/cunittest.h"
 
@@ -18,6 +19,75 @@ UNITTEST_SUITE_BEGIN(sha1_t)
 		UNITTEST_FIXTURE_SETUP() {}
 		UNITTEST_FIXTURE_TEARDOWN() {}
 
+		struct vector_t
+		{
+			u32 len;
+			u8  digest[20];
+		};
+
+		static bool check(u8 const* digest, u8 const* expected)
+		{
+			for (s32 i = 0; i < 20; ++i)
+				if (digest[i] != expected[i])
+					return false;
+			return true;
+		}
+
+		// Values from the reference implementation, the lengths cover the padding edge cases
+		UNITTEST_TEST(reference)
+		{
+			u8 data[1000];
+			for (s32 i = 0; i < 1000; ++i)
+				data[i] = (u8)(((u64)i * 2654435761ULL) >> 24);
+
+			static const vector_t vectors[] = {
+				{0, {0xda, 0x39, 0xa3, 0xee, 0x5e, 0x6b, 0x4b, 0x0d, 0x32, 0x55, 0xbf, 0xef, 0x95, 0x60, 0x18, 0x90, 0xaf, 0xd8, 0x07, 0x09}},
+				{1, {0x5b, 0xa9, 0x3c, 0x9d, 0xb0, 0xcf, 0xf9, 0x3f, 0x52, 0xb5, 0x21, 0xd7, 0x42, 0x0e, 0x43, 0xf6, 0xed, 0xa2, 0x78, 0x4f}},
+				{55, {0xe7, 0xe0, 0x36, 0xd4, 0x62, 0xc8, 0x40, 0xb6, 0xd8, 0xd0, 0x0a, 0x5a, 0x05, 0x62, 0x00, 0xc4, 0x8e, 0x92, 0xb3, 0x08}},
+				{56, {0xba, 0x20, 0xbe, 0xe3, 0x7b, 0xc3, 0x24, 0xbd, 0x95, 0x84, 0x9d, 0x90, 0x3b, 0xe9, 0x17, 0x3f, 0x49, 0xf8, 0x91, 0x5b}},
+				{63, {0xa9, 0x9c, 0x0a, 0x98, 0x4b, 0x1c, 0x48, 0x37, 0xd9, 0x17, 0x31, 0xc8, 0x77, 0x7b, 0x09, 0x1e, 0x85, 0xff, 0x10, 0x4d}},
+				{64, {0x2d, 0xc6, 0xbb, 0xd1, 0x96, 0x05, 0x38, 0xa7, 0x9c, 0x4f, 0x4e, 0x55, 0xd9, 0xe1, 0xc0, 0xaa, 0x91, 0xc5, 0xfa, 0x0d}},
+				{65, {0xa6, 0x7d, 0xc5, 0x45, 0xe2, 0xf6, 0xe8, 0xac, 0x56, 0x65, 0x19, 0xcf, 0xfe, 0xad, 0xf2, 0x90, 0x40, 0x64, 0xdb, 0x15}},
+				{119, {0x49, 0x78, 0xef, 0x27, 0x2e, 0x1d, 0xbb, 0x72, 0x2b, 0x4d, 0x16, 0x8d, 0xff, 0xf7, 0x6e, 0x44, 0x37, 0xf8, 0x34, 0xad}},
+				{120, {0xda, 0x12, 0x94, 0xe3, 0x23, 0xc8, 0xb3, 0xcd, 0x69, 0x7b, 0xe9, 0xb4, 0xcf, 0x42, 0xd0, 0x80, 0x47, 0xb2, 0x55, 0x9a}},
+				{1000, {0x07, 0xbe, 0xf5, 0x19, 0xeb, 0x3f, 0x0d, 0x63, 0xef, 0x6c, 0x99, 0x9d, 0x1c, 0x7f, 0x80, 0xc7, 0xc4, 0x04, 0x03, 0x2e}},
+			};
+
+			// With SHA-NI, the SSSE3 message schedule and the scalar block function
+			u32 const disable[] = {0, nhash_cpu::SHA, nhash_cpu::SHA | nhash_cpu::SSSE3};
+			for (u32 pass = 0; pass < 3; ++pass)
+			{
+				nhash_cpu::disable(disable[pass]);
+				for (u32 v = 0; v < sizeof(vectors) / sizeof(vectors[0]); ++v)
+				{
+					u32 const len = vectors[v].len;
+
+					nhash_private::sha1_t ctx;
+					ctx.reset();
+					ctx.hash(data, data + len);
+					nhash::sha1 digest;
+					ctx.end(digest.m_data);
+					CHECK_TRUE(check(digest.m_data, vectors[v].digest));
+
+					// Streaming in pieces
+					ctx.reset();
+					for (u32 i = 0; i < len; i += 7)
+						ctx.hash(data + i, data + ((i + 7) < len ? (i + 7) : len));
+					ctx.end(digest.m_data);
+					CHECK_TRUE(check(digest.m_data, vectors[v].digest));
+
+					CHECK_TRUE(check(nhash::hash_sha1(data, len).m_data, vectors[v].digest));
+				}
+			}
+			nhash_cpu::disable(0);
+		}
+
+		UNITTEST_TEST(abc)
+		{
+			static const u8 expected[] = {0xa9, 0x99, 0x3e, 0x36, 0x47, 0x06, 0x81, 0x6a, 0xba, 0x3e, 0x25, 0x71, 0x78, 0x50, 0xc2, 0x6c, 0x9c, 0xd0, 0xd8, 0x9d};
+			u8 const        abc[]      = {'a', 'b', 'c'};
+			CHECK_TRUE(check(nhash::hash_sha1(abc, 3).m_data, expected));
+		}
 	}
 }
 UNITTEST_SUITE_END
@@ -0,0 +1,148 @@
+#include "ccore/c_target.h"
+#include "chash/c_hash.h"
+#include "chash/private/c_hash_cpu.h"
+
+#include "cunittest/cunittest.h"
+
+using namespace ncore;
+
+UNITTEST_SUITE_BEGIN(sha2_t)
+{
+	UNITTEST_FIXTURE(generator)
+	{
+		UNITTEST_FIXTURE_SETUP() {}
+		UNITTEST_FIXTURE_TEARDOWN() {}
+
+		template <s32 N> struct vector_t
+		{
+			u32 len;
+			u8  digest[N];
+		};
+
+		static bool check(u8 const* digest, u8 const* expected, s32 size)
+		{
+			for (s32 i = 0; i < size; ++i)
+				if (digest[i] != expected[i])
+					return false;
+			return true;
+		}
+
+		static void fill(u8* data, u32 len)
+		{
+			for (u32 i = 0; i < len; ++i)
+				data[i] = (u8)(((u64)i * 2654435761ULL) >> 24);
+		}
+
+		// Values from the reference implementation, the lengths cover the padding edge cases
+		UNITTEST_TEST(sha256)
+		{
+			u8 data[1000];
+			fill(data, 1000);
+			u8 shifted[1001];
+			fill(shifted + 1, 1000);
+
+			static const vector_t<32> vectors[] = {
+				{0, {0xe3, 0xb0, 0xc4, 0x42, 0x98, 0xfc, 0x1c, 0x14, 0x9a, 0xfb, 0xf4, 0xc8, 0x99, 0x6f, 0xb9, 0x24, 0x27, 0xae, 0x41, 0xe4, 0x64, 0x9b, 0x93, 0x4c, 0xa4, 0x95, 0x99, 0x1b, 0x78, 0x52, 0xb8, 0x55}},
+				{1, {0x6e, 0x34, 0x0b, 0x9c, 0xff, 0xb3, 0x7a, 0x98, 0x9c, 0xa5, 0x44, 0xe6, 0xbb, 0x78, 0x0a, 0x2c, 0x78, 0x90, 0x1d, 0x3f, 0xb3, 0x37, 0x38, 0x76, 0x85, 0x11, 0xa3, 0x06, 0x17, 0xaf, 0xa0, 0x1d}},
+				{55, {0x87, 0xa2, 0x6d, 0xae, 0x81, 0xd3, 0x7e, 0x91, 0xb2, 0x5f, 0xae, 0x78, 0x99, 0x27, 0x4e, 0x68, 0x0a, 0x04, 0x8e, 0xa4, 0x4f, 0x82, 0xb1, 0x83, 0x97, 0xb6, 0x58, 0x5c, 0x26, 0x15, 0xc6, 0xb7}},
+				{56, {0xcd, 0x67, 0x56, 0xcd, 0xcd, 0x1c, 0xf7, 0x10, 0x57, 0xf2, 0x10, 0x63, 0x3c, 0x6d, 0x13, 0xfc, 0xe8, 0xac, 0x4b, 0x9f, 0x97, 0x69, 0x0b, 0x42, 0xc0, 0xaa, 0x28, 0xd7, 0x21, 0xe2, 0xad, 0xd5}},
+				{63, {0x7b, 0xe9, 0x10, 0xd5, 0x29, 0x43, 0x4d, 0xd8, 0xa3, 0x10, 0x78, 0xd2, 0x56, 0x67, 0x45, 0x7b, 0x60, 0x40, 0xc8, 0x88, 0xd6, 0x49, 0x04, 0xb2, 0x5d, 0x3c, 0xa9, 0x5f, 0x1e, 0xae, 0x6b, 0x16}},
+				{64, {0x51, 0xe9, 0x45, 0x46, 0x9a, 0x39, 0x48, 0xde, 0xbf, 0x6f, 0xc1, 0x54, 0xe9, 0x54, 0xfd, 0x66, 0x23, 0xeb, 0xbc, 0x21, 0xda, 0x2a, 0x3e, 0xe5, 0xe3, 0xee, 0x02, 0x64, 0xe2, 0xce, 0xf6, 0xf2}},
+				{65, {0x3c, 0x3e, 0x11, 0x3e, 0xc1, 0x6f, 0x54, 0x92, 0x4b, 0x2c, 0x56, 0x3c, 0x73, 0x04, 0xd9, 0xe1, 0x0e, 0xd4, 0xd9, 0xb5, 0x4f, 0x26, 0x6f, 0xec, 0xfb, 0xdc, 0x63, 0x97, 0x8a, 0x14, 0xc9, 0xb4}},
+				{119, {0xc9, 0x12, 0x8a, 0xdd, 0x91, 0xb5, 0x49, 0x27, 0x6c, 0x05, 0xfa, 0x00, 0x88, 0xf2, 0x46, 0x00, 0x73, 0x7e, 0x4a, 0x1e, 0xed, 0xf5, 0x05, 0xaf, 0xcc, 0x59, 0x77, 0xac, 0xbc, 0xe2, 0x0d, 0x17}},
+				{120, {0x05, 0xbb, 0x08, 0x26, 0x06, 0x8d, 0xa1, 0x52, 0xdd, 0xc6, 0x44, 0xac, 0xf1, 0xeb, 0xc9, 0x9e, 0xdf, 0x92, 0xea, 0xf9, 0xbc, 0x41, 0x70, 0x9d, 0x94, 0xd1, 0xf0, 0xa8, 0xa4, 0x56, 0x76, 0x4a}},
+				{128, {0x77, 0x5a, 0xd6, 0x9e, 0x0e, 0x16, 0x4f, 0x42, 0x8b, 0xec, 0x38, 0x44, 0x3d, 0x0b, 0x19, 0xb3, 0xce, 0xf0, 0x4a, 0x53, 0x04, 0x44, 0x6e, 0x1a, 0x5e, 0x80, 0x4e, 0x25, 0x6c, 0x93, 0xa6, 0x6a}},
+				{1000, {0x1f, 0xc5, 0xd2, 0x53, 0xaf, 0xbc, 0xfa, 0x51, 0x3e, 0x57, 0x83, 0x76, 0x42, 0x67, 0x55, 0x53, 0x98, 0x27, 0xde, 0x93, 0xeb, 0xb9, 0x39, 0x44, 0xa6, 0x96, 0x6d, 0xe0, 0x0d, 0xaa, 0x8c, 0x2b}},
+			};
+
+			// With SHA-NI, the AVX2 message schedule and the scalar block function
+			u32 const disable[] = {0, nhash_cpu::SHA, nhash_cpu::SHA | nhash_cpu::AVX2};
+			for (u32 pass = 0; pass < 3; ++pass)
+			{
+				nhash_cpu::disable(disable[pass]);
+				for (u32 v = 0; v < sizeof(vectors) / sizeof(vectors[0]); ++v)
+				{
+					u32 const len = vectors[v].len;
+
+					nhash_private::sha256_t ctx;
+					ctx.reset();
+					ctx.hash(data, data + len);
+					nhash::sha256 digest;
+					ctx.end(digest.m_data);
+					CHECK_TRUE(check(digest.m_data, vectors[v].digest, 32));
+
+					// Streaming in pieces
+					ctx.reset();
+					for (u32 i = 0; i < len; i += 7)
+						ctx.hash(data + i, data + ((i + 7) < len ? (i + 7) : len));
+					ctx.end(digest.m_data);
+					CHECK_TRUE(check(digest.m_data, vectors[v].digest, 32));
+
+					CHECK_TRUE(check(nhash::hash_sha256(data, len).m_data, vectors[v].digest, 32));
+
+					// Unaligned input
+					CHECK_TRUE(check(nhash::hash_sha256(shifted + 1, len).m_data, vectors[v].digest, 32));
+				}
+			}
+			nhash_cpu::disable(0);
+		}
+
+		UNITTEST_TEST(sha512)
+		{
+			u8 data[1000];
+			fill(data, 1000);
+
+			static const vector_t<64> vectors[] = {
+				{0, {0xcf, 0x83, 0xe1, 0x35, 0x7e, 0xef, 0xb8, 0xbd, 0xf1, 0x54, 0x28, 0x50, 0xd6, 0x6d, 0x80, 0x07, 0xd6, 0x20, 0xe4, 0x05, 0x0b, 0x57, 0x15, 0xdc, 0x83, 0xf4, 0xa9, 0x21, 0xd3, 0x6c, 0xe9, 0xce, 0x47, 0xd0, 0xd1, 0x3c, 0x5d, 0x85, 0xf2, 0xb0, 0xff, 0x83, 0x18, 0xd2, 0x87, 0x7e, 0xec, 0x2f, 0x63, 0xb9, 0x31, 0xbd, 0x47, 0x41, 0x7a, 0x81, 0xa5, 0x38, 0x32, 0x7a, 0xf9, 0x27, 0xda, 0x3e}},
+				{1, {0xb8, 0x24, 0x4d, 0x02, 0x89, 0x81, 0xd6, 0x93, 0xaf, 0x7b, 0x45, 0x6a, 0xf8, 0xef, 0xa4, 0xca, 0xd6, 0x3d, 0x28, 0x2e, 0x19, 0xff, 0x14, 0x94, 0x2c, 0x24, 0x6e, 0x50, 0xd9, 0x35, 0x1d, 0x22, 0x70, 0x4a, 0x80, 0x2a, 0x71, 0xc3, 0x58, 0x0b, 0x63, 0x70, 0xde, 0x4c, 0xeb, 0x29, 0x3c, 0x32, 0x4a, 0x84, 0x23, 0x34, 0x25, 0x57, 0xd4, 0xe5, 0xc3, 0x84, 0x38, 0xf0, 0xe3, 0x69, 0x10, 0xee}},
+				{111, {0xa9, 0xeb, 0x99, 0x6e, 0xf8, 0x6d, 0x40, 0x80, 0xf1, 0xe9, 0x41, 0xa0, 0xd7, 0xb0, 0x0d, 0x38, 0x4d, 0x0f, 0x9f, 0xcd, 0xd8, 0x42, 0xae, 0xae, 0xa8, 0x69, 0xc6, 0x2e, 0xed, 0x50, 0x73, 0x2d, 0xdd, 0xf3, 0xe2, 0xbd, 0x2c, 0xbd, 0x33, 0x24, 0x2b, 0x52, 0x28, 0x81, 0x4f, 0xbc, 0xf3, 0x3a, 0xb4, 0xd6, 0xdc, 0x73, 0x00, 0x65, 0x90, 0x09, 0x91, 0xf6, 0x35, 0x17, 0xad, 0x4b, 0xc9, 0x3a}},
+				{112, {0xe8, 0xf8, 0x1c, 0xc1, 0x7f, 0x93, 0x84, 0xee, 0x93, 0xf7, 0x5c, 0xda, 0x30, 0xa9, 0x84, 0xdf, 0x47, 0x3c, 0x1d, 0xd4, 0x82, 0xff, 0xca, 0x8e, 0xc3, 0xfe, 0x6e, 0x61, 0x3e, 0xbe, 0x15, 0x09, 0x8c, 0x4e, 0x77, 0x98, 0x99, 0xea, 0xe8, 0xe2, 0xfe, 0xe3, 0x5d, 0x4b, 0x76, 0xf0, 0x83, 0x36, 0xde, 0xef, 0x29, 0xb9, 0x99, 0xea, 0x20, 0x91, 0x8b, 0x16, 0x45, 0xd5, 0x58, 0xd7, 0x16, 0x35}},
+				{127, {0x02, 0xe3, 0xfd, 0xaa, 0x4e, 0xa0, 0xb6, 0x9d, 0x0c, 0xa7, 0xf6, 0x99, 0xb9, 0x5a, 0xdd, 0xad, 0xaa, 0xd0, 0xa5, 0x8d, 0xde, 0xcc, 0x95, 0x3e, 0x8e, 0x9e, 0x88, 0xb8, 0x18, 0x30, 0x11, 0xa0, 0xa9, 0x28, 0x9c, 0x56, 0x71, 0xe7, 0x9a, 0x25, 0x22, 0x65, 0x16, 0x4a, 0x8c, 0x01, 0x10, 0x2e, 0x21, 0x39, 0x49, 0xf2, 0x80, 0xd7, 0xe2, 0x47, 0x6c, 0x4c, 0x9a, 0x9e, 0x52, 0xee, 0xbf, 0x15}},
+				{128, {0x65, 0x88, 0x39, 0x42, 0x24, 0xcc, 0x9f, 0x31, 0x33, 0x3d, 0x03, 0x86, 0xb5, 0xf3, 0xd2, 0x4c, 0x26, 0x7c, 0x07, 0xbc, 0x4f, 0xb1, 0xbc, 0x36, 0xcc, 0x2c, 0x39, 0xe4, 0x6e, 0xc4, 0xa5, 0x49, 0xaa, 0x1d, 0xf3, 0xe7, 0xd8, 0x04, 0xde, 0x1b, 0x90, 0x81, 0x6d, 0x86, 0xde, 0x91, 0x5d, 0x8d, 0x10, 0x1d, 0xeb, 0xd6, 0x81, 0x08, 0x55, 0x5f, 0x0c, 0xfb, 0xe3, 0x01, 0xba, 0x33, 0x2a, 0x90}},
+				{129, {0x51, 0xa7, 0x59, 0x22, 0x43, 0xe8, 0x55, 0xec, 0x1e, 0x54, 0xcc, 0xe0, 0xa3, 0xc1, 0x1d, 0x2e, 0xba, 0x1d, 0xe0, 0x4e, 0xab, 0x01, 0xda, 0xc4, 0xc5, 0x71, 0x9c, 0x99, 0x02, 0x9a, 0xbf, 0x12, 0x99, 0x75, 0xda, 0x8b, 0x96, 0x22, 0x27, 0xbf, 0x6d, 0xd6, 0x86, 0xec, 0x02, 0x28, 0xc6, 0x3a, 0x6c, 0x95, 0x97, 0x6f, 0x75, 0xe6, 0x33, 0x32, 0x78, 0xb7, 0xef, 0x16, 0x33, 0x25, 0xc3, 0xbe}},
+				{239, {0xf4, 0x95, 0xb9, 0xdd, 0x88, 0x3d, 0xdd, 0x1b, 0x27, 0x52, 0xfb, 0x55, 0x28, 0x6d, 0x24, 0xb3, 0xf7, 0x59, 0xe4, 0xcb, 0x28, 0x65, 0xe0, 0xc6, 0x3e, 0xf7, 0x6b, 0x2b, 0x58, 0x7c, 0x9c, 0x9d, 0xe4, 0xa4, 0xa4, 0x3b, 0x48, 0xe1, 0x0a, 0x27, 0xdc, 0x3f, 0xc0, 0x65, 0x20, 0x9d, 0x4d, 0x7c, 0x62, 0xd8, 0x47, 0x32, 0xdd, 0x09, 0xa6, 0x3f, 0xf2, 0x14, 0x9b, 0xa4, 0x10, 0xec, 0xe6, 0xc0}},
+				{240, {0x84, 0x89, 0x5f, 0x27, 0xad, 0x37, 0x93, 0x12, 0x0d, 0x3e, 0x85, 0x71, 0x54, 0x48, 0x84, 0xe2, 0x06, 0x78, 0x78, 0xd6, 0x58, 0x8a, 0x7a, 0x19, 0x03, 0x32, 0x41, 0x26, 0x99, 0x17, 0x0d, 0xcc, 0x0a, 0xbc, 0x0d, 0x10, 0x1a, 0xb4, 0x77, 0x60, 0x34, 0xf5, 0x1a, 0x06, 0xe9, 0xa9, 0x10, 0x10, 0x9a, 0x67, 0x6f, 0x1c, 0x2d, 0xc8, 0x2a, 0xd9, 0x60, 0x25, 0xa7, 0x49, 0x76, 0x45, 0xe9, 0xd4}},
+				{256, {0xea, 0xbb, 0xbc, 0x76, 0x61, 0x48, 0xbc, 0xe4, 0x91, 0x72, 0x96, 0xd4, 0x48, 0xd1, 0x0a, 0xec, 0xe0, 0x25, 0x11, 0x86, 0xdb, 0xe1, 0xd5, 0x91, 0xc4, 0xd6, 0xd7, 0xab, 0xb7, 0xee, 0xdf, 0x8e, 0x98, 0xa0, 0x19, 0xb8, 0xb5, 0x11, 0x89, 0x55, 0xd4, 0x5a, 0x08, 0xf1, 0x31, 0x3a, 0x07, 0x50, 0xe2, 0xf7, 0x4e, 0x5c, 0x94, 0x57, 0x30, 0x63, 0x2f, 0x05, 0xcf, 0xa0, 0x98, 0x9b, 0x9b, 0xdf}},
+				{1000, {0x78, 0xa1, 0x7f, 0x8c, 0x11, 0x8f, 0x56, 0x86, 0x34, 0xaa, 0x26, 0x3c, 0x1c, 0x0b, 0x39, 0x6d, 0x79, 0x5d, 0x34, 0x17, 0xa1, 0x88, 0x51, 0x32, 0xd5, 0x59, 0x1b, 0x80, 0xa4, 0x71, 0x83, 0xcd, 0xd9, 0xee, 0x83, 0xe0, 0x78, 0x94, 0x23, 0xf4, 0xd8, 0xfe, 0xe6, 0x41, 0x12, 0xe7, 0xe5, 0xd2, 0xe0, 0x8d, 0x3b, 0x17, 0xc4, 0x52, 0x92, 0x02, 0x3b, 0x4f, 0xdb, 0x3a, 0xa5, 0xb5, 0x52, 0xc6}},
+			};
+
+			// With the AVX2 message schedule and the scalar block function
+			u32 const disable[] = {0, nhash_cpu::AVX2};
+			for (u32 pass = 0; pass < 2; ++pass)
+			{
+				nhash_cpu::disable(disable[pass]);
+				for (u32 v = 0; v < sizeof(vectors) / sizeof(vectors[0]); ++v)
+				{
+					u32 const len = vectors[v].len;
+
+					nhash_private::sha512_t ctx;
+					ctx.reset();
+					ctx.hash(data, data + len);
+					nhash::sha512 digest;
+					ctx.end(digest.m_data);
+					CHECK_TRUE(check(digest.m_data, vectors[v].digest, 64));
+
+					// Streaming in pieces
+					ctx.reset();
+					for (u32 i = 0; i < len; i += 13)
+						ctx.hash(data + i, data + ((i + 13) < len ? (i + 13) : len));
+					ctx.end(digest.m_data);
+					CHECK_TRUE(check(digest.m_data, vectors[v].digest, 64));
+
+					CHECK_TRUE(check(nhash::hash_sha512(data, len).m_data, vectors[v].digest, 64));
+				}
+			}
+			nhash_cpu::disable(0);
+		}
+
+		UNITTEST_TEST(abc)
+		{
+			static const u8 expected256[] = {0xba, 0x78, 0x16, 0xbf, 0x8f, 0x01, 0xcf, 0xea, 0x41, 0x41, 0x40, 0xde, 0x5d, 0xae, 0x22, 0x23, 0xb0, 0x03, 0x61, 0xa3, 0x96, 0x17, 0x7a, 0x9c, 0xb4, 0x10, 0xff, 0x61, 0xf2, 0x00, 0x15, 0xad};
+			static const u8 expected512[] = {0xdd, 0xaf, 0x35, 0xa1, 0x93, 0x61, 0x7a, 0xba, 0xcc, 0x41, 0x73, 0x49, 0xae, 0x20, 0x41, 0x31, 0x12, 0xe6, 0xfa, 0x4e, 0x89, 0xa9, 0x7e, 0xa2, 0x0a, 0x9e, 0xee, 0xe6, 0x4b, 0x55, 0xd3, 0x9a, 0x21, 0x92, 0x99, 0x2a, 0x27, 0x4f, 0xc1, 0xa8, 0x36, 0xba, 0x3c, 0x23, 0xa3, 0xfe, 0xeb, 0xbd, 0x45, 0x4d, 0x44, 0x23, 0x64, 0x3c, 0xe8, 0x0e, 0x2a, 0x9a, 0xc9, 0x4f, 0xa5, 0x4c, 0xa4, 0x9f};
+			u8 const        abc[]         = {'a', 'b', 'c'};
+			CHECK_TRUE(check(nhash::hash_sha256(abc, 3).m_data, expected256, 32));
+			CHECK_TRUE(check(nhash::hash_sha512(abc, 3).m_data, expected512, 64));
+		}
+	}
+}
+UNITTEST_SUITE_END
@@ -3,6 +3,8 @@
 #include "cbase/c_runes.h"
 
 #include "chash/c_hash.h"
+#include "chash/c_hash_jobs.h"
+#include "chash/private/c_hash_cpu.h"
 #include "chash/private/c_internal_hash.h"
 
 #include "cunittest/cunittest.h"
@@ -73,6 +75,74 @@ namespace SkeinTestVectors
     static Vector Tests_512_512[] = {
         {2048, "724627916C50338643E6996F07877EAFD96BDF01DA7E991D4155B9BE1295EA7D21C9391F4C4A41C75F77E5D27389253393725F1427F57914B273AB862B9E31DABCE506E558720520D33352D119F699E784F9E548FF91BC35CA147042128709820D69A8287EA3257857615EB0321270E94B84F446942765CE882B191FAEE7E1C87E0F0BD4E0CD8A927703524B559B769CA4ECE1F6DBF313FDCF67C572EC4185C1A88E86EC11B6454B371980020F19633B6B95BD280E4FBCB0161E1A82470320CEC6ECFA25AC73D09F1536F286D3F9DACAFB2CD1D0CE72D64D197F5C7520B3CCB2FD74EB72664BA93853EF41EABF52F015DD591500D018DD162815CC993595B195", "B2A35CF130E39CF82D85B5E4205934C0550293326354A0F9473890048F05AD76369E17E86D5D3F841C211312155F0B46266D8FB0FB515F044BCEB32FFEBA2871"}, {4064, "4FBDC596508D24A2A0010E140980B809FB9C6D55EC75125891DD985D37665BD80F9BEB6A50207588ABF3CEEE8C77CD8A5AD48A9E0AA074ED388738362496D2FB2C87543BB3349EA64997CE3E7B424EA92D122F57DBB0855A803058437FE08AFB0C8B5E7179B9044BBF4D81A7163B3139E30888B536B0F957EFF99A7162F4CA5AA756A4A982DFADBF31EF255083C4B5C6C1B99A107D7D3AFFFDB89147C2CC4C9A2643F478E5E2D393AEA37B4C7CB4B5E97DADCF16B6B50AAE0F3B549ECE47746DB6CE6F67DD4406CD4E75595D5103D13F9DFA79372924D328F8DD1FCBEB5A8E2E8BF4C76DE08E3FC46AA021F989C49329C7ACAC5A688556D7BCBCB2A5D4BE69D3284E9C40EC4838EE8592120CE20A0B635ECADAA84FD5690509F54F77E35A417C584648BC9839B974E07BFAB0038E90295D0B13902530A830D1C2BDD53F1F9C9FAED43CA4EED0A8DD761BC7EDBDDA28A287C60CD42AF5F9C758E5C7250231C09A582563689AFC65E2B79A7A2B68200667752E9101746F03184E2399E4ED8835CB8E9AE90E296AF220AE234259FE0BD0BCC60F7A4A5FF3F70C5ED4DE9C8C519A10E962F673C82C5E9351786A8A3BFD570031857BD4C87F4FCA31ED4D50E14F2107DA02CB5058700B74EA241A8B41D78461658F1B2B90BFD84A4C2C9D6543861AB3C56451757DCFB9BA60333488DBDD02D601B41AAE317CA7474EB6E6DD", "961A63783683371125E7D4FD6455E60678AFCD354CE2C0A4FB299DAFB3C4EC46F45F48A63FF8EC29D44B3B033C931122924D3C2C9683D5C576E2F0453653CEA7"}, {2552, "3139840B8AD4BCD39092916FD9D01798FF5AA1E48F34702C72DFE74B12E98A114E318CDD2D47A9C320FFF908A8DBC2A5B1D87267C8E983829861A567558B37B292D4575E200DE9F1DE45755FAFF9EFAE34964E4336C259F1E66599A7C904EC02539F1A8EAB8706E0B4F48F72FEC2794909EE4A7B092D6061C74481C9E21B9332DC7C6E482D7F9CC3210B38A6F88F7918C2D8C55E64A428CE2B68FD07AB572A8B0A2388664F99489F04EB54DF1376271810E0E7BCE396F52807710E0DEA94EB49F4B367271260C3456B9818FC7A72234E6BF2205FF6A36546205015EBD7D8C2527AA430F58E0E8AC97A7B6B793CD403D517D66295F37A34D0B7D2FA7BC345AC04CA1E266480DEEC39F5C88641C9DC0BD1358158FDECDD96685BBBB5C1FE5EA89D2CB4A9D5D12BB8C893281FF38E87D6B4841F0650092D447E013F20EA934E18", "DC0CDEDBA4F46C081F84E8DB765CF6DA2570A0D5C638ABB74774FC6F8C9A2708F0AB027B0CAAEF047A2FEB08DB43DBA5D802F5541D58956F998013AC4E5C5897"}, {0, nullptr, nullptr}};
 
+    // Tree hashing, message bytes (u8)((i * 2654435761) >> 24), values from an independent implementation of the specification
+    struct TreeVector
+    {
+        u32 Size;
+        u32 Len;
+        u32 Leaf;
+        u32 Fanout;
+        u32 MaxLevel;
+        char const *Digest;
+    };
+
+    static TreeVector TreeTests[] = {
+        {256, 0, 1, 1, 2, "4C2521B1D3CE21B8EA87E126044C1DEF8B01772E4E3838F7B191B66664AA190C"},
+        {256, 1000, 1, 1, 2, "533095165F0AA534AF8F07BA24EA8F7F3827CBD7782669BF234FFF0B95D967B5"},
+        {512, 1000, 1, 1, 3, "4E32230D8769DE1AC79B04757512FF4FF7DD2DA409BCE6BC035A82D6EA3C19DA09552493FA380FECD699D40D185D92E83959F002DBCBD006E5E5488639483C4C"},
+        {512, 3001, 2, 1, 255, "57B7B455A7E7800327989EC6BDAB5B7FAB4A2F7345DF698D68AECF8B5084D363E11BA8AF266196EDE25F5F493390877B76119089EF9EC7501EA30301CB186ED7"},
+        {1024, 5000, 1, 2, 2, "229F05E5728FF8595D946E8E4D9C89D65F65DD8AE732E2B0FCE07DEFFB3BCB86"},
+        {512, (1 << 20) + 12345, 5, 2, 3, "A888D669F2B565E7AA40B2BAEA30E1F372D082E0BA85841A420FA02D14FC36784C165F81CAE7B85D01EB57CEB74CD0FE2BDBA8FE53A8FD66F52447B7E96BA512"},
+        {0, 0, 0, 0, 0, nullptr}};
+
+    static u8 TreeMsg[(1 << 20) + 12345];
+
+    // Skein-MAC, key[i] = i * 7 + 1 and msg[i] = 255 - i
+    struct MacVector
+    {
+        u32 Size;
+        u32 KeyLen;
+        u32 Len;
+        char const *Digest;
+    };
+
+    static MacVector MacTests[] = {
+        {256, 32, 0, "76952CD55189A3A4ED6667589CEAA6B2022203471832D92C582A051BF1D0C80E"},
+        {256, 32, 200, "43594FB7495A12D799008C973DCBFE192D7E57F0038E1AC5949846DFA2BA9CF4"},
+        {256, 135, 3, "7F75D92AAA8716CB02EE6B5F148771361CA1F42655BE448A02C4E3D594D27BFD"},
+        {256, 135, 1000, "880120BFC0D63ACADCD905E4FFB1285FA62F8468361AB18E661D2905603579D1"},
+        {512, 32, 0, "82F9E70278640AFA0662B6439D04ECA077167DFB69E15543AF3AC54C6FD5FBB4E295E1081A7A0B3D9E1B11514F2026D01620190C5ED2D8089D3D0925775B8C74"},
+        {512, 32, 200, "19D55B9C2C05593000A482FA541A07CC2172C09759DBB50B4F8F9512BE71409EA7C6B52144413FB5E234EEA481B1C2E12B09E6205D3BF2E19D9C2BB02EDE94E4"},
+        {512, 135, 3, "64CB4A63BD4A7B98B584E5E80EF8EEB39D0313CCF63A9941B972AC48B0B74F05AD615F435CDBBADE4A25C0F55A26D730C1CF1D251E015A3591144164C631EE64"},
+        {512, 135, 1000, "0E8CE0090AB53266293283FB573EEF087493EC72D7A5AE32786CDBDBFF70BE0A9F80C566994A7A325199DB37AF34F0F9F32D3D276A406D4C87A74DA1ECBF1FE1"},
+        {1024, 32, 0, "B40032C0DE8347BAC55CD020F24405E5A1DCC9939A831A7BB08E2CA3D99954B8"},
+        {1024, 32, 200, "87CC8529D0648C75251BD8EB68C8C227361D5E2A2558D02D7544EB0541A7EEA8"},
+        {1024, 135, 3, "C99BD7522895DC7D821ECB23D6B222149C26700C9B9D1A62524612F5715FF579"},
+        {1024, 135, 1000, "681028EF6CA58E9532FE218BE6090BB0861B34566956C6F46EE16BD19A4884F9"},
+        {0, 0, 0, nullptr}};
+
+    // Runs the jobs one after the other, in reverse order to make sure the result does not depend on it
+    class TreeJobs : public hash_jobs_t
+    {
+    public:
+        TreeJobs(s32 workers)
+            : m_workers(workers)
+            , m_jobs(0)
+        {
+        }
+
+        s32 m_workers;
+        s32 m_jobs;
+
+    protected:
+        virtual s32  v_workers() const { return m_workers; }
+        virtual void v_run(job_fn job, void *user, s32 count)
+        {
+            for (s32 i = count - 1; i >= 0; --i)
+                job(user, i);
+            m_jobs += count;
+        }
+    };
 }; // namespace SkeinTestVectors
 
 UNITTEST_SUITE_BEGIN(skein)
@@ -144,5 +214,131 @@ UNITTEST_SUITE_BEGIN(skein)
             }
         }
     }
+
+    UNITTEST_FIXTURE(tree)
+    {
+        UNITTEST_FIXTURE_SETUP() {}
+        UNITTEST_FIXTURE_TEARDOWN() {}
+
+        static nhash::skein1024 TreeHash(SkeinTestVectors::TreeVector const *test, hash_jobs_t *jobs)
+        {
+            u8 const *msg = SkeinTestVectors::TreeMsg;
+            nhash::skein1024 digest = {};
+            switch (test->Size)
+            {
+                case 256: nmem::memcpy(digest.m_data, nhash::hash_skein256_tree(msg, test->Len, test->Leaf, test->Fanout, test->MaxLevel, jobs).m_data, 32); break;
+                case 512: nmem::memcpy(digest.m_data, nhash::hash_skein512_tree(msg, test->Len, test->Leaf, test->Fanout, test->MaxLevel, jobs).m_data, 64); break;
+                case 1024: digest = nhash::hash_skein1024_tree(msg, test->Len, test->Leaf, test->Fanout, test->MaxLevel, jobs); break;
+            }
+            return digest;
+        }
+
+        UNITTEST_TEST(vectors)
+        {
+            for (u32 i = 0; i < sizeof(SkeinTestVectors::TreeMsg); ++i)
+                SkeinTestVectors::TreeMsg[i] = (u8)(((u64)i * 2654435761ULL) >> 24);
+
+            u8 expected[64];
+            SkeinTestVectors::TreeJobs jobs(4);
+
+            // With the AVX2 kernels that hash 4 leaves at once and with the portable code
+            for (u32 pass = 0; pass < 2; ++pass)
+            {
+                nhash_cpu::disable(pass == 0 ? 0 : nhash_cpu::AVX2);
+                for (SkeinTestVectors::TreeVector const *test = SkeinTestVectors::TreeTests; test->Digest != nullptr; ++test)
+                {
+                    s32 const len = SkeinTestVectors::TextMsgToByteMsg(test->Digest, test->Size == 512 ? 64 : 32, expected);
+
+                    nhash::skein1024 digest = TreeHash(test, nullptr);
+                    CHECK_TRUE(nmem::memcmp(expected, digest.m_data, len) == 0);
+
+                    digest = TreeHash(test, &jobs);
+                    CHECK_TRUE(nmem::memcmp(expected, digest.m_data, len) == 0);
+                }
+            }
+            nhash_cpu::disable(0);
+
+            // Only the last vector is large enough to be split into jobs
+            CHECK_TRUE(jobs.m_jobs > 0);
+        }
+
+        UNITTEST_TEST(sequential_differs)
+        {
+            u8 const msg[] = {0xFF};
+            nhash::skein256 const tree = nhash::hash_skein256_tree(msg, 1, 1, 1, 2);
+            nhash::skein256 const seq  = nhash::hash_skein256(msg, 1);
+            CHECK_TRUE(nmem::memcmp(tree.m_data, seq.m_data, 32) != 0);
+        }
+    }
+
+    UNITTEST_FIXTURE(mac)
+    {
+        UNITTEST_FIXTURE_SETUP() {}
+        UNITTEST_FIXTURE_TEARDOWN() {}
+
+        // One-shot with the key, and streamed in pieces of 7 bytes after resetting to the key
+        template <typename K, typename D, typename T> static bool MacCheck(K const &key, D (*mac)(K const &, u8 const *, u64), u8 const *msg, u32 len, u8 const *expected, s32 size)
+        {
+            D const digest = mac(key, msg, len);
+            if (nmem::memcmp(expected, digest.m_data, size) != 0)
+                return false;
+
+            T ctx;
+            ctx.reset(key);
+            for (u32 i = 0; i < len; i += 7)
+                ctx.hash(msg + i, msg + ((i + 7) < len ? (i + 7) : len));
+            D streamed = {};
+            ctx.end(streamed.m_data);
+            return nmem::memcmp(expected, streamed.m_data, size) == 0;
+        }
+
+        UNITTEST_TEST(vectors)
+        {
+            u8 key[135];
+            u8 msg[1000];
+            for (u32 i = 0; i < sizeof(key); ++i)
+                key[i] = (u8)(i * 7 + 1);
+            for (u32 i = 0; i < sizeof(msg); ++i)
+                msg[i] = (u8)(255 - i);
+
+            u8 expected[64];
+            for (SkeinTestVectors::MacVector const *test = SkeinTestVectors::MacTests; test->Digest != nullptr; ++test)
+            {
+                s32 const size = SkeinTestVectors::TextMsgToByteMsg(test->Digest, test->Size == 512 ? 64 : 32, expected);
+                switch (test->Size)
+                {
+                    case 256: CHECK_TRUE((MacCheck<nhash::skein256_key, nhash::skein256, nhash_private::skein256_t>(nhash::skein256_mac_key(key, test->KeyLen), nhash::hash_skein256_mac, msg, test->Len, expected, size))); break;
+                    case 512: CHECK_TRUE((MacCheck<nhash::skein512_key, nhash::skein512, nhash_private::skein512_t>(nhash::skein512_mac_key(key, test->KeyLen), nhash::hash_skein512_mac, msg, test->Len, expected, size))); break;
+                    case 1024: CHECK_TRUE((MacCheck<nhash::skein1024_key, nhash::skein1024, nhash_private::skein1024_t>(nhash::skein1024_mac_key(key, test->KeyLen), nhash::hash_skein1024_mac, msg, test->Len, expected, size))); break;
+                }
+            }
+        }
+
+        UNITTEST_TEST(reuse_key)
+        {
+            u8 const key[] = {1, 2, 3, 4, 5, 6, 7, 8};
+            u8 const msg[] = {'a', 'b', 'c'};
+
+            nhash::skein512_key const mac   = nhash::skein512_mac_key(key, sizeof(key));
+            nhash::skein512 const     first = nhash::hash_skein512_mac(mac, msg, sizeof(msg));
+            nhash::skein512 const     other = nhash::hash_skein512_mac(mac, msg, 2);
+            nhash::skein512 const     again = nhash::hash_skein512_mac(mac, msg, sizeof(msg));
+            CHECK_TRUE(nmem::memcmp(first.m_data, again.m_data, 64) == 0);
+            CHECK_TRUE(nmem::memcmp(first.m_data, other.m_data, 64) != 0);
+        }
+
+        UNITTEST_TEST(empty_key)
+        {
+            u8 const msg[] = {'a', 'b', 'c'};
+
+            nhash::skein256 const mac256 = nhash::hash_skein256_mac(nhash::skein256_mac_key(nullptr, 0), msg, sizeof(msg));
+            nhash::skein256 const seq256 = nhash::hash_skein256(msg, sizeof(msg));
+            CHECK_TRUE(nmem::memcmp(mac256.m_data, seq256.m_data, 32) == 0);
+
+            nhash::skein1024 const mac1024 = nhash::hash_skein1024_mac(nhash::skein1024_mac_key(nullptr, 0), msg, sizeof(msg));
+            nhash::skein1024 const seq1024 = nhash::hash_skein1024(msg, sizeof(msg));
+            CHECK_TRUE(nmem::memcmp(mac1024.m_data, seq1024.m_data, 32) == 0);
+        }
+    }
 }
 UNITTEST_SUITE_END
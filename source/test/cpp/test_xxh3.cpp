@@ -0,0 +1,151 @@
+#include "ccore/c_target.h"
+#include "cbase/c_buffer.h"
+#include "chash/c_hash.h"
+#include "chash/private/c_hash_cpu.h"
+
+#include "cunittest/cunittest.h"
+
+using namespace ncore;
+
+UNITTEST_SUITE_BEGIN(xxh3_t)
+{
+	UNITTEST_FIXTURE(xxh3)
+	{
+		UNITTEST_FIXTURE_SETUP() {}
+		UNITTEST_FIXTURE_TEARDOWN() {}
+
+		static void fill(u8* data, s32 len)
+		{
+			for (s32 i = 0; i < len; ++i)
+				data[i] = (u8)(((u64)i * 2654435761ULL) >> 24);
+		}
+
+		static u64 xxh3_64(u8 const* data, u32 len, u64 seed)
+		{
+			u64 const oneshot = nhash_private::xxh3_64_t::hash64(data, len, seed);
+
+			nhash_private::xxh3_64_t hash;
+			hash.reset(seed);
+			hash.hash(data, data + len);
+			u64 digest;
+			hash.end((u8*)&digest);
+			CHECK_EQUAL(oneshot, digest);
+			return digest;
+		}
+
+		static void check128(u8 const* data, u32 len, u64 seed, u64 low, u64 high)
+		{
+			u64 l, h;
+			nhash_private::xxh3_128_t::hash128(data, len, seed, &l, &h);
+			CHECK_EQUAL(low, l);
+			CHECK_EQUAL(high, h);
+
+			nhash_private::xxh3_128_t hash;
+			hash.reset(seed);
+			hash.hash(data, data + len);
+			u64 digest[2];
+			hash.end((u8*)digest);
+			CHECK_EQUAL(low, digest[0]);
+			CHECK_EQUAL(high, digest[1]);
+		}
+
+		// Values from the reference implementation
+		UNITTEST_TEST(xxh3_64)
+		{
+			u8 data[5000];
+			fill(data, 5000);
+
+			CHECK_EQUAL(D_CONSTANT_U64(0x2d06800538d394c2), xxh3_64(data, 0, 0));
+			CHECK_EQUAL(D_CONSTANT_U64(0xc44bdff4074eecdb), xxh3_64(data, 1, 0));
+			CHECK_EQUAL(D_CONSTANT_U64(0xe14090f554a5ea90), xxh3_64(data, 3, 0));
+			CHECK_EQUAL(D_CONSTANT_U64(0x2e8d078a566e9749), xxh3_64(data, 4, 0));
+			CHECK_EQUAL(D_CONSTANT_U64(0xcd1c7f88482fcaef), xxh3_64(data, 8, 0));
+			CHECK_EQUAL(D_CONSTANT_U64(0xbfe43def699fa9e3), xxh3_64(data, 9, 0));
+			CHECK_EQUAL(D_CONSTANT_U64(0x81e9eb8634460bb9), xxh3_64(data, 16, 0));
+			CHECK_EQUAL(D_CONSTANT_U64(0x9998430fd0a655be), xxh3_64(data, 17, 0));
+			CHECK_EQUAL(D_CONSTANT_U64(0x75eca5c5d5594884), xxh3_64(data, 128, 0));
+			CHECK_EQUAL(D_CONSTANT_U64(0xa05da42e7a4e4667), xxh3_64(data, 129, 0));
+			CHECK_EQUAL(D_CONSTANT_U64(0x5eb2467c8c9e3969), xxh3_64(data, 240, 0));
+			CHECK_EQUAL(D_CONSTANT_U64(0x2d431e984c441f15), xxh3_64(data, 241, 0));
+			CHECK_EQUAL(D_CONSTANT_U64(0x8d3e88d833cd4a80), xxh3_64(data, 1000, 0));
+			CHECK_EQUAL(D_CONSTANT_U64(0x83cba9b371e4e7f4), xxh3_64(data, 1025, 0));
+			CHECK_EQUAL(D_CONSTANT_U64(0xb9daede5f99f736e), xxh3_64(data, 5000, 0));
+			CHECK_EQUAL(D_CONSTANT_U64(0x032be332dd766ef8), xxh3_64(data, 1, D_CONSTANT_U64(0x9E3779B185EBCA8D)));
+			CHECK_EQUAL(D_CONSTANT_U64(0x9520070aa2040b1a), xxh3_64(data, 8, D_CONSTANT_U64(0x9E3779B185EBCA8D)));
+			CHECK_EQUAL(D_CONSTANT_U64(0x2645c71c33424f39), xxh3_64(data, 17, D_CONSTANT_U64(0x9E3779B185EBCA8D)));
+			CHECK_EQUAL(D_CONSTANT_U64(0xfa404b1cfb446afc), xxh3_64(data, 129, D_CONSTANT_U64(0x9E3779B185EBCA8D)));
+			CHECK_EQUAL(D_CONSTANT_U64(0x81aadbeff92a6c78), xxh3_64(data, 241, D_CONSTANT_U64(0x9E3779B185EBCA8D)));
+			CHECK_EQUAL(D_CONSTANT_U64(0xc0236e379e79ae6f), xxh3_64(data, 5000, D_CONSTANT_U64(0x9E3779B185EBCA8D)));
+		}
+
+		UNITTEST_TEST(xxh3_128)
+		{
+			u8 data[5000];
+			fill(data, 5000);
+
+			check128(data, 0, 0, D_CONSTANT_U64(0x6001c324468d497f), D_CONSTANT_U64(0x99aa06d3014798d8));
+			check128(data, 1, 0, D_CONSTANT_U64(0xc44bdff4074eecdb), D_CONSTANT_U64(0xa6cd5e9392000f6a));
+			check128(data, 3, 0, D_CONSTANT_U64(0xe14090f554a5ea90), D_CONSTANT_U64(0x977fcbc0448b49f6));
+			check128(data, 4, 0, D_CONSTANT_U64(0x4ee6926f0426173e), D_CONSTANT_U64(0x4e82b36688c5328f));
+			check128(data, 8, 0, D_CONSTANT_U64(0x79d85adaeefd615e), D_CONSTANT_U64(0x7b4966a681f18d57));
+			check128(data, 9, 0, D_CONSTANT_U64(0xee5940d4df4715ae), D_CONSTANT_U64(0x200d098a7113e15f));
+			check128(data, 16, 0, D_CONSTANT_U64(0x37286a19cf622308), D_CONSTANT_U64(0x78e8ab538d3acaab));
+			check128(data, 17, 0, D_CONSTANT_U64(0x33bed349ec1c0ce7), D_CONSTANT_U64(0x1ea709ada2b9c32e));
+			check128(data, 128, 0, D_CONSTANT_U64(0xe1f0636051ccd2be), D_CONSTANT_U64(0x5ac741c59c95d36a));
+			check128(data, 129, 0, D_CONSTANT_U64(0xcfb3fed667226458), D_CONSTANT_U64(0x1240f4d960139642));
+			check128(data, 240, 0, D_CONSTANT_U64(0xb2e6947c477a4ab0), D_CONSTANT_U64(0x640a6149838a7599));
+			check128(data, 241, 0, D_CONSTANT_U64(0x2d431e984c441f15), D_CONSTANT_U64(0xe817e20e53e42a8c));
+			check128(data, 1000, 0, D_CONSTANT_U64(0x8d3e88d833cd4a80), D_CONSTANT_U64(0xfac4e9a77d6c8b10));
+			check128(data, 1025, 0, D_CONSTANT_U64(0x83cba9b371e4e7f4), D_CONSTANT_U64(0x63e845aab7eb695f));
+			check128(data, 5000, 0, D_CONSTANT_U64(0xb9daede5f99f736e), D_CONSTANT_U64(0xdf8bd4ddb16d1d1c));
+			check128(data, 1, D_CONSTANT_U64(0x9E3779B185EBCA8D), D_CONSTANT_U64(0x032be332dd766ef8), D_CONSTANT_U64(0x20e49abcc53b3842));
+			check128(data, 8, D_CONSTANT_U64(0x9E3779B185EBCA8D), D_CONSTANT_U64(0x463909432b28706a), D_CONSTANT_U64(0x63fff60a6c755d92));
+			check128(data, 17, D_CONSTANT_U64(0x9E3779B185EBCA8D), D_CONSTANT_U64(0xc96ae6415a980126), D_CONSTANT_U64(0x27c1cac6a19b66bd));
+			check128(data, 129, D_CONSTANT_U64(0x9E3779B185EBCA8D), D_CONSTANT_U64(0x69f15a40d8bd17f0), D_CONSTANT_U64(0x218306135924ff4c));
+			check128(data, 241, D_CONSTANT_U64(0x9E3779B185EBCA8D), D_CONSTANT_U64(0x81aadbeff92a6c78), D_CONSTANT_U64(0x0522d4b6ae996eb4));
+			check128(data, 5000, D_CONSTANT_U64(0x9E3779B185EBCA8D), D_CONSTANT_U64(0xc0236e379e79ae6f), D_CONSTANT_U64(0x8e7c90e297e9a726));
+		}
+
+		UNITTEST_TEST(streaming)
+		{
+			u8 data[5000];
+			fill(data, 5000);
+
+			// Pieces of every size from 1 to 300 bytes, crossing the internal buffer and block boundaries
+			nhash_private::xxh3_64_t hash64;
+			nhash_private::xxh3_128_t hash128;
+			hash64.reset();
+			hash128.reset(D_CONSTANT_U64(0x9E3779B185EBCA8D));
+			s32 step = 1;
+			for (s32 i = 0; i < 5000; i += step, step = (step % 300) + 1)
+			{
+				s32 const end = (i + step) < 5000 ? (i + step) : 5000;
+				hash64.hash(data + i, data + end);
+				hash128.hash(data + i, data + end);
+			}
+			u64 digest64;
+			hash64.end((u8*)&digest64);
+			CHECK_EQUAL(D_CONSTANT_U64(0xb9daede5f99f736e), digest64);
+			u64 digest128[2];
+			hash128.end((u8*)digest128);
+			CHECK_EQUAL(D_CONSTANT_U64(0xc0236e379e79ae6f), digest128[0]);
+			CHECK_EQUAL(D_CONSTANT_U64(0x8e7c90e297e9a726), digest128[1]);
+		}
+
+		UNITTEST_TEST(kernels)
+		{
+			u8 data[5000];
+			fill(data, 5000);
+
+			// The AVX2, SSE2 and scalar stripe accumulators must all agree
+			nhash_cpu::disable(nhash_cpu::AVX2);
+			CHECK_EQUAL(D_CONSTANT_U64(0xb9daede5f99f736e), xxh3_64(data, 5000, 0));
+			check128(data, 5000, D_CONSTANT_U64(0x9E3779B185EBCA8D), D_CONSTANT_U64(0xc0236e379e79ae6f), D_CONSTANT_U64(0x8e7c90e297e9a726));
+			nhash_cpu::disable(nhash_cpu::AVX2 | nhash_cpu::SSE2);
+			CHECK_EQUAL(D_CONSTANT_U64(0xb9daede5f99f736e), xxh3_64(data, 5000, 0));
+			check128(data, 5000, D_CONSTANT_U64(0x9E3779B185EBCA8D), D_CONSTANT_U64(0xc0236e379e79ae6f), D_CONSTANT_U64(0x8e7c90e297e9a726));
+			nhash_cpu::disable(0);
+		}
+	}
+}
+UNITTEST_SUITE_END
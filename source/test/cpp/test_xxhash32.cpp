@@ -0,0 +1,69 @@
+#include "ccore/c_target.h"
+#include "cbase/c_buffer.h"
+#include "chash/c_hash.h"
+
+#include "cunittest/cunittest.h"
+
+using namespace ncore;
+
+UNITTEST_SUITE_BEGIN(xxhash32_t)
+{
+	UNITTEST_FIXTURE(xxhash)
+	{
+		UNITTEST_FIXTURE_SETUP() {}
+		UNITTEST_FIXTURE_TEARDOWN() {}
+
+		static u32 xxhash32(u8 const* data, u32 len, u32 seed)
+		{
+			nhash_private::xxhash32_t hash;
+			hash.reset(seed);
+			hash.hash(data, data + len);
+			nhash::xxhash32 digest;
+			hash.end(digest.m_data);
+			u32 const streamed = (u32)digest.m_data[0] | ((u32)digest.m_data[1] << 8) | ((u32)digest.m_data[2] << 16) | ((u32)digest.m_data[3] << 24);
+			CHECK_EQUAL(nhash_private::xxhash32_t::hash32(data, len, seed), streamed);
+			return streamed;
+		}
+
+		UNITTEST_TEST(reference)
+		{
+			u8 data[1000];
+			for (s32 i = 0; i < 1000; ++i)
+				data[i] = (u8)(((u64)i * 2654435761ULL) >> 24);
+
+			// Values from the reference implementation
+			CHECK_EQUAL((u32)0x02cc5d05, xxhash32(data, 0, 0));
+			CHECK_EQUAL((u32)0xcf65b03e, xxhash32(data, 1, 0));
+			CHECK_EQUAL((u32)0x4a695a27, xxhash32(data, 4, 0));
+			CHECK_EQUAL((u32)0x6888f42e, xxhash32(data, 14, 0));
+			CHECK_EQUAL((u32)0x4995d5c5, xxhash32(data, 16, 0));
+			CHECK_EQUAL((u32)0xc6e5e8d3, xxhash32(data, 32, 0));
+			CHECK_EQUAL((u32)0x343cef9a, xxhash32(data, 100, 0));
+			CHECK_EQUAL((u32)0x609cd97a, xxhash32(data, 1000, 0));
+			CHECK_EQUAL((u32)0xb4545aa4, xxhash32(data, 1, 0x9E3779B1));
+			CHECK_EQUAL((u32)0xe5b617f7, xxhash32(data, 14, 0x9E3779B1));
+			CHECK_EQUAL((u32)0xc900effc, xxhash32(data, 1000, 0x9E3779B1));
+
+			// Streaming in pieces, unaligned
+			nhash_private::xxhash32_t hash;
+			hash.reset();
+			for (s32 i = 0; i < 1000; i += 7)
+				hash.hash(data + i, data + ((i + 7) < 1000 ? (i + 7) : 1000));
+			nhash::xxhash32 digest;
+			hash.end(digest.m_data);
+			CHECK_EQUAL((u32)0x609cd97a, (u32)digest.m_data[0] | ((u32)digest.m_data[1] << 8) | ((u32)digest.m_data[2] << 16) | ((u32)digest.m_data[3] << 24));
+		}
+
+		UNITTEST_TEST(unaligned)
+		{
+			u8 data[1000 + 8];
+			for (s32 offset = 1; offset < 8; ++offset)
+			{
+				for (s32 i = 0; i < 1000; ++i)
+					data[offset + i] = (u8)(((u64)i * 2654435761ULL) >> 24);
+				CHECK_EQUAL((u32)0x609cd97a, xxhash32(data + offset, 1000, 0));
+			}
+		}
+	}
+}
+UNITTEST_SUITE_END
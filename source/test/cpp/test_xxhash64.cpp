@@ -14,14 +14,76 @@ UNITTEST_SUITE_BEGIN(xxhash64_t)
 		UNITTEST_FIXTURE_TEARDOWN() {}
 
 
+		static u64 xxhash64(u8 const* data, u32 len, u64 seed)
+		{
+			nhash_private::xxhash64_t hash;
+			hash.reset(seed);
+			hash.hash(data, data + len);
+			u64 digest;
+			hash.end((u8*)&digest);
+			return digest;
+		}
+
 		UNITTEST_TEST(hash1)
 		{
 			u32 len=10;
 			u8 indata[]={1,2,3,4,5,6,7,8,9,13};
 			nhash_private::xxhash64_t hash;
-            hash.hash(indata, indata+len);
-            u64 digest;
-            hash.end((u8*)&digest);
+			hash.reset();
+			hash.hash(indata, indata+len);
+			u64 digest;
+			hash.end((u8*)&digest);
+			CHECK_EQUAL(D_CONSTANT_U64(0x5ecdf20dc7bc9d8f), digest);
+		}
+
+		UNITTEST_TEST(reference)
+		{
+			u8 data[1000];
+			for (s32 i = 0; i < 1000; ++i)
+				data[i] = (u8)(((u64)i * 2654435761ULL) >> 24);
+
+			// Values from the reference implementation
+			CHECK_EQUAL(D_CONSTANT_U64(0xef46db3751d8e999), xxhash64(data, 0, 0));
+			CHECK_EQUAL(D_CONSTANT_U64(0xe934a84adb052768), xxhash64(data, 1, 0));
+			CHECK_EQUAL(D_CONSTANT_U64(0x435f59a33b7eb3d1), xxhash64(data, 4, 0));
+			CHECK_EQUAL(D_CONSTANT_U64(0x65ef9f2cde8f47f3), xxhash64(data, 14, 0));
+			CHECK_EQUAL(D_CONSTANT_U64(0x13ee8a64346f0691), xxhash64(data, 32, 0));
+			CHECK_EQUAL(D_CONSTANT_U64(0x8a5b7a72e578e053), xxhash64(data, 100, 0));
+			CHECK_EQUAL(D_CONSTANT_U64(0x8420addb9882cc1b), xxhash64(data, 1000, 0));
+			CHECK_EQUAL(D_CONSTANT_U64(0x9c6678669fcd2e6d), xxhash64(data, 1, D_CONSTANT_U64(0x9E3779B185EBCA8D)));
+			CHECK_EQUAL(D_CONSTANT_U64(0x16c97f7c1122511f), xxhash64(data, 14, D_CONSTANT_U64(0x9E3779B185EBCA8D)));
+			CHECK_EQUAL(D_CONSTANT_U64(0xc543e0fcb2f50299), xxhash64(data, 1000, D_CONSTANT_U64(0x9E3779B185EBCA8D)));
+
+			// Streaming in pieces, unaligned
+			nhash_private::xxhash64_t hash;
+			hash.reset();
+			for (s32 i = 0; i < 1000; i += 7)
+				hash.hash(data + i, data + ((i + 7) < 1000 ? (i + 7) : 1000));
+			u64 digest;
+			hash.end((u8*)&digest);
+			CHECK_EQUAL(D_CONSTANT_U64(0x8420addb9882cc1b), digest);
+		}
+
+		UNITTEST_TEST(unaligned)
+		{
+			u8 data[1000 + 8];
+			for (s32 offset = 1; offset < 8; ++offset)
+			{
+				for (s32 i = 0; i < 1000; ++i)
+					data[offset + i] = (u8)(((u64)i * 2654435761ULL) >> 24);
+				CHECK_EQUAL(D_CONSTANT_U64(0x8420addb9882cc1b), xxhash64(data + offset, 1000, 0));
+			}
+		}
+
+		UNITTEST_TEST(legacy)
+		{
+			u32 len=10;
+			u8 indata[]={1,2,3,4,5,6,7,8,9,13};
+			nhash_private::xxhash64_legacy_t hash;
+			hash.reset();
+			hash.hash(indata, indata+len);
+			u64 digest;
+			hash.end((u8*)&digest);
 			CHECK_EQUAL(D_CONSTANT_U64(0x0942d2129c275a72), digest);
 		}
 